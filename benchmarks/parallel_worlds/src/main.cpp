@@ -0,0 +1,164 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <string>
+
+#include "re/ecs/ecs_orchestrator.h"
+#include "re/ecs/component/components/collider_component.h"
+
+// Two levels sharing an external scene, so worlds changing scene clear the template cache while the other instances it
+const size_t LEVEL_NODE_COUNTS[] = { 3000, 5000 };
+const size_t CHILDREN_PER_NODE = 6;
+const size_t EXTERNAL_SCENE_INTERVAL = 40; // Every 40th node instances the external scene
+const size_t EXTERNAL_SCENE_NODE_COUNT = 12;
+const int SCENE_CHANGES = 24;
+const int WORLD_COUNT = 2;
+const std::string EXTERNAL_SCENE_FILE_PATH = "parallel_worlds_enemy.json";
+
+// What a world saw after each scene change
+struct SceneSnapshot {
+    unsigned int nodeCount = 0;
+    double checksum = 0.0;
+
+    bool operator==(const SceneSnapshot& other) const {
+        return nodeCount == other.nodeCount && checksum == other.checksum;
+    }
+};
+
+std::string GetLevelFilePath(size_t levelIndex) {
+    return "parallel_worlds_level_" + std::to_string(levelIndex) + ".json";
+}
+
+nlohmann::json CreateNodeJson(size_t nodeIndex, size_t depth, const std::string& externalSceneSource) {
+    nlohmann::json componentsJson = nlohmann::json::array();
+    componentsJson.push_back({ { "transform2D", {
+                { "position", { { "x", static_cast<float>(nodeIndex % 100) }, { "y", static_cast<float>(depth * 2) } } },
+                { "scale", { { "x", 1.0f }, { "y", 1.0f } } },
+                { "rotation", 0.0f },
+                { "z_index", static_cast<int>(nodeIndex % 5) },
+                { "z_index_relative_to_parent", true },
+                { "ignore_camera", false }
+            }
+        }
+    });
+    if (nodeIndex % 2 == 1) {
+        componentsJson.push_back({ { "collider", {
+                    { "rectangle", { { "x", 0.0f }, { "y", 0.0f }, { "width", 8.0f }, { "height", 8.0f } } },
+                    { "color", { { "red", 255 }, { "green", 0 }, { "blue", 0 }, { "alpha", 255 } } }
+                }
+            }
+        });
+    }
+    return {
+        { "name", depth == 0 ? "Main" : "Node" },
+        { "type", "Node2D" },
+        { "tags", nlohmann::json::array() },
+        { "external_scene_source", externalSceneSource },
+        { "components", componentsJson },
+        { "children", nlohmann::json::array() }
+    };
+}
+
+// Nodes are added breadth first with a fixed branching factor
+void GenerateSceneFile(const std::string& filePath, size_t nodeCount, size_t externalSceneInterval) {
+    nlohmann::json sceneJson = CreateNodeJson(0, 0, "");
+    // Children are only appended to nodes that are already complete, so pointers into parent arrays stay valid
+    std::vector<std::pair<nlohmann::json*, size_t>> openNodes = { { &sceneJson, 0 } };
+    size_t createdNodeCount = 1;
+    for (size_t openIndex = 0; createdNodeCount < nodeCount; openIndex++) {
+        nlohmann::json& childrenJson = openNodes[openIndex].first->at("children");
+        const size_t childDepth = openNodes[openIndex].second + 1;
+        for (size_t child = 0; child < CHILDREN_PER_NODE && createdNodeCount < nodeCount; child++) {
+            const bool isInstance = externalSceneInterval > 0 && createdNodeCount % externalSceneInterval == 0;
+            childrenJson.push_back(CreateNodeJson(createdNodeCount++, childDepth, isInstance ? EXTERNAL_SCENE_FILE_PATH : ""));
+        }
+        for (nlohmann::json& childJson : childrenJson) {
+            openNodes.emplace_back(&childJson, childDepth);
+        }
+    }
+    std::ofstream(filePath) << sceneJson.dump(1);
+}
+
+void RegisterComponents(ECSOrchestrator& ecsOrchestrator) {
+    ecsOrchestrator.RegisterComponent<SceneComponent>();
+    ecsOrchestrator.RegisterComponent<Transform2DComponent>();
+    ecsOrchestrator.RegisterComponent<SpriteComponent>();
+    ecsOrchestrator.RegisterComponent<TextLabelComponent>();
+    ecsOrchestrator.RegisterComponent<AnimatedSpriteComponent>();
+    ecsOrchestrator.RegisterComponent<ColliderComponent>();
+}
+
+SceneSnapshot TakeSnapshot(World* world) {
+    const Scene* scene = world->GetSceneManager()->GetCurrentScene();
+    ComponentManager* componentManager = world->GetComponentManager();
+    CollisionContext* collisionContext = world->GetCollisionContext();
+    SceneSnapshot snapshot;
+    snapshot.nodeCount = scene->hierarchy.GetNodeCount();
+    scene->hierarchy.TraverseDepthFirst(NULL_ENTITY, [&snapshot, scene, componentManager, collisionContext] (Entity entity) {
+        const Transform2DComponent& transform2DComponent = componentManager->GetComponent<Transform2DComponent>(entity);
+        snapshot.checksum += transform2DComponent.position.x + transform2DComponent.position.y * scene->hierarchy.GetDepth(entity);
+        if (componentManager->HasComponent<ColliderComponent>(entity)) {
+            snapshot.checksum += collisionContext->GetCollisionRectangle(entity).w;
+        }
+    });
+    return snapshot;
+}
+
+// Changes between the levels 'SCENE_CHANGES' times, recording what each scene looked like once loaded
+std::vector<SceneSnapshot> RunWorld() {
+    World world;
+    ECSOrchestrator ecsOrchestrator(&world);
+    RegisterComponents(ecsOrchestrator);
+    std::vector<SceneSnapshot> snapshots;
+    for (int sceneChange = 0; sceneChange < SCENE_CHANGES; sceneChange++) {
+        ecsOrchestrator.PrepareSceneChange(GetLevelFilePath(sceneChange % 2));
+        ecsOrchestrator.DestroyScene();
+        ecsOrchestrator.ChangeToScene();
+        snapshots.emplace_back(TakeSnapshot(&world));
+    }
+    return snapshots;
+}
+
+int main() {
+    Logger::GetInstance()->SetLogLevel(LogLevel::ERROR);
+    GenerateSceneFile(EXTERNAL_SCENE_FILE_PATH, EXTERNAL_SCENE_NODE_COUNT, 0);
+    for (size_t levelIndex = 0; levelIndex < 2; levelIndex++) {
+        GenerateSceneFile(GetLevelFilePath(levelIndex), LEVEL_NODE_COUNTS[levelIndex], EXTERNAL_SCENE_INTERVAL);
+    }
+
+    const auto serialStart = std::chrono::steady_clock::now();
+    const std::vector<SceneSnapshot> expectedSnapshots = RunWorld();
+    const double serialMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - serialStart).count();
+
+    std::vector<std::vector<SceneSnapshot>> worldSnapshots(WORLD_COUNT);
+    std::vector<std::thread> worldThreads;
+    const auto parallelStart = std::chrono::steady_clock::now();
+    for (int worldIndex = 0; worldIndex < WORLD_COUNT; worldIndex++) {
+        worldThreads.emplace_back([&worldSnapshots, worldIndex] () {
+            worldSnapshots[worldIndex] = RunWorld();
+        });
+    }
+    for (std::thread& worldThread : worldThreads) {
+        worldThread.join();
+    }
+    const double parallelMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parallelStart).count();
+
+    bool isValid = expectedSnapshots.size() == SCENE_CHANGES;
+    for (const std::vector<SceneSnapshot>& snapshots : worldSnapshots) {
+        isValid = isValid && snapshots == expectedSnapshots;
+    }
+    std::cout << "Scene changes per world: " << SCENE_CHANGES << ", nodes per level: " << expectedSnapshots[0].nodeCount << " and "
+              << expectedSnapshots[1].nodeCount << std::endl;
+    std::cout << "One world:  " << serialMilliseconds << " ms" << std::endl;
+    std::cout << WORLD_COUNT << " worlds on their own threads: " << parallelMilliseconds << " ms" << std::endl;
+    std::cout << (isValid ? "Every world matches the single world" : "Worlds don't match the single world!") << std::endl;
+
+    std::remove(EXTERNAL_SCENE_FILE_PATH.c_str());
+    for (size_t levelIndex = 0; levelIndex < 2; levelIndex++) {
+        std::remove(GetLevelFilePath(levelIndex).c_str());
+    }
+    return isValid ? 0 : 1;
+}
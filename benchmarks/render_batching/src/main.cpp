@@ -0,0 +1,272 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <map>
+#include <new>
+#include <vector>
+#include <string>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "re/rendering/renderer_batcher.h"
+#include "re/rendering/font_renderer.h"
+
+// A scene submitted in entity order: sprites spread over a few z indices and textures, UI labels on top
+const int SPRITE_COUNT = 20000;
+const int LABEL_COUNT = 300;
+const int TEXTURE_COUNT = 4;
+const int Z_INDEX_COUNT = 8;
+const int FONT_SIZE = 20;
+const int FRAMES = 200;
+const int WARMUP_FRAMES = 5;
+
+// Every allocation goes through here so steady state frames can be checked for allocations
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    void* memory = std::malloc(size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+struct SyntheticDrawItem {
+    bool isSprite;
+    int zIndex;
+    int texture; // Texture for sprites, font for labels
+    SpriteBatchItem spriteBatchItem;
+    FontBatchItem fontBatchItem;
+};
+
+struct BatchingResult {
+    double microsecondsPerFrame = 0.0;
+    size_t allocationsPerFrame = 0;
+    size_t textureSwitches = 0; // Changes of texture between consecutive sprites, each one ends a sprite batch
+    std::vector<int> drawOrder; // Submission index of every flushed item
+};
+
+struct LegacyZIndexDrawBatch {
+    std::vector<SpriteBatchItem> spriteDrawBatches;
+    std::vector<FontBatchItem> fontDrawBatches;
+};
+
+// The previous batcher: a map of z indices to per layer arrays, released on every flush
+class LegacyRendererBatcher {
+  public:
+    void BatchDrawSprite(SpriteBatchItem spriteBatchItem, int zIndex) {
+        if (drawBatches.find(zIndex) == drawBatches.end()) {
+            drawBatches.emplace(zIndex, LegacyZIndexDrawBatch{});
+        }
+        drawBatches[zIndex].spriteDrawBatches.emplace_back(spriteBatchItem);
+    }
+
+    void BatchDrawFont(FontBatchItem fontBatchItem, int zIndex) {
+        if (drawBatches.find(zIndex) == drawBatches.end()) {
+            drawBatches.emplace(zIndex, LegacyZIndexDrawBatch{});
+        }
+        drawBatches[zIndex].fontDrawBatches.emplace_back(fontBatchItem);
+    }
+
+    void Flush(const SpriteFlushFunction &spriteFlushFunction, const FontFlushFunction &fontFlushFunction) {
+        for (const auto &pair : drawBatches) {
+            for (const SpriteBatchItem &spriteBatchItem : pair.second.spriteDrawBatches) {
+                spriteFlushFunction(spriteBatchItem);
+            }
+            for (const FontBatchItem &fontBatchItem : pair.second.fontDrawBatches) {
+                fontFlushFunction(fontBatchItem);
+            }
+        }
+        drawBatches.clear();
+    }
+
+  private:
+    std::map<int, LegacyZIndexDrawBatch> drawBatches;
+};
+
+// Surfaceless context, textures and glyph pages need one even though nothing is drawn
+bool CreateHeadlessContext() {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    EGLDisplay display = getPlatformDisplay != nullptr ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_API)) {
+        return false;
+    }
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        return false;
+    }
+    return gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress)) != 0;
+}
+
+// Sprites cycle through their z indices and textures independently, labels land on the top z indices.  The submission
+// index travels in the items' x coordinates so the flush order can be checked.
+std::vector<SyntheticDrawItem> BuildSyntheticScene(const std::vector<Texture*>& textures, const std::vector<Font*>& fonts) {
+    std::vector<SyntheticDrawItem> items;
+    items.reserve(SPRITE_COUNT + LABEL_COUNT);
+    const int labelInterval = SPRITE_COUNT / LABEL_COUNT;
+    int labelCount = 0;
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        SyntheticDrawItem sprite{ true, (i * 5) % Z_INDEX_COUNT - 2, (i / 3) % TEXTURE_COUNT, SpriteBatchItem(), FontBatchItem() };
+        sprite.spriteBatchItem.texture2D = textures[sprite.texture];
+        sprite.spriteBatchItem.sourceRectangle = Rect2(0.0f, 0.0f, 16.0f, 16.0f);
+        sprite.spriteBatchItem.destinationRectangle = Rect2(static_cast<float>(items.size()), 0.0f, 16.0f, 16.0f);
+        items.emplace_back(sprite);
+        if (i % labelInterval == 0 && labelCount < LABEL_COUNT) {
+            SyntheticDrawItem label{ false, Z_INDEX_COUNT - 2 + labelCount % 2, (labelCount / 2) % 2, SpriteBatchItem(), FontBatchItem() };
+            label.fontBatchItem.font = fonts[label.texture];
+            label.fontBatchItem.text = "Score: " + std::to_string(labelCount * 100) + " Level: 7 Lives: 3";
+            label.fontBatchItem.x = static_cast<float>(items.size());
+            items.emplace_back(label);
+            labelCount++;
+        }
+    }
+    return items;
+}
+
+template<typename Batcher>
+void SubmitScene(Batcher& batcher, const std::vector<SyntheticDrawItem>& items) {
+    for (const SyntheticDrawItem& item : items) {
+        if (item.isSprite) {
+            batcher.BatchDrawSprite(item.spriteBatchItem, item.zIndex);
+        } else {
+            batcher.BatchDrawFont(item.fontBatchItem, item.zIndex);
+        }
+    }
+}
+
+template<typename Batcher>
+BatchingResult MeasureBatching(Batcher& batcher, const std::vector<SyntheticDrawItem>& items) {
+    BatchingResult result;
+    result.drawOrder.reserve(items.size());
+    const Texture* lastTexture = nullptr;
+    const SpriteFlushFunction &spriteFlushFunction = [&result, &lastTexture] (const SpriteBatchItem &spriteBatchItem) {
+        if (spriteBatchItem.texture2D != lastTexture) {
+            result.textureSwitches++;
+            lastTexture = spriteBatchItem.texture2D;
+        }
+        result.drawOrder.emplace_back(static_cast<int>(spriteBatchItem.destinationRectangle.x));
+    };
+    const FontFlushFunction &fontFlushFunction = [&result] (const FontBatchItem &fontBatchItem) {
+        result.drawOrder.emplace_back(static_cast<int>(fontBatchItem.x));
+    };
+    for (int frame = 0; frame < WARMUP_FRAMES; frame++) {
+        SubmitScene(batcher, items);
+        batcher.Flush(spriteFlushFunction, fontFlushFunction);
+    }
+
+    result.textureSwitches = 0;
+    result.drawOrder.clear();
+    lastTexture = nullptr;
+    const size_t startAllocationCount = allocationCount;
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        // Only the last frame's order is kept
+        result.drawOrder.clear();
+        SubmitScene(batcher, items);
+        batcher.Flush(spriteFlushFunction, fontFlushFunction);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    result.microsecondsPerFrame = std::chrono::duration<double, std::micro>(end - start).count() / FRAMES;
+    result.allocationsPerFrame = (allocationCount - startAllocationCount) / FRAMES;
+    result.textureSwitches /= FRAMES;
+    return result;
+}
+
+// Reference order: stable sort by z index, sprites before labels, then texture or font
+std::vector<int> BuildExpectedDrawOrder(const std::vector<SyntheticDrawItem>& items) {
+    std::vector<int> order;
+    for (size_t i = 0; i < items.size(); i++) {
+        order.emplace_back(static_cast<int>(i));
+    }
+    std::stable_sort(order.begin(), order.end(), [&items] (int a, int b) {
+        const SyntheticDrawItem& itemA = items[a];
+        const SyntheticDrawItem& itemB = items[b];
+        if (itemA.zIndex != itemB.zIndex) {
+            return itemA.zIndex < itemB.zIndex;
+        }
+        if (itemA.isSprite != itemB.isSprite) {
+            return itemA.isSprite;
+        }
+        return itemA.texture < itemB.texture;
+    });
+    return order;
+}
+
+// Labels only need to keep their z index order, fonts of one z index may be drawn in either order
+bool IsOrderedLikeLegacy(const std::vector<SyntheticDrawItem>& items, const std::vector<int>& drawOrder, const std::vector<int>& legacyDrawOrder) {
+    if (drawOrder.size() != legacyDrawOrder.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < drawOrder.size(); i++) {
+        const SyntheticDrawItem& item = items[drawOrder[i]];
+        const SyntheticDrawItem& legacyItem = items[legacyDrawOrder[i]];
+        if (item.zIndex != legacyItem.zIndex || item.isSprite != legacyItem.isSprite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argv, char** args) {
+    if (argv < 2) {
+        std::cout << "Usage: render_batching_benchmark <font.ttf>" << std::endl;
+        return 1;
+    }
+    if (!CreateHeadlessContext()) {
+        std::cout << "Failed to create a headless OpenGL 3.3 context!" << std::endl;
+        return 1;
+    }
+    FT_Library freeTypeLibrary;
+    if (FT_Init_FreeType(&freeTypeLibrary)) {
+        std::cout << "Failed to initialize FreeType!" << std::endl;
+        return 1;
+    }
+    std::vector<Texture*> textures;
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        textures.emplace_back(new Texture(16, 16));
+    }
+    // Fonts hold their FreeType face, they're gone by the time the library is released
+    Font* bitmapFont = new Font(freeTypeLibrary, args[1], FONT_SIZE);
+    Font* distanceFieldFont = new Font(freeTypeLibrary, args[1], FONT_SIZE, GlyphCacheSettings(), FontRenderMode::DistanceField);
+    const std::vector<Font*> fonts = { bitmapFont, distanceFieldFont };
+    const std::vector<SyntheticDrawItem> items = BuildSyntheticScene(textures, fonts);
+
+    LegacyRendererBatcher legacyRendererBatcher;
+    const BatchingResult legacyResult = MeasureBatching(legacyRendererBatcher, items);
+    RendererBatcher rendererBatcher;
+    const BatchingResult result = MeasureBatching(rendererBatcher, items);
+
+    std::cout << "Items: " << items.size() << ", z indices: " << Z_INDEX_COUNT << ", textures: " << TEXTURE_COUNT << std::endl;
+    std::cout << "Z index map: " << legacyResult.microsecondsPerFrame << " us/frame submit and flush, " << legacyResult.allocationsPerFrame
+              << " allocations per frame, " << legacyResult.textureSwitches << " texture switches" << std::endl;
+    std::cout << "Sort keys:   " << result.microsecondsPerFrame << " us/frame submit and flush, " << result.allocationsPerFrame
+              << " allocations per frame, " << result.textureSwitches << " texture switches" << std::endl;
+
+    const bool isValid = result.drawOrder == BuildExpectedDrawOrder(items) && IsOrderedLikeLegacy(items, result.drawOrder, legacyResult.drawOrder);
+    std::cout << (isValid ? "Draw order matches the z index map" : "Draw order doesn't match the z index map!") << std::endl;
+
+    delete distanceFieldFont;
+    delete bitmapFont;
+    FT_Done_FreeType(freeTypeLibrary);
+    for (Texture* texture : textures) {
+        delete texture;
+    }
+    return isValid ? 0 : 1;
+}
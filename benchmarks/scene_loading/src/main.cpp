@@ -0,0 +1,193 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <string>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "re/scene/scene_loader.h"
+#include "re/scene/binary_scene_compiler.h"
+
+// Generated scenes: nodes are added breadth first with a fixed branching factor, like a level of nested groups
+const size_t SCENE_NODE_COUNTS[] = { 6000, 19000 };
+const size_t CHILDREN_PER_NODE = 8;
+
+enum class LoadPath : int {
+    NONE = 0, // Only sets up the managers, its peak memory is subtracted from the others
+    DOM = 1,
+    STREAM = 2,
+    PARALLEL = 3,
+    COMPILED = 4,
+};
+
+struct LoadResult {
+    double milliseconds = 0.0;
+    long peakKilobytes = 0;
+    size_t nodeCount = 0;
+};
+
+nlohmann::json CreateNodeJson(size_t nodeIndex, size_t depth) {
+    nlohmann::json componentsJson = nlohmann::json::array();
+    componentsJson.push_back({ { "transform2D", {
+                { "position", { { "x", static_cast<float>(nodeIndex % 100) }, { "y", static_cast<float>(depth * 2) } } },
+                { "scale", { { "x", 1.0f }, { "y", 1.0f } } },
+                { "rotation", 0.0f },
+                { "z_index", static_cast<int>(nodeIndex % 5) },
+                { "z_index_relative_to_parent", true },
+                { "ignore_camera", false }
+            }
+        }
+    });
+    if (nodeIndex % 2 == 1) {
+        componentsJson.push_back({ { "collider", {
+                    { "rectangle", { { "x", 0.0f }, { "y", 0.0f }, { "width", 8.0f }, { "height", 8.0f } } },
+                    { "color", { { "red", 255 }, { "green", 0 }, { "blue", 0 }, { "alpha", 255 } } }
+                }
+            }
+        });
+    }
+    return {
+        { "name", depth == 0 ? "Main" : "Enemy" },
+        { "type", "Node2D" },
+        { "tags", nodeIndex % 3 == 0 ? nlohmann::json::array({ "enemy" }) : nlohmann::json::array() },
+        { "external_scene_source", "" },
+        { "components", componentsJson },
+        { "children", nlohmann::json::array() }
+    };
+}
+
+void GenerateSceneFile(const std::string& filePath, size_t nodeCount) {
+    nlohmann::json sceneJson = CreateNodeJson(0, 0);
+    // Children are only appended to nodes that are already complete, so pointers into parent arrays stay valid
+    std::vector<std::pair<nlohmann::json*, size_t>> openNodes = { { &sceneJson, 0 } };
+    size_t createdNodeCount = 1;
+    for (size_t openIndex = 0; createdNodeCount < nodeCount; openIndex++) {
+        nlohmann::json& childrenJson = openNodes[openIndex].first->at("children");
+        const size_t childDepth = openNodes[openIndex].second + 1;
+        for (size_t child = 0; child < CHILDREN_PER_NODE && createdNodeCount < nodeCount; child++) {
+            childrenJson.push_back(CreateNodeJson(createdNodeCount++, childDepth));
+        }
+        for (nlohmann::json& childJson : childrenJson) {
+            openNodes.emplace_back(&childJson, childDepth);
+        }
+    }
+    std::ofstream(filePath) << sceneJson.dump(1);
+}
+
+// Runs in a child process too, memory freed after building the document would otherwise be reused by the measured loads
+// without raising their peak
+void GenerateSceneFiles(const std::string& filePath, const std::string& compiledFilePath, size_t nodeCount) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+        GenerateSceneFile(filePath, nodeCount);
+        _exit(BinarySceneCompiler::CompileSceneFile(filePath, compiledFilePath) ? 0 : 1);
+    }
+    if (pid > 0) {
+        waitpid(pid, nullptr, 0);
+    }
+}
+
+size_t LoadScene(LoadPath loadPath, const std::string& filePath, EntityManager* entityManager, ComponentManager* componentManager) {
+    Scene* scene = new Scene();
+    switch (loadPath) {
+    case LoadPath::DOM: {
+        const nlohmann::json sceneJson = JsonFileHelper::LoadJsonFile(filePath);
+        SceneNodeJsonParser sceneNodeJsonParser(entityManager, componentManager);
+        sceneNodeJsonParser.ParseSceneJson(scene, sceneJson);
+        break;
+    }
+    case LoadPath::STREAM: {
+        MappedFile sceneFile(filePath);
+        SceneNodeJsonStreamParser sceneNodeJsonStreamParser(entityManager, componentManager);
+        sceneNodeJsonStreamParser.ParseScene(scene, sceneFile.GetData(), sceneFile.GetSize());
+        break;
+    }
+    case LoadPath::PARALLEL: {
+        MappedFile sceneFile(filePath);
+        SceneNodeJsonParallelParser sceneNodeJsonParallelParser(entityManager, componentManager);
+        if (sceneNodeJsonParallelParser.Compile(sceneFile.GetData(), sceneFile.GetSize(), filePath)) {
+            sceneNodeJsonParallelParser.ParseScene(scene);
+        }
+        break;
+    }
+    case LoadPath::COMPILED: {
+        MappedFile compiledSceneFile(BinarySceneFormat::GetCompiledFilePath(filePath));
+        SceneNodeBinaryParser sceneNodeBinaryParser(entityManager, componentManager);
+        if (compiledSceneFile.IsValid() && sceneNodeBinaryParser.Open(compiledSceneFile.GetData(), compiledSceneFile.GetSize())) {
+            sceneNodeBinaryParser.ParseScene(scene);
+        }
+        break;
+    }
+    case LoadPath::NONE:
+        break;
+    }
+    return scene->hierarchy.GetNodeCount();
+}
+
+// Each load runs in its own process so peak memory isn't hidden by what earlier loads left in the allocator, and every
+// load starts from the same empty managers
+LoadResult MeasureLoad(LoadPath loadPath, const std::string& filePath) {
+    int resultPipe[2];
+    if (pipe(resultPipe) != 0) {
+        return LoadResult{};
+    }
+    const pid_t pid = fork();
+    if (pid == 0) {
+        EntityManager entityManager;
+        ComponentManager componentManager;
+        componentManager.RegisterComponent<SceneComponent>();
+        componentManager.RegisterComponent<Transform2DComponent>();
+        componentManager.RegisterComponent<SpriteComponent>();
+        componentManager.RegisterComponent<TextLabelComponent>();
+        componentManager.RegisterComponent<AnimatedSpriteComponent>();
+        componentManager.RegisterComponent<ColliderComponent>();
+        LoadResult result;
+        const auto start = std::chrono::steady_clock::now();
+        result.nodeCount = LoadScene(loadPath, filePath, &entityManager, &componentManager);
+        result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const ssize_t writtenSize = write(resultPipe[1], &result, sizeof(LoadResult));
+        _exit(writtenSize == sizeof(LoadResult) ? 0 : 1);
+    }
+    close(resultPipe[1]);
+    LoadResult result;
+    if (pid < 0 || read(resultPipe[0], &result, sizeof(LoadResult)) != sizeof(LoadResult)) {
+        result = LoadResult{};
+    }
+    close(resultPipe[0]);
+    int status = 0;
+    struct rusage usage {};
+    if (pid > 0 && wait4(pid, &status, 0, &usage) == pid) {
+        result.peakKilobytes = usage.ru_maxrss;
+    }
+    return result;
+}
+
+int main() {
+    Logger::GetInstance()->SetLogLevel(LogLevel::ERROR);
+    const std::vector<std::pair<LoadPath, std::string>> loadPaths = {
+        { LoadPath::DOM, "DOM:      " },
+        { LoadPath::STREAM, "Stream:   " },
+        { LoadPath::PARALLEL, "Parallel: " },
+        { LoadPath::COMPILED, "Compiled: " },
+    };
+    for (size_t nodeCount : SCENE_NODE_COUNTS) {
+        const std::string filePath = "scene_loading_" + std::to_string(nodeCount) + ".json";
+        const std::string compiledFilePath = BinarySceneFormat::GetCompiledFilePath(filePath);
+        GenerateSceneFiles(filePath, compiledFilePath, nodeCount);
+
+        const long baselineKilobytes = MeasureLoad(LoadPath::NONE, filePath).peakKilobytes;
+        std::cout << "Nodes: " << nodeCount << ", file size: " << MappedFile(filePath).GetSize() / 1024 << " KB" << std::endl;
+        for (const auto& loadPath : loadPaths) {
+            const LoadResult result = MeasureLoad(loadPath.first, filePath);
+            std::cout << loadPath.second << result.milliseconds << " ms, peak +" << (result.peakKilobytes - baselineKilobytes) / 1024.0
+                      << " MB" << (result.nodeCount == nodeCount ? "" : ", nodes missing!") << std::endl;
+        }
+        std::remove(filePath.c_str());
+        std::remove(compiledFilePath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,337 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <unordered_map>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "re/rendering/sprite_renderer.h"
+#include "re/rendering/texture_atlas.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+// Sprites cut from a few shared textures, grouped by texture like a scene sorted into layers
+const int SPRITE_COUNT = 10000;
+const int TEXTURE_COUNT = 4;
+const int TEXTURE_SIZE = 256;
+const int TILE_SIZE = 16;
+const int FRAMES = 20;
+const int LEGACY_FRAMES = 3;
+// Many small images drawn interleaved, the worst case for batching by texture
+const int ATLAS_IMAGE_COUNT = 64;
+const int ATLAS_SPRITE_COUNT = 10000;
+// Edges of rotated sprites can rasterize a pixel apart between the two paths
+const double MAX_DIFFERENT_PIXEL_RATIO = 0.01;
+
+struct SyntheticSprite {
+    int texture;
+    Rect2 sourceRectangle;
+    Rect2 destinationRectangle;
+    float rotation;
+    Color color;
+    bool flipX;
+    bool flipY;
+};
+
+static const std::string &OPENGL_SHADER_SOURCE_VERTEX_LEGACY_SPRITE =
+    "#version 330 core\n"
+    "layout (location = 0) in vec4 vertex;\n"
+    "out vec2 texCoord;\n"
+    "uniform mat4 projection;\n"
+    "uniform mat4 model;\n"
+    "void main() {\n"
+    "    texCoord = vertex.zw;\n"
+    "    gl_Position = projection * model * vec4(vertex.xy, 0.0f, 1.0f);\n"
+    "}\n";
+
+static const std::string &OPENGL_SHADER_SOURCE_FRAGMENT_LEGACY_SPRITE =
+    "#version 330 core\n"
+    "in vec2 texCoord;\n"
+    "out vec4 color;\n"
+    "uniform sampler2D sprite;\n"
+    "uniform vec4 spriteColor;\n"
+    "void main() {\n"
+    "    color = spriteColor * texture(sprite, texCoord);\n"
+    "}\n";
+
+// The previous per sprite path: one draw call per sprite and the source rectangle uploaded into the texture each time
+class LegacySpriteRenderer {
+  public:
+    LegacySpriteRenderer() {
+        glGenVertexArrays(1, &quadVAO);
+        glGenBuffers(1, &quadVBO);
+        glBindVertexArray(quadVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 24, nullptr, GL_DYNAMIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*) nullptr);
+        glBindVertexArray(0);
+        shader = Shader(OpenGLShaderSourceCode{ OPENGL_SHADER_SOURCE_VERTEX_LEGACY_SPRITE, OPENGL_SHADER_SOURCE_FRAGMENT_LEGACY_SPRITE });
+        shader.Use();
+        shader.SetInt("sprite", 0);
+        const ProjectProperties* projectProperties = ProjectProperties::GetInstance();
+        shader.SetMatrix4Float("projection", glm::ortho(0.0f, static_cast<float>(projectProperties->GetWindowWidth()), static_cast<float>(projectProperties->GetWindowHeight()), 0.0f, -1.0f, 1.0f));
+    }
+
+    void Draw(Texture *texture2D, const Rect2 &sourceRectangle, const Rect2 &destinationRectangle, float rotation, const Color &color, bool flipX, bool flipY) {
+        Matrix4 model = glm::mat4(1.0f);
+        model = glm::translate(model, glm::vec3(destinationRectangle.x, destinationRectangle.y, 0.0f));
+        model = glm::translate(model, Vector3(0.5f * destinationRectangle.w, 0.5f * destinationRectangle.h, 0.0f));
+        model = glm::rotate(model, glm::radians(rotation), Vector3(0.0f, 0.0f, 1.0f));
+        model = glm::translate(model, Vector3(-0.5f * destinationRectangle.w, -0.5f * destinationRectangle.h, 0.0f));
+        model = glm::scale(model, Vector3(destinationRectangle.w, destinationRectangle.h, 1.0f));
+        glBindVertexArray(quadVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        shader.Use();
+        shader.SetMatrix4Float("model", model);
+        shader.SetVec4Float("spriteColor", color.r, color.g, color.b, color.a);
+        glActiveTexture(GL_TEXTURE0);
+        texture2D->Bind();
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, texture2D->GetWidth());
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, sourceRectangle.x);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, sourceRectangle.y);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sourceRectangle.w, sourceRectangle.h, 0, texture2D->GetImageFormat(), GL_UNSIGNED_BYTE, texture2D->GetData());
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+        const float left = flipX ? 1.0f : 0.0f;
+        const float right = 1.0f - left;
+        const float top = flipY ? 1.0f : 0.0f;
+        const float bottom = 1.0f - top;
+        const GLfloat vertices[6][4] = {
+            { 0.0f, 1.0f, left, bottom }, { 1.0f, 0.0f, right, top }, { 0.0f, 0.0f, left, top },
+            { 0.0f, 1.0f, left, bottom }, { 1.0f, 1.0f, right, bottom }, { 1.0f, 0.0f, right, top }
+        };
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+    }
+
+  private:
+    Shader shader;
+    GLuint quadVAO = 0;
+    GLuint quadVBO = 0;
+};
+
+// Surfaceless context rendering into a framebuffer object, so the benchmark runs without a window or display
+bool CreateHeadlessContext(int width, int height) {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    EGLDisplay display = getPlatformDisplay != nullptr ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_API)) {
+        return false;
+    }
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        return false;
+    }
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+        return false;
+    }
+    GLuint framebuffer;
+    GLuint colorBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glViewport(0, 0, width, height);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+std::vector<SyntheticSprite> BuildSyntheticSprites(int windowWidth, int windowHeight) {
+    std::vector<SyntheticSprite> sprites;
+    sprites.reserve(SPRITE_COUNT);
+    const int tilesPerRow = TEXTURE_SIZE / TILE_SIZE;
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        SyntheticSprite sprite;
+        sprite.texture = i * TEXTURE_COUNT / SPRITE_COUNT;
+        const int tile = (i * 7) % (tilesPerRow * tilesPerRow);
+        sprite.sourceRectangle = Rect2(static_cast<float>((tile % tilesPerRow) * TILE_SIZE), static_cast<float>((tile / tilesPerRow) * TILE_SIZE), TILE_SIZE, TILE_SIZE);
+        const float size = static_cast<float>(16 + (i % 3) * 8);
+        sprite.destinationRectangle = Rect2(static_cast<float>((i * 37) % (windowWidth - 32)), static_cast<float>((i * 53) % (windowHeight - 32)), size, size);
+        sprite.rotation = static_cast<float>((i % 8) * 45);
+        sprite.color = Color(1.0f, static_cast<float>(i % 5) / 4.0f, 0.5f, 0.75f);
+        sprite.flipX = i % 2 == 0;
+        sprite.flipY = i % 3 == 0;
+        sprites.emplace_back(sprite);
+    }
+    return sprites;
+}
+
+void FlushRenderer(SpriteRenderer& renderer) {
+    renderer.Flush();
+}
+
+void FlushRenderer(LegacySpriteRenderer&) {}
+
+template<typename Renderer>
+double MeasureSpritesPerSecond(Renderer& renderer, const std::vector<Texture*>& textures, const std::vector<SyntheticSprite>& sprites, int frames) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        for (const SyntheticSprite& sprite : sprites) {
+            renderer.Draw(textures[sprite.texture], sprite.sourceRectangle, sprite.destinationRectangle, sprite.rotation, sprite.color, sprite.flipX, sprite.flipY);
+        }
+        FlushRenderer(renderer);
+        glFinish();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return static_cast<double>(sprites.size()) * frames / std::chrono::duration<double>(end - start).count();
+}
+
+int GetAtlasImageWidth(int image) {
+    return 16 + (image % 4) * 8;
+}
+
+int GetAtlasImageHeight(int image) {
+    return 16 + (image / 4 % 4) * 8;
+}
+
+// Each image's red channel is its own tint, so a sprite sampling the wrong region or a neighbour's pixels shows
+unsigned char* CreateAtlasImagePixels(int image) {
+    const int width = GetAtlasImageWidth(image);
+    const int height = GetAtlasImageHeight(image);
+    unsigned char* pixels = static_cast<unsigned char*>(std::malloc(width * height * 4));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            unsigned char* pixel = pixels + (y * width + x) * 4;
+            pixel[0] = static_cast<unsigned char>(image * 4);
+            pixel[1] = static_cast<unsigned char>(x * 255 / (width - 1));
+            pixel[2] = static_cast<unsigned char>(y * 255 / (height - 1));
+            pixel[3] = 255;
+        }
+    }
+    return pixels;
+}
+
+std::vector<SyntheticSprite> BuildAtlasSprites(int windowWidth, int windowHeight) {
+    std::vector<SyntheticSprite> sprites;
+    sprites.reserve(ATLAS_SPRITE_COUNT);
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++) {
+        SyntheticSprite sprite;
+        sprite.texture = i % ATLAS_IMAGE_COUNT;
+        sprite.sourceRectangle = Rect2(0.0f, 0.0f, static_cast<float>(GetAtlasImageWidth(sprite.texture)), static_cast<float>(GetAtlasImageHeight(sprite.texture)));
+        const float size = static_cast<float>(16 + (i % 3) * 8);
+        sprite.destinationRectangle = Rect2(static_cast<float>((i * 37) % (windowWidth - 32)), static_cast<float>((i * 53) % (windowHeight - 32)), size, size);
+        sprite.rotation = 0.0f;
+        sprite.color = Color(1.0f, 1.0f, 1.0f, 1.0f);
+        sprite.flipX = i % 2 == 0;
+        sprite.flipY = false;
+        sprites.emplace_back(sprite);
+    }
+    return sprites;
+}
+
+size_t CountDifferentPixels(const std::vector<unsigned char>& pixels, const std::vector<unsigned char>& expectedPixels) {
+    size_t differentPixelCount = 0;
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        for (size_t channel = 0; channel < 4; channel++) {
+            if (std::abs(static_cast<int>(pixels[i + channel]) - static_cast<int>(expectedPixels[i + channel])) > 2) {
+                differentPixelCount++;
+                break;
+            }
+        }
+    }
+    return differentPixelCount;
+}
+
+std::vector<unsigned char> ReadPixels(int width, int height) {
+    std::vector<unsigned char> pixels(width * height * 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+// Textures are solid colors, the legacy path overwrites them with their own source rectangles
+std::vector<Texture*> CreateTextures() {
+    std::vector<Texture*> textures;
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        textures.emplace_back(new Texture(TEXTURE_SIZE, TEXTURE_SIZE, 255 - i * 48));
+    }
+    return textures;
+}
+
+int main() {
+    const ProjectProperties* projectProperties = ProjectProperties::GetInstance();
+    const int width = static_cast<int>(projectProperties->GetWindowWidth());
+    const int height = static_cast<int>(projectProperties->GetWindowHeight());
+    if (!CreateHeadlessContext(width, height)) {
+        std::cout << "Failed to create a headless OpenGL 3.3 context!" << std::endl;
+        return 1;
+    }
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+    const std::vector<SyntheticSprite> sprites = BuildSyntheticSprites(width, height);
+
+    SpriteRenderer spriteRenderer;
+    const std::vector<Texture*> batchedTextures = CreateTextures();
+    const double batchedSpritesPerSecond = MeasureSpritesPerSecond(spriteRenderer, batchedTextures, sprites, FRAMES);
+    const unsigned int batchedDrawCalls = spriteRenderer.GetDrawCallCount() / FRAMES;
+    const std::vector<unsigned char> batchedPixels = ReadPixels(width, height);
+
+    LegacySpriteRenderer legacySpriteRenderer;
+    const std::vector<Texture*> legacyTextures = CreateTextures();
+    const double legacySpritesPerSecond = MeasureSpritesPerSecond(legacySpriteRenderer, legacyTextures, sprites, LEGACY_FRAMES);
+    const std::vector<unsigned char> legacyPixels = ReadPixels(width, height);
+
+    std::cout << "Sprites: " << sprites.size() << ", textures: " << TEXTURE_COUNT << std::endl;
+    std::cout << "Per sprite draw:   " << legacySpritesPerSecond << " sprites/s, " << sprites.size() << " draw calls per frame" << std::endl;
+    std::cout << "Batched:           " << batchedSpritesPerSecond << " sprites/s, " << batchedDrawCalls << " draw calls per frame" << std::endl;
+
+    const size_t differentPixelCount = CountDifferentPixels(batchedPixels, legacyPixels);
+    const bool isValid = static_cast<double>(differentPixelCount) / (width * height) <= MAX_DIFFERENT_PIXEL_RATIO;
+    std::cout << (isValid ? "Output matches the per sprite path" : "Output doesn't match the per sprite path!") << std::endl;
+
+    // Same images as standalone textures and packed into an atlas
+    const std::vector<SyntheticSprite> atlasSprites = BuildAtlasSprites(width, height);
+    std::vector<Texture*> standaloneTextures;
+    TextureAtlas textureAtlas(TextureAtlasSettings{});
+    for (int image = 0; image < ATLAS_IMAGE_COUNT; image++) {
+        standaloneTextures.emplace_back(new Texture(GetAtlasImageWidth(image), GetAtlasImageHeight(image), CreateAtlasImagePixels(image), "nearest", "nearest"));
+        textureAtlas.AddImage(std::to_string(image), CreateAtlasImagePixels(image), GetAtlasImageWidth(image), GetAtlasImageHeight(image),
+                              "clamp_to_border", "clamp_to_border", "nearest", "nearest");
+    }
+    const auto packStart = std::chrono::steady_clock::now();
+    std::unordered_map<std::string, Texture*> atlasRegions = textureAtlas.Build();
+    const double packMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - packStart).count();
+    std::vector<Texture*> atlasTextures;
+    for (int image = 0; image < ATLAS_IMAGE_COUNT; image++) {
+        atlasTextures.emplace_back(atlasRegions[std::to_string(image)]);
+    }
+
+    spriteRenderer.ResetDrawCallCount();
+    const double standaloneSpritesPerSecond = MeasureSpritesPerSecond(spriteRenderer, standaloneTextures, atlasSprites, FRAMES);
+    const unsigned int standaloneDrawCalls = spriteRenderer.GetDrawCallCount() / FRAMES;
+    const std::vector<unsigned char> standalonePixels = ReadPixels(width, height);
+    spriteRenderer.ResetDrawCallCount();
+    const double atlasSpritesPerSecond = MeasureSpritesPerSecond(spriteRenderer, atlasTextures, atlasSprites, FRAMES);
+    const unsigned int atlasDrawCalls = spriteRenderer.GetDrawCallCount() / FRAMES;
+    const std::vector<unsigned char> atlasPixels = ReadPixels(width, height);
+
+    // Every flush binds its texture once, so draw calls are also texture binds
+    std::cout << std::endl << "Sprites: " << atlasSprites.size() << ", images: " << ATLAS_IMAGE_COUNT << " interleaved" << std::endl;
+    std::cout << "Atlas: " << textureAtlas.GetPageCount() << " pages, " << static_cast<int>(textureAtlas.GetPageUsage() * 100.0f) << "% used, packed in " << packMilliseconds << " ms" << std::endl;
+    std::cout << "Standalone textures: " << standaloneSpritesPerSecond << " sprites/s, " << standaloneDrawCalls << " draw calls and binds per frame" << std::endl;
+    std::cout << "Atlas regions:       " << atlasSpritesPerSecond << " sprites/s, " << atlasDrawCalls << " draw calls and binds per frame" << std::endl;
+    // Scaled sprites can land exactly between two texels and round to either, but never onto another image's pixels
+    size_t bleedingPixelCount = 0;
+    for (size_t i = 0; i < atlasPixels.size(); i += 4) {
+        if (atlasPixels[i] != standalonePixels[i] || atlasPixels[i + 3] != standalonePixels[i + 3]) {
+            bleedingPixelCount++;
+        }
+    }
+    const bool isAtlasValid = bleedingPixelCount == 0;
+    std::cout << (isAtlasValid ? "Atlas output matches the standalone textures" : "Atlas output doesn't match the standalone textures!") << std::endl;
+    return isValid && isAtlasValid ? 0 : 1;
+}
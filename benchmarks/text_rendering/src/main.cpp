@@ -0,0 +1,522 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "re/rendering/font_renderer.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+// A screen of UI text: labels of a few dozen characters in one font and several colors
+const int LABEL_COUNT = 300;
+const int FONT_SIZE = 20;
+const int FRAMES = 20;
+const int LEGACY_FRAMES = 5;
+// Linear filtering at glyph edges can round a step apart between the two paths
+const double MAX_DIFFERENT_PIXEL_RATIO = 0.001;
+// Two localized screens take turns, a cache this small holds only one of them at a time
+const int SMALL_GLYPH_CACHE_PAGE_SIZE = 64;
+const int SMALL_GLYPH_CACHE_MAX_PAGES = 12;
+const int LOCALIZED_FRAMES = 8;
+// A UI using the font at every one of these sizes
+const int FONT_SIZES[] = { 12, 16, 20, 24, 32, 48, 64 };
+const float ZOOMED_TEXT_SCALE = 4.0f;
+
+struct SyntheticLabel {
+    std::string text;
+    float x;
+    float y;
+    float scale;
+    Color color;
+};
+
+struct LegacyCharacter {
+    GLuint textureID;
+    Vector2 size;
+    Vector2 bearing;
+    unsigned int advance;
+};
+
+// The previous font: one texture per glyph, looked up through a map
+class LegacyFont {
+  public:
+    std::map<GLchar, LegacyCharacter> characters;
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+
+    LegacyFont(FT_Library freeTypeLibrary, const char* fileName, int size) : size(size) {
+        FT_Face face;
+        if (FT_New_Face(freeTypeLibrary, fileName, 0, &face)) {
+            return;
+        }
+        FT_Set_Pixel_Sizes(face, 0, size);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (unsigned char c = 0; c < 128; c++) {
+            if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
+                continue;
+            }
+            unsigned int textTexture;
+            glGenTextures(1, &textTexture);
+            glBindTexture(GL_TEXTURE_2D, textTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            characters.insert(std::pair<char, LegacyCharacter>(c, LegacyCharacter{
+                textTexture,
+                Vector2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
+                Vector2(face->glyph->bitmap_left, face->glyph->bitmap_top),
+                static_cast<unsigned int>(face->glyph->advance.x)
+            }));
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        FT_Done_Face(face);
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), nullptr);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+  private:
+    int size;
+};
+
+static const std::string &OPENGL_SHADER_SOURCE_VERTEX_LEGACY_FONT =
+    "#version 330 core\n"
+    "layout (location = 0) in vec4 vertex;\n"
+    "out vec2 texCoords;\n"
+    "uniform mat4 projection;\n"
+    "void main() {\n"
+    "    gl_Position = projection * vec4(vertex.xy, 0.0f, 1.0f);\n"
+    "    texCoords = vertex.zw;\n"
+    "}";
+
+static const std::string &OPENGL_SHADER_SOURCE_FRAGMENT_LEGACY_FONT =
+    "#version 330 core\n"
+    "in vec2 texCoords;\n"
+    "out vec4 color;\n"
+    "uniform sampler2D textValue;\n"
+    "uniform vec4 textColor;\n"
+    "void main() {\n"
+    "    color = textColor * vec4(1.0f, 1.0f, 1.0f, texture(textValue, texCoords).r);\n"
+    "}";
+
+// The previous per glyph path: a bind, a buffer update and a draw call per character
+class LegacyFontRenderer {
+  public:
+    LegacyFontRenderer() : projectProperties(ProjectProperties::GetInstance()) {
+        shader = Shader(OpenGLShaderSourceCode{ OPENGL_SHADER_SOURCE_VERTEX_LEGACY_FONT, OPENGL_SHADER_SOURCE_FRAGMENT_LEGACY_FONT });
+        shader.Use();
+        shader.SetMatrix4Float("projection", glm::ortho(0.0f, static_cast<float>(projectProperties->GetWindowWidth()), 0.0f, static_cast<float>(projectProperties->GetWindowHeight()), -1.0f, 1.0f));
+    }
+
+    void Draw(LegacyFont *font, const std::string &text, float x, float y, float scale, const Color color) {
+        shader.Use();
+        shader.SetVec4Float("textColor", color);
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(font->VAO);
+        const float windowWidth = static_cast<float>(projectProperties->GetWindowWidth());
+        const float windowHeight = static_cast<float>(projectProperties->GetWindowHeight());
+        y = ((y - windowWidth) / (0.0f - windowWidth)) * windowHeight;
+        y -= font->GetSize() * 0.8f;
+        for (std::string::const_iterator c = text.begin(); c != text.end(); c++) {
+            LegacyCharacter ch = font->characters[*c];
+            const float xPos = x + (ch.bearing.x * scale);
+            const float yPos = y - (ch.size.y - ch.bearing.y) * scale;
+            const float w = ch.size.x * scale;
+            const float h = ch.size.y * scale;
+            GLfloat vertices[6][4] = {
+                {xPos,     yPos + h, 0.0f, 0.0f},
+                {xPos,     yPos,     0.0f, 1.0f},
+                {xPos + w, yPos,     1.0f, 1.0f},
+
+                {xPos,     yPos + h, 0.0f, 0.0f},
+                {xPos + w, yPos,     1.0f, 1.0f},
+                {xPos + w, yPos + h, 1.0f, 0.0f}
+            };
+            glBindTexture(GL_TEXTURE_2D, ch.textureID);
+            glBindBuffer(GL_ARRAY_BUFFER, font->VBO);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            drawCallCount++;
+            x += (ch.advance >> 6) * scale;
+        }
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    unsigned int GetDrawCallCount() const {
+        return drawCallCount;
+    }
+
+  private:
+    Shader shader;
+    ProjectProperties *projectProperties = nullptr;
+    unsigned int drawCallCount = 0;
+};
+
+// Surfaceless context rendering into a framebuffer object, so the benchmark runs without a window or display
+bool CreateHeadlessContext(int width, int height) {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    EGLDisplay display = getPlatformDisplay != nullptr ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_API)) {
+        return false;
+    }
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        return false;
+    }
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+        return false;
+    }
+    GLuint framebuffer;
+    GLuint colorBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glViewport(0, 0, width, height);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+std::vector<SyntheticLabel> BuildSyntheticLabels(int windowWidth, int windowHeight) {
+    static const char* LABEL_TEXTS[] = {
+        "Score: 0012345  Lives: 3  Level: 7",
+        "The quick brown fox jumps over the lazy dog",
+        "HP 100/100 MP 45/60 [Inventory]",
+        "Press {Enter} to continue... (or Esc)",
+    };
+    std::vector<SyntheticLabel> labels;
+    labels.reserve(LABEL_COUNT);
+    for (int i = 0; i < LABEL_COUNT; i++) {
+        SyntheticLabel label;
+        label.text = LABEL_TEXTS[i % 4];
+        label.x = static_cast<float>((i * 37) % (windowWidth / 2));
+        label.y = static_cast<float>((i * 53) % windowHeight);
+        label.scale = i % 5 == 0 ? 1.5f : 1.0f;
+        label.color = Color(1.0f, static_cast<float>(i % 3) / 2.0f, static_cast<float>(i % 4) / 3.0f, 0.9f);
+        labels.emplace_back(label);
+    }
+    return labels;
+}
+
+// Every label of a screen is in the same language, the two screens share few glyphs besides ASCII
+std::vector<SyntheticLabel> BuildLocalizedLabels(int windowWidth, int windowHeight, int screen) {
+    static const char* SCREEN_TEXTS[2][4] = {
+        {
+            u8"Съешь же ещё этих мягких французских булок, да выпей чаю",
+            u8"ШИРОКАЯ ЭЛЕКТРИФИКАЦИЯ ЮЖНЫХ ГУБЕРНИЙ ДАСТ МОЩНЫЙ ТОЛЧОК",
+            u8"Здоровье: 100/100  Уровень: 7  Жизни: 3",
+            u8"Нажмите «Ввод», чтобы продолжить… (или Ёж)",
+        },
+        {
+            u8"Ξεσκεπάζω την ψυχοφθόρα βδελυγμία",
+            u8"ΓΑΖΈΕΣ ΚΑῚ ΜΥΡΤΙῈΣ ΔῈΝ ΘᾺ ΒΡΩ͂ ΠΙᾺ ΣΤῸ ΧΡΥΣΑΦῚ ΞΈΦΩΤΟ",
+            u8"Příliš žluťoučký kůň úpěl ďábelské ódy",
+            u8"Zwölf Boxkämpfer jagen Viktor quer über den großen Sylter Deich",
+        },
+    };
+    std::vector<SyntheticLabel> labels;
+    for (int i = 0; i < LABEL_COUNT / 10; i++) {
+        SyntheticLabel label;
+        label.text = SCREEN_TEXTS[screen][i % 4];
+        label.x = static_cast<float>((i * 37) % (windowWidth / 3));
+        label.y = static_cast<float>((i * 53) % windowHeight);
+        label.scale = 1.0f;
+        label.color = Color(1.0f, 1.0f, static_cast<float>(i % 4) / 3.0f, 1.0f);
+        labels.emplace_back(label);
+    }
+    return labels;
+}
+
+void FlushRenderer(FontRenderer& renderer) {
+    renderer.Flush();
+}
+
+void FlushRenderer(LegacyFontRenderer&) {}
+
+struct TextRenderingResult {
+    double labelsPerSecond = 0.0;
+    double submitMicrosecondsPerFrame = 0.0; // CPU time to hand the labels to GL, before waiting on the GPU
+};
+
+// 'submitLabels' draws every label once
+template<typename SubmitFunction>
+TextRenderingResult MeasureTextRendering(size_t labelCount, int frames, const SubmitFunction& submitLabels) {
+    std::chrono::steady_clock::duration submitDuration{};
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        const auto submitStart = std::chrono::steady_clock::now();
+        submitLabels();
+        submitDuration += std::chrono::steady_clock::now() - submitStart;
+        glFinish();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    TextRenderingResult result;
+    result.labelsPerSecond = static_cast<double>(labelCount) * frames / std::chrono::duration<double>(end - start).count();
+    result.submitMicrosecondsPerFrame = std::chrono::duration<double, std::micro>(submitDuration).count() / frames;
+    return result;
+}
+
+template<typename Renderer, typename FontType>
+TextRenderingResult MeasureTextRendering(Renderer& renderer, FontType* font, const std::vector<SyntheticLabel>& labels, int frames) {
+    return MeasureTextRendering(labels.size(), frames, [&renderer, font, &labels] () {
+        for (const SyntheticLabel& label : labels) {
+            renderer.Draw(font, label.text, label.x, label.y, label.scale, label.color);
+        }
+        FlushRenderer(renderer);
+    });
+}
+
+size_t CountDifferentPixels(const std::vector<unsigned char>& pixels, const std::vector<unsigned char>& expectedPixels) {
+    size_t differentPixelCount = 0;
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        for (size_t channel = 0; channel < 4; channel++) {
+            if (std::abs(static_cast<int>(pixels[i + channel]) - static_cast<int>(expectedPixels[i + channel])) > 2) {
+                differentPixelCount++;
+                break;
+            }
+        }
+    }
+    return differentPixelCount;
+}
+
+std::vector<unsigned char> ReadPixels(int width, int height) {
+    std::vector<unsigned char> pixels(width * height * 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+struct LocalizedResult {
+    double coldFrameMilliseconds = 0.0; // First frame of a screen, its glyphs are rasterized and uploaded
+    double warmFrameMilliseconds = 0.0;
+    unsigned int evictedPageCount = 0;
+    bool isValid = true;
+};
+
+// Alternates the two localized screens through cached layouts, the way TextRenderingECSystem draws them.  Timings
+// come from 'font', whose cache holds both screens.  'smallCacheFont' evicts pages on every screen change and has
+// to draw the same pixels.
+LocalizedResult MeasureLocalizedText(FontRenderer& fontRenderer, Font* font, Font* smallCacheFont, int width, int height) {
+    const std::vector<SyntheticLabel> screenLabels[2] = { BuildLocalizedLabels(width, height, 0), BuildLocalizedLabels(width, height, 1) };
+    std::vector<TextLayout> textLayouts[2] = { std::vector<TextLayout>(screenLabels[0].size()), std::vector<TextLayout>(screenLabels[1].size()) };
+    std::vector<TextLayout> smallCacheLayouts[2] = { std::vector<TextLayout>(screenLabels[0].size()), std::vector<TextLayout>(screenLabels[1].size()) };
+    const auto drawScreen = [&fontRenderer, &screenLabels] (std::vector<TextLayout>& layouts, Font* screenFont, int screen) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        const std::vector<SyntheticLabel>& labels = screenLabels[screen];
+        for (size_t i = 0; i < labels.size(); i++) {
+            FontRenderer::UpdateLayout(layouts[i], screenFont, labels[i].text, labels[i].scale);
+            fontRenderer.DrawLayout(layouts[i], labels[i].x, labels[i].y, labels[i].color);
+        }
+        fontRenderer.Flush();
+        glFinish();
+        Font::AdvanceFrame();
+    };
+
+    LocalizedResult result;
+    std::chrono::steady_clock::duration coldDuration{};
+    std::chrono::steady_clock::duration warmDuration{};
+    for (int frame = 0; frame < LOCALIZED_FRAMES; frame++) {
+        const int screen = frame % 2;
+        const auto frameStart = std::chrono::steady_clock::now();
+        drawScreen(textLayouts[screen], font, screen);
+        (frame < 2 ? coldDuration : warmDuration) += std::chrono::steady_clock::now() - frameStart;
+        const std::vector<unsigned char> pixels = ReadPixels(width, height);
+        drawScreen(smallCacheLayouts[screen], smallCacheFont, screen);
+        result.isValid = result.isValid && CountDifferentPixels(ReadPixels(width, height), pixels) == 0;
+    }
+    result.coldFrameMilliseconds = std::chrono::duration<double, std::milli>(coldDuration).count() / 2;
+    result.warmFrameMilliseconds = std::chrono::duration<double, std::milli>(warmDuration).count() / (LOCALIZED_FRAMES - 2);
+    for (unsigned int page = 0; page < smallCacheFont->GetPageCount(); page++) {
+        result.evictedPageCount += smallCacheFont->GetPageGeneration(page);
+    }
+    return result;
+}
+
+struct FontSetResult {
+    double loadMilliseconds = 0.0;
+    size_t textureBytes = 0;
+};
+
+// Loads the font at every size in 'FONT_SIZES' the way AssetManager does, distance field sizes share the first one's glyphs
+FontSetResult LoadFontSet(FT_Library freeTypeLibrary, const char* fontPath, FontRenderMode renderMode, std::vector<std::unique_ptr<Font>>& fonts) {
+    const auto start = std::chrono::steady_clock::now();
+    for (const int size : FONT_SIZES) {
+        if (renderMode == FontRenderMode::DistanceField && !fonts.empty()) {
+            fonts.emplace_back(new Font(*fonts.front(), size));
+        } else {
+            fonts.emplace_back(new Font(freeTypeLibrary, fontPath, size, GlyphCacheSettings(), renderMode));
+        }
+    }
+    FontSetResult result;
+    result.loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const size_t pageBytes = static_cast<size_t>(GlyphCacheSettings().pageSize) * GlyphCacheSettings().pageSize;
+    const size_t cacheCount = renderMode == FontRenderMode::DistanceField ? 1 : fonts.size();
+    for (size_t i = 0; i < cacheCount; i++) {
+        result.textureBytes += fonts[i]->GetPageCount() * pageBytes;
+    }
+    return result;
+}
+
+// Share of the text's pixels that are partly covered, blurred text has wide soft edges
+double MeasureSoftEdgeRatio(FontRenderer& fontRenderer, Font* font, float scale, int width, int height) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    fontRenderer.Draw(font, "Quick brown fox 0123", 10.0f, 10.0f, scale, Color(1.0f, 1.0f, 1.0f, 1.0f));
+    fontRenderer.Flush();
+    const std::vector<unsigned char> pixels = ReadPixels(width, height);
+    size_t coveredPixelCount = 0;
+    size_t softPixelCount = 0;
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        if (pixels[i] > 25) {
+            coveredPixelCount++;
+            if (pixels[i] < 230) {
+                softPixelCount++;
+            }
+        }
+    }
+    return coveredPixelCount > 0 ? static_cast<double>(softPixelCount) / coveredPixelCount : 1.0;
+}
+
+bool RunBenchmarks(FT_Library freeTypeLibrary, const char* fontPath, int width, int height);
+
+int main(int argv, char** args) {
+    if (argv < 2) {
+        std::cout << "Usage: text_rendering_benchmark <font.ttf>" << std::endl;
+        return 1;
+    }
+    const char* fontPath = args[1];
+    const ProjectProperties* projectProperties = ProjectProperties::GetInstance();
+    const int width = static_cast<int>(projectProperties->GetWindowWidth());
+    const int height = static_cast<int>(projectProperties->GetWindowHeight());
+    if (!CreateHeadlessContext(width, height)) {
+        std::cout << "Failed to create a headless OpenGL 3.3 context!" << std::endl;
+        return 1;
+    }
+    FT_Library freeTypeLibrary;
+    if (FT_Init_FreeType(&freeTypeLibrary)) {
+        std::cout << "Failed to initialize FreeType!" << std::endl;
+        return 1;
+    }
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+    // Fonts hold their FreeType face, they're gone by the time the library is released
+    const bool isValid = RunBenchmarks(freeTypeLibrary, fontPath, width, height);
+    FT_Done_FreeType(freeTypeLibrary);
+    return isValid ? 0 : 1;
+}
+
+bool RunBenchmarks(FT_Library freeTypeLibrary, const char* fontPath, int width, int height) {
+    const std::vector<SyntheticLabel> labels = BuildSyntheticLabels(width, height);
+    size_t characterCount = 0;
+    for (const SyntheticLabel& label : labels) {
+        characterCount += label.text.size();
+    }
+
+    const auto fontLoadStart = std::chrono::steady_clock::now();
+    Font font(freeTypeLibrary, fontPath, FONT_SIZE);
+    const double fontLoadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - fontLoadStart).count();
+    if (!font.IsValid()) {
+        std::cout << "Failed to load font '" << fontPath << "'!" << std::endl;
+        return false;
+    }
+    FontRenderer fontRenderer;
+    const TextRenderingResult batchedResult = MeasureTextRendering(fontRenderer, &font, labels, FRAMES);
+    const unsigned int batchedDrawCalls = fontRenderer.GetDrawCallCount() / FRAMES;
+    const std::vector<unsigned char> batchedPixels = ReadPixels(width, height);
+
+    // Layouts are kept per label like TextRenderingECSystem does, unchanged labels skip the glyph walk
+    std::vector<TextLayout> textLayouts(labels.size());
+    fontRenderer.ResetDrawCallCount();
+    const TextRenderingResult cachedResult = MeasureTextRendering(labels.size(), FRAMES, [&fontRenderer, &font, &labels, &textLayouts] () {
+        for (size_t i = 0; i < labels.size(); i++) {
+            const SyntheticLabel& label = labels[i];
+            FontRenderer::UpdateLayout(textLayouts[i], &font, label.text, label.scale);
+            fontRenderer.DrawLayout(textLayouts[i], label.x, label.y, label.color);
+        }
+        fontRenderer.Flush();
+    });
+    const unsigned int cachedDrawCalls = fontRenderer.GetDrawCallCount() / FRAMES;
+    const std::vector<unsigned char> cachedPixels = ReadPixels(width, height);
+
+    LegacyFont legacyFont(freeTypeLibrary, fontPath, FONT_SIZE);
+    LegacyFontRenderer legacyFontRenderer;
+    const TextRenderingResult legacyResult = MeasureTextRendering(legacyFontRenderer, &legacyFont, labels, LEGACY_FRAMES);
+    const unsigned int legacyDrawCalls = legacyFontRenderer.GetDrawCallCount() / LEGACY_FRAMES;
+    const std::vector<unsigned char> legacyPixels = ReadPixels(width, height);
+
+    Font localizedFont(freeTypeLibrary, fontPath, FONT_SIZE);
+    GlyphCacheSettings smallGlyphCache;
+    smallGlyphCache.pageSize = SMALL_GLYPH_CACHE_PAGE_SIZE;
+    smallGlyphCache.maxPages = SMALL_GLYPH_CACHE_MAX_PAGES;
+    Font smallCacheFont(freeTypeLibrary, fontPath, FONT_SIZE, smallGlyphCache);
+    const LocalizedResult localizedResult = MeasureLocalizedText(fontRenderer, &localizedFont, &smallCacheFont, width, height);
+
+    std::vector<std::unique_ptr<Font>> bitmapFonts;
+    std::vector<std::unique_ptr<Font>> distanceFieldFonts;
+    const FontSetResult bitmapSetResult = LoadFontSet(freeTypeLibrary, fontPath, FontRenderMode::Bitmap, bitmapFonts);
+    const FontSetResult distanceFieldSetResult = LoadFontSet(freeTypeLibrary, fontPath, FontRenderMode::DistanceField, distanceFieldFonts);
+    Font distanceFieldFont(*distanceFieldFonts.front(), FONT_SIZE);
+    fontRenderer.ResetDrawCallCount();
+    const TextRenderingResult distanceFieldResult = MeasureTextRendering(fontRenderer, &distanceFieldFont, labels, FRAMES);
+    const unsigned int distanceFieldDrawCalls = fontRenderer.GetDrawCallCount() / FRAMES;
+    const double bitmapSoftEdgeRatio = MeasureSoftEdgeRatio(fontRenderer, &font, ZOOMED_TEXT_SCALE, width, height);
+    const double distanceFieldSoftEdgeRatio = MeasureSoftEdgeRatio(fontRenderer, &distanceFieldFont, ZOOMED_TEXT_SCALE, width, height);
+
+    std::cout << "Font load: " << fontLoadMilliseconds << " ms, " << font.GetCachedGlyphCount() << " glyphs cached up front" << std::endl;
+    std::cout << "Labels: " << labels.size() << ", characters: " << characterCount << std::endl;
+    std::cout << "Per glyph draw: " << legacyResult.labelsPerSecond << " labels/s, " << legacyResult.submitMicrosecondsPerFrame << " us/frame submit, "
+              << legacyDrawCalls << " draw calls per frame" << std::endl;
+    std::cout << "Glyph atlas:    " << batchedResult.labelsPerSecond << " labels/s, " << batchedResult.submitMicrosecondsPerFrame << " us/frame submit, "
+              << batchedDrawCalls << " draw calls per frame" << std::endl;
+    std::cout << "Cached layouts: " << cachedResult.labelsPerSecond << " labels/s, " << cachedResult.submitMicrosecondsPerFrame << " us/frame submit, "
+              << cachedDrawCalls << " draw calls per frame" << std::endl;
+
+    const size_t maxDifferentPixelCount = static_cast<size_t>(MAX_DIFFERENT_PIXEL_RATIO * width * height);
+    const bool isValid = CountDifferentPixels(batchedPixels, legacyPixels) <= maxDifferentPixelCount
+                         && CountDifferentPixels(cachedPixels, legacyPixels) <= maxDifferentPixelCount;
+    std::cout << (isValid ? "Output matches the per glyph path" : "Output doesn't match the per glyph path!") << std::endl;
+
+    std::cout << "Localized screens: " << localizedResult.coldFrameMilliseconds << " ms per frame rasterizing new glyphs, "
+              << localizedResult.warmFrameMilliseconds << " ms per frame cached, " << localizedFont.GetCachedGlyphCount() << " glyphs on "
+              << localizedFont.GetPageCount() << " pages" << std::endl;
+    std::cout << "Small glyph cache (" << SMALL_GLYPH_CACHE_MAX_PAGES << " pages of " << SMALL_GLYPH_CACHE_PAGE_SIZE << "px): "
+              << localizedResult.evictedPageCount << " pages evicted" << std::endl;
+    std::cout << (localizedResult.isValid ? "Output matches with evictions" : "Output doesn't match with evictions!") << std::endl;
+
+    std::cout << "Bitmap fonts at " << bitmapFonts.size() << " sizes:  " << bitmapSetResult.loadMilliseconds << " ms load, "
+              << bitmapSetResult.textureBytes / 1024 << " KiB glyph pages" << std::endl;
+    std::cout << "Distance field font: " << distanceFieldSetResult.loadMilliseconds << " ms load, "
+              << distanceFieldSetResult.textureBytes / 1024 << " KiB glyph pages" << std::endl;
+    std::cout << "Distance field draw: " << distanceFieldResult.labelsPerSecond << " labels/s, " << distanceFieldResult.submitMicrosecondsPerFrame
+              << " us/frame submit, " << distanceFieldDrawCalls << " draw calls per frame" << std::endl;
+    std::cout << "Soft edge pixels at " << ZOOMED_TEXT_SCALE << "x: " << bitmapSoftEdgeRatio * 100.0 << "% bitmap, "
+              << distanceFieldSoftEdgeRatio * 100.0 << "% distance field" << std::endl;
+    return isValid && localizedResult.isValid && distanceFieldSoftEdgeRatio < bitmapSoftEdgeRatio;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <string>
+
+#include "re/scene/transform_propagator.h"
+
+// Synthetic hierarchy: a handful of roots with a fixed branching factor, filled breadth first until 'nodeCount'
+const size_t NODE_COUNT = 100000;
+const size_t ROOT_COUNT = 8;
+const size_t CHILDREN_PER_NODE = 12;
+const int ITERATIONS = 50;
+
+struct SyntheticNode {
+    size_t parent; // Index into the node list, NODE_COUNT for root nodes
+    Transform2DComponent localTransform;
+};
+
+std::vector<SyntheticNode> BuildSyntheticHierarchy() {
+    std::vector<SyntheticNode> nodes;
+    nodes.reserve(NODE_COUNT);
+    for (size_t i = 0; i < NODE_COUNT; i++) {
+        const size_t parent = i < ROOT_COUNT ? NODE_COUNT : (i - ROOT_COUNT) / CHILDREN_PER_NODE;
+        Transform2DComponent localTransform{};
+        localTransform.position = Vector2(static_cast<float>(i % 17), static_cast<float>(i % 23));
+        localTransform.scale = Vector2(1.0f + static_cast<float>(i % 3) * 0.01f, 1.0f);
+        localTransform.rotation = static_cast<float>(i % 5);
+        localTransform.zIndex = static_cast<int>(i % 4);
+        nodes.emplace_back(SyntheticNode{ parent, localTransform });
+    }
+    return nodes;
+}
+
+// Per node parent chain walk, the cost of resolving every node without a cache
+void ComputeByParentWalk(const std::vector<SyntheticNode>& nodes, std::vector<Transform2DComponent>& worldTransforms) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        Transform2DComponent combinedTransform = nodes[i].localTransform;
+        for (size_t parent = nodes[i].parent; parent != NODE_COUNT; parent = nodes[parent].parent) {
+            const Transform2DComponent& parentTransform = nodes[parent].localTransform;
+            combinedTransform.position += parentTransform.position;
+            combinedTransform.scale *= parentTransform.scale;
+            combinedTransform.rotation += parentTransform.rotation;
+            combinedTransform.zIndex += parentTransform.zIndex;
+        }
+        worldTransforms[i] = combinedTransform;
+    }
+}
+
+// Nodes are generated breadth first so slot = node index + 1, a level starts whenever the depth increases
+void LayoutPropagator(TransformPropagator& propagator, const std::vector<SyntheticNode>& nodes) {
+    std::vector<size_t> depths(nodes.size(), 0);
+    propagator.Reset();
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const bool isRoot = nodes[i].parent == NODE_COUNT;
+        depths[i] = isRoot ? 0 : depths[nodes[i].parent] + 1;
+        if (i == 0 || depths[i] != depths[i - 1]) {
+            propagator.BeginLevel();
+        }
+        propagator.AddNode(static_cast<Entity>(i + 1), isRoot ? TransformPropagator::ROOT_SLOT : nodes[i].parent + 1);
+        propagator.SetLocalTransform(i + 1, nodes[i].localTransform);
+    }
+}
+
+template<typename Func>
+double MeasureMilliseconds(Func func) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        func();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / ITERATIONS;
+}
+
+bool MatchesReference(const TransformPropagator& propagator, const std::vector<Transform2DComponent>& referenceTransforms) {
+    for (size_t i = 0; i < referenceTransforms.size(); i++) {
+        const Transform2DComponent worldTransform = propagator.GetWorldTransform(i + 1);
+        if (std::abs(worldTransform.position.x - referenceTransforms[i].position.x) > 0.01f
+                || std::abs(worldTransform.scale.x - referenceTransforms[i].scale.x) > 0.001f
+                || worldTransform.zIndex != referenceTransforms[i].zIndex) {
+            std::cout << "Mismatch at node " << i << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Optional argument overrides the worker thread count
+int main(int argv, char** args) {
+    const unsigned int workerCount = argv > 1 ? static_cast<unsigned int>(std::stoi(args[1])) : TransformPropagator::DefaultWorkerCount();
+    const std::vector<SyntheticNode> nodes = BuildSyntheticHierarchy();
+    std::vector<Transform2DComponent> referenceTransforms(nodes.size());
+
+    TransformPropagator singleThreadedPropagator(0);
+    TransformPropagator multiThreadedPropagator(workerCount);
+    LayoutPropagator(singleThreadedPropagator, nodes);
+    LayoutPropagator(multiThreadedPropagator, nodes);
+
+    const double parentWalkTime = MeasureMilliseconds([&nodes, &referenceTransforms] {
+        ComputeByParentWalk(nodes, referenceTransforms);
+    });
+    const double singleThreadedTime = MeasureMilliseconds([&singleThreadedPropagator] {
+        singleThreadedPropagator.Propagate();
+    });
+    const double multiThreadedTime = MeasureMilliseconds([&multiThreadedPropagator] {
+        multiThreadedPropagator.Propagate();
+    });
+
+    std::cout << "Nodes: " << nodes.size() << ", worker threads: " << workerCount << std::endl;
+    std::cout << "Parent chain walk:           " << parentWalkTime << " ms" << std::endl;
+    std::cout << "Batched, single threaded:    " << singleThreadedTime << " ms" << std::endl;
+    std::cout << "Batched, worker threads:     " << multiThreadedTime << " ms" << std::endl;
+
+    const bool isValid = MatchesReference(singleThreadedPropagator, referenceTransforms) && MatchesReference(multiThreadedPropagator, referenceTransforms);
+    std::cout << (isValid ? "Results match reference" : "Results don't match reference!") << std::endl;
+    return isValid ? 0 : 1;
+}
@@ -6,6 +6,7 @@
 
 class CameraManager : public Singleton<CameraManager> {
   public:
+    CameraManager() = default;
     CameraManager(singleton) {}
     Camera2D GetCurrentCamera();
     void UpdateCurrentCamera2D(Camera2D updatedCamera);
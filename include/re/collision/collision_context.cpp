@@ -4,11 +4,11 @@
 #include "../ecs/component/components/transform2d_component.h"
 #include "../scene/scene_node_utils.h"
 
-CollisionContext::CollisionContext(singleton) : componentManager(ComponentManager::GetInstance()) {}
+CollisionContext::CollisionContext(World* world) : world(world), componentManager(world->GetComponentManager()) {}
 
 Rect2 CollisionContext::GetCollisionRectangle(Entity entity) {
     ColliderComponent colliderComponent = componentManager->GetComponent<ColliderComponent>(entity);
-    Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity);
+    Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity, world);
     return Rect2(translatedTransform.position.x + colliderComponent.collider.x,
                  translatedTransform.position.y + colliderComponent.collider.y,
                  translatedTransform.scale.x * colliderComponent.collider.w,
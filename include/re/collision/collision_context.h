@@ -1,7 +1,5 @@
 #pragma once
 
-#include "../utils/singleton.h"
-
 #include <vector>
 
 #include "../math/redmath.h"
@@ -12,13 +10,15 @@ struct CollisionResult {
     std::vector<Entity> collidedEntities;
 };
 
-class CollisionContext : public Singleton<CollisionContext> {
+class World;
+
+class CollisionContext {
   public:
-    CollisionContext(singleton);
+    CollisionContext(World* world);
     Rect2 GetCollisionRectangle(Entity entity);
     bool IsTargetCollisionEntityInExceptionList(Entity sourceEntity, Entity targetEntity);
 
   private:
+    World* world = nullptr;
     ComponentManager* componentManager = nullptr;
-
 };
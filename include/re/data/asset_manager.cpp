@@ -11,37 +11,59 @@ void AssetManager::LoadTexture(const std::string &id, const std::string &filePat
     }
     Texture *texture = new Texture(filePath.c_str(), wrapS, wrapT, filterMin, filterMag);
     assert(texture->IsValid() && "Failed to load texture!");
+    std::lock_guard<std::mutex> texturesLock(texturesMutex);
     textures.emplace(id, texture);
 }
 
 Texture *AssetManager::GetTexture(const std::string &id) {
-    if (!HasTexture(id)) {
+    std::lock_guard<std::mutex> texturesLock(texturesMutex);
+    const auto it = textures.find(id);
+    if (it == textures.end()) {
         logger->Error("texture id = '%s'", id.c_str());
     }
-    assert(HasTexture(id) && "Failed to get texture!");
-    return textures[id];
+    assert(it != textures.end() && "Failed to get texture!");
+    return it->second;
 }
 
 bool AssetManager::HasTexture(const std::string &id) const {
+    std::lock_guard<std::mutex> texturesLock(texturesMutex);
     return textures.count(id) > 0;
 }
 
-void AssetManager::LoadFont(const std::string &fontId, const std::string &fontPath, int size) {
+void AssetManager::LoadFont(const std::string &fontId, const std::string &fontPath, int size, const GlyphCacheSettings &glyphCacheSettings,
+                            FontRenderMode renderMode) {
     if (HasFont(fontId)) {
         logger->Warn("Already have font, not loading!");
         return;
     }
-    Font *font = new Font(renderContext->freeTypeLibrary, fontPath.c_str(), size);
+    // Other sizes of a distance field font reuse its glyphs instead of loading the file again
+    const auto distanceFieldFontIt = distanceFieldFonts.find(fontPath);
+    if (renderMode == FontRenderMode::DistanceField && distanceFieldFontIt != distanceFieldFonts.end()) {
+        Font *font = new Font(*distanceFieldFontIt->second, size);
+        std::lock_guard<std::mutex> fontsLock(fontsMutex);
+        fonts.emplace(fontId, font);
+        return;
+    }
+    Font *font = new Font(renderContext->freeTypeLibrary, fontPath.c_str(), size, glyphCacheSettings, renderMode);
     assert(font->IsValid() && "Failed to load font!");
-    fonts.emplace(fontId, font);
+    {
+        std::lock_guard<std::mutex> fontsLock(fontsMutex);
+        fonts.emplace(fontId, font);
+    }
+    if (renderMode == FontRenderMode::DistanceField) {
+        distanceFieldFonts.emplace(fontPath, font);
+    }
 }
 
 Font *AssetManager::GetFont(const std::string &fontId) {
-    assert(HasFont(fontId) && "Failed to get font!");
-    return fonts[fontId];
+    std::lock_guard<std::mutex> fontsLock(fontsMutex);
+    const auto it = fonts.find(fontId);
+    assert(it != fonts.end() && "Failed to get font!");
+    return it->second;
 }
 
 bool AssetManager::HasFont(const std::string &fontId) const {
+    std::lock_guard<std::mutex> fontsLock(fontsMutex);
     return fonts.count(fontId) > 0;
 }
 
@@ -88,16 +110,17 @@ std::unordered_map<std::string, SoundEffect *> AssetManager::GetAllSounds() {
 }
 
 void AssetManager::LoadProjectConfigurations(AssetConfigurations assetConfigurations) {
-    for (TextureConfiguration textureConfiguration : assetConfigurations.textureConfigurations) {
-        LoadTexture(textureConfiguration.filePath,
-                    textureConfiguration.filePath,
-                    textureConfiguration.wrapS,
-                    textureConfiguration.wrapT,
-                    textureConfiguration.filterMin,
-                    textureConfiguration.filterMag);
-    }
+    LoadProjectTextures(assetConfigurations);
+    const GlyphCacheConfiguration &glyphCacheConfiguration = assetConfigurations.glyphCacheConfiguration;
+    GlyphCacheSettings glyphCacheSettings;
+    glyphCacheSettings.pageSize = glyphCacheConfiguration.pageSize;
+    glyphCacheSettings.maxPages = glyphCacheConfiguration.maxPages;
     for (FontConfiguration fontConfiguration : assetConfigurations.fontConfigurations) {
-        LoadFont(fontConfiguration.uid, fontConfiguration.filePath, fontConfiguration.size);
+        LoadFont(fontConfiguration.uid,
+                 fontConfiguration.filePath,
+                 fontConfiguration.size,
+                 glyphCacheSettings,
+                 fontConfiguration.distanceField ? FontRenderMode::DistanceField : FontRenderMode::Bitmap);
     }
     for (MusicConfiguration musicConfiguration : assetConfigurations.musicConfigurations) {
         LoadMusic(musicConfiguration.filePath, musicConfiguration.filePath);
@@ -106,3 +129,47 @@ void AssetManager::LoadProjectConfigurations(AssetConfigurations assetConfigurat
         LoadSound(soundConfiguration.filePath, soundConfiguration.filePath);
     }
 }
+
+// Textures that can't share a page (repeating or larger than a page) and textures loaded later stay standalone
+void AssetManager::LoadProjectTextures(const AssetConfigurations &assetConfigurations) {
+    const TextureAtlasConfiguration &atlasConfiguration = assetConfigurations.textureAtlasConfiguration;
+    // Pages are final once built, so only the first set of project textures is packed
+    const bool isPackingTextures = atlasConfiguration.enabled && !textureAtlas;
+    if (isPackingTextures) {
+        TextureAtlasSettings atlasSettings;
+        atlasSettings.pageSize = atlasConfiguration.pageSize;
+        atlasSettings.padding = atlasConfiguration.padding;
+        textureAtlas = new TextureAtlas(atlasSettings);
+    }
+    for (const TextureConfiguration &textureConfiguration : assetConfigurations.textureConfigurations) {
+        if (HasTexture(textureConfiguration.filePath)) {
+            logger->Warn("Already have texture, not loading...");
+            continue;
+        }
+        if (isPackingTextures
+                && textureAtlas->AddImageFile(textureConfiguration.filePath,
+                                              textureConfiguration.filePath,
+                                              textureConfiguration.wrapS,
+                                              textureConfiguration.wrapT,
+                                              textureConfiguration.filterMin,
+                                              textureConfiguration.filterMag)) {
+            continue;
+        }
+        LoadTexture(textureConfiguration.filePath,
+                    textureConfiguration.filePath,
+                    textureConfiguration.wrapS,
+                    textureConfiguration.wrapT,
+                    textureConfiguration.filterMin,
+                    textureConfiguration.filterMag);
+    }
+    if (isPackingTextures) {
+        const auto regionTextures = textureAtlas->Build();
+        std::lock_guard<std::mutex> texturesLock(texturesMutex);
+        for (const auto &regionTexture : regionTextures) {
+            textures.emplace(regionTexture.first, regionTexture.second);
+        }
+        logger->Debug("Packed %zu of %zu textures into %zu atlas pages, %.0f%% of page pixels used",
+                      textureAtlas->GetImageCount(), assetConfigurations.textureConfigurations.size(),
+                      textureAtlas->GetPageCount(), textureAtlas->GetPageUsage() * 100.0f);
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "../utils/singleton.h"
 
+#include <mutex>
 #include <unordered_map>
 #include <string>
 
@@ -9,9 +10,12 @@
 #include "../utils/logger.h"
 #include "re/project_properties.h"
 #include "../rendering/texture.h"
+#include "../rendering/texture_atlas.h"
 #include "../rendering/font.h"
 #include "../rendering/render_context.h"
 
+// Shared by every world.  Assets are loaded on the main thread, textures and fonts can be looked up from any thread
+// since scenes are parsed on worker threads and worlds can update on their own threads.
 class AssetManager : public Singleton<AssetManager> {
   public:
     AssetManager(singleton);
@@ -20,7 +24,8 @@ class AssetManager : public Singleton<AssetManager> {
     Texture* GetTexture(const std::string &id);
     bool HasTexture(const std::string &id) const;
     // Font
-    void LoadFont(const std::string &fontId, const std::string &fontPath, int size);
+    void LoadFont(const std::string &fontId, const std::string &fontPath, int size, const GlyphCacheSettings &glyphCacheSettings = GlyphCacheSettings(),
+                  FontRenderMode renderMode = FontRenderMode::Bitmap);
     Font* GetFont(const std::string &fontId);
     bool HasFont(const std::string &fontId) const;
     // Music
@@ -36,10 +41,15 @@ class AssetManager : public Singleton<AssetManager> {
     void LoadProjectConfigurations(AssetConfigurations assetConfigurations);
 
   private:
+    void LoadProjectTextures(const AssetConfigurations &assetConfigurations);
+    mutable std::mutex texturesMutex;
+    mutable std::mutex fontsMutex;
     std::unordered_map<std::string, Texture*> textures;
     std::unordered_map<std::string, Font*> fonts;
+    std::unordered_map<std::string, Font*> distanceFieldFonts; // First distance field font loaded from each file
     std::unordered_map<std::string, Music*> music;
     std::unordered_map<std::string, SoundEffect*> soundEffects;
+    TextureAtlas *textureAtlas = nullptr; // Owns the pages of the project's packed textures
     RenderContext *renderContext = nullptr;
     Logger *logger = nullptr;
 };
@@ -9,3 +9,9 @@ const float DELTA_TIME = 0.01f;
 const Uint32 MAX_FRAME_TIME = 250;
 }
 }
+
+namespace ECS {
+const unsigned int COMPONENT_REORDER_ENTITY_BUDGET = 256; // Entities laid out per frame by the component reorder pass
+const float SCENE_COMMIT_BUDGET_MILLISECONDS = 4.0f; // Time per frame spent creating entities of a loading scene
+const float WORLD_STREAMING_COMMIT_BUDGET_MILLISECONDS = 2.0f; // Time per frame spent creating entities of streamed world cells
+}
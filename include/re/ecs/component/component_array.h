@@ -1,6 +1,8 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
+#include <algorithm>
+#include <vector>
 #include <cassert>
 
 #include "../entity/entity.h"
@@ -10,66 +12,176 @@ class IComponentArray {
   public:
     virtual ~IComponentArray() = default;
     virtual void EntityDestroyed(Entity entity) = 0;
+    virtual void EntitiesDestroyed(const std::vector<Entity>& entities) = 0;
+    virtual void AllEntitiesDestroyed() = 0;
+    virtual void ReorderToEntityOrder(const std::vector<Entity>& entityOrder, size_t orderBegin, size_t orderEnd) = 0;
+    virtual void ResetReorder() = 0;
+    // True when a removal moved an unplaced component into the placed prefix since the pass started
+    virtual bool IsReorderInterrupted() const = 0;
 };
 
 template<typename T>
 class ComponentArray : public IComponentArray {
   public:
     void InsertNewData(Entity entity, T component) {
-        assert(entityToIndexMap.find(entity) == entityToIndexMap.end() && "Component added to same entity more than once!");
+        assert(!HasData(entity) && "Component added to same entity more than once!");
 
         size_t newIndex = size;
-        entityToIndexMap[entity] = newIndex;
-        indexToEntityMap[newIndex] = entity;
+        entityToIndex[entity] = newIndex;
+        indexToEntity[newIndex] = entity;
         components[newIndex] = component;
 
         size++;
     }
 
     void UpdateData(Entity entity, T component) {
-        assert(entityToIndexMap.find(entity) != entityToIndexMap.end() && "Component hasn't been added!");
+        assert(HasData(entity) && "Component hasn't been added!");
 
-        components[entityToIndexMap[entity]] = component;
+        components[entityToIndex[entity]] = component;
     }
 
     void RemoveData(Entity entity) {
-        assert(entityToIndexMap.find(entity) != entityToIndexMap.end() && "Removing non-existent component!");
+        assert(HasData(entity) && "Removing non-existent component!");
 
         // Copy element at end into deleted element's place to maintain array density
-        size_t indexOfRemovedEntity = entityToIndexMap[entity];
+        size_t indexOfRemovedEntity = entityToIndex[entity];
         size_t indexOfLastElement = size - 1;
+        if (indexOfRemovedEntity < reorderWriteIndex) {
+            isReorderInterrupted = true;
+        }
         components[indexOfRemovedEntity] = components[indexOfLastElement];
 
-        // Update map to point to moved spot
-        Entity entityOfLastElement = indexToEntityMap[indexOfLastElement];
-        entityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
-        indexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
-
-        entityToIndexMap.erase(entity);
-        indexToEntityMap.erase(indexOfLastElement);
+        // Update indices to point to moved spot
+        Entity entityOfLastElement = indexToEntity[indexOfLastElement];
+        entityToIndex[entityOfLastElement] = indexOfRemovedEntity;
+        indexToEntity[indexOfRemovedEntity] = entityOfLastElement;
 
         size--;
     }
 
     T& GetData(Entity entity) {
-        assert(entityToIndexMap.find(entity) != entityToIndexMap.end() && "Retrieving non-existent component!");
+        assert(HasData(entity) && "Retrieving non-existent component!");
 
-        return components[entityToIndexMap[entity]];
+        return components[entityToIndex[entity]];
     }
 
+    // Index is only trusted if the dense slot points back at the entity, so stale indices never need clearing
     bool HasData(Entity entity) {
-        return entityToIndexMap.find(entity) != entityToIndexMap.end();
+        const size_t index = entityToIndex[entity];
+        return index < size && indexToEntity[index] == entity;
     }
 
     void EntityDestroyed(Entity entity) override {
-        if (entityToIndexMap.find(entity) != entityToIndexMap.end()) {
+        if (HasData(entity)) {
             RemoveData(entity);
         }
     }
 
+    // Large batches close their holes in one sequential pass that keeps the remaining components in order, so a layout
+    // made by 'ReorderToEntityOrder' survives.  Small batches in a large array fall back to moving the last element in.
+    void EntitiesDestroyed(const std::vector<Entity>& entities) override {
+        size_t removedCount = 0;
+        size_t firstHoleIndex = size;
+        for (Entity entity : entities) {
+            if (HasData(entity)) {
+                removedCount++;
+                firstHoleIndex = std::min(firstHoleIndex, entityToIndex[entity]);
+            }
+        }
+        if (removedCount == 0) {
+            return;
+        }
+        if ((size - firstHoleIndex) > removedCount * COMPACT_MOVES_PER_REMOVAL) {
+            for (Entity entity : entities) {
+                if (HasData(entity)) {
+                    RemoveData(entity);
+                }
+            }
+            return;
+        }
+        for (Entity entity : entities) {
+            if (HasData(entity)) {
+                indexToEntity[entityToIndex[entity]] = NULL_ENTITY;
+            }
+        }
+        size_t writeIndex = firstHoleIndex;
+        size_t newReorderWriteIndex = reorderWriteIndex;
+        for (size_t readIndex = firstHoleIndex; readIndex < size; readIndex++) {
+            if (readIndex == reorderWriteIndex) {
+                newReorderWriteIndex = writeIndex;
+            }
+            const Entity entity = indexToEntity[readIndex];
+            if (entity == NULL_ENTITY) {
+                continue;
+            }
+            components[writeIndex] = std::move(components[readIndex]);
+            indexToEntity[writeIndex] = entity;
+            entityToIndex[entity] = writeIndex;
+            writeIndex++;
+        }
+        if (reorderWriteIndex >= size) {
+            newReorderWriteIndex = writeIndex;
+        }
+        reorderWriteIndex = newReorderWriteIndex;
+        size = writeIndex;
+    }
+
+    // Components are left in place and overwritten as new ones are added, so clearing doesn't depend on the entity count
+    void AllEntitiesDestroyed() override {
+        size = 0;
+        ResetReorder();
+    }
+
+    // Moves the components of entityOrder[orderBegin, orderEnd) into consecutive dense slots.  Passes start at orderBegin == 0
+    // and are continued by later calls, so a full reorder can be spread across frames.
+    void ReorderToEntityOrder(const std::vector<Entity>& entityOrder, size_t orderBegin, size_t orderEnd) override {
+        if (orderBegin == 0) {
+            ResetReorder();
+        }
+        for (size_t i = orderBegin; i < orderEnd && reorderWriteIndex < size; i++) {
+            const Entity entity = entityOrder[i];
+            if (!HasData(entity)) {
+                continue;
+            }
+            if (entityToIndex[entity] < reorderWriteIndex) {
+                // Already placed this pass (entity listed more than once)
+                continue;
+            }
+            SwapData(entityToIndex[entity], reorderWriteIndex);
+            reorderWriteIndex++;
+        }
+    }
+
+    void ResetReorder() override {
+        reorderWriteIndex = 0;
+        isReorderInterrupted = false;
+    }
+
+    bool IsReorderInterrupted() const override {
+        return isReorderInterrupted;
+    }
+
   private:
+    // Sequential moves are cheap next to the scattered writes of removing one entity at a time
+    static const size_t COMPACT_MOVES_PER_REMOVAL = 8;
+
     std::array<T, MAX_ENTITIES> components;
-    std::unordered_map<Entity, size_t> entityToIndexMap;
-    std::unordered_map<size_t, Entity> indexToEntityMap;
+    std::array<size_t, MAX_ENTITIES> entityToIndex{};
+    std::array<Entity, MAX_ENTITIES> indexToEntity{};
     size_t size = 0;
+    size_t reorderWriteIndex = 0;
+    bool isReorderInterrupted = false;
+
+    void SwapData(size_t indexA, size_t indexB) {
+        if (indexA == indexB) {
+            return;
+        }
+        std::swap(components[indexA], components[indexB]);
+        const Entity entityA = indexToEntity[indexA];
+        const Entity entityB = indexToEntity[indexB];
+        indexToEntity[indexA] = entityB;
+        indexToEntity[indexB] = entityA;
+        entityToIndex[entityA] = indexB;
+        entityToIndex[entityB] = indexA;
+    }
 };
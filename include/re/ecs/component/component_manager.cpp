@@ -1,8 +1,60 @@
 #include "component_manager.h"
 
+#include <algorithm>
+
+ComponentManager::~ComponentManager() {
+    for (auto const &pair : componentArrays) {
+        delete pair.second;
+    }
+}
+
 void ComponentManager::EntityDestroyed(Entity entity) {
     for (auto const &pair : componentArrays) {
         auto const &component = pair.second;
         component->EntityDestroyed(entity);
     }
 }
+
+void ComponentManager::EntitiesDestroyed(const std::vector<Entity>& entities) {
+    for (auto const &pair : componentArrays) {
+        auto const &component = pair.second;
+        component->EntitiesDestroyed(entities);
+    }
+}
+
+void ComponentManager::AllEntitiesDestroyed() {
+    for (auto const &pair : componentArrays) {
+        auto const &component = pair.second;
+        component->AllEntitiesDestroyed();
+    }
+    reorderCursor = 0;
+}
+
+bool ComponentManager::ReorderComponentArrays(const std::vector<Entity>& entityOrder, unsigned int entityBudget) {
+    // Components swapped into the placed prefix by a removal would be skipped, so the pass starts over
+    for (auto const &pair : componentArrays) {
+        if (reorderCursor > 0 && pair.second->IsReorderInterrupted()) {
+            ResetReorder();
+            break;
+        }
+    }
+    const size_t budget = entityBudget > 0 ? entityBudget : entityOrder.size();
+    const size_t orderEnd = std::min(reorderCursor + budget, entityOrder.size());
+    for (auto const &pair : componentArrays) {
+        auto const &component = pair.second;
+        component->ReorderToEntityOrder(entityOrder, reorderCursor, orderEnd);
+    }
+    reorderCursor = orderEnd;
+    if (reorderCursor >= entityOrder.size()) {
+        reorderCursor = 0;
+        return true;
+    }
+    return false;
+}
+
+void ComponentManager::ResetReorder() {
+    reorderCursor = 0;
+    for (auto const &pair : componentArrays) {
+        pair.second->ResetReorder();
+    }
+}
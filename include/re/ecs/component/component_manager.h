@@ -14,6 +14,7 @@ class ComponentManager : public Singleton<ComponentManager> {
     std::unordered_map<const char*, ComponentType> componentTypes;
     std::unordered_map<const char*, IComponentArray*> componentArrays;
     unsigned int componentIndex = 0;
+    size_t reorderCursor = 0;
 
     template<typename T>
     ComponentArray<T>* GetComponentArray() {
@@ -25,7 +26,9 @@ class ComponentManager : public Singleton<ComponentManager> {
     }
 
   public:
+    ComponentManager() = default;
     ComponentManager(singleton) {}
+    ~ComponentManager();
 
     template<typename T>
     void RegisterComponent() {
@@ -70,7 +73,7 @@ class ComponentManager : public Singleton<ComponentManager> {
     }
 
     template<typename T>
-    T& GetComponentDefault(Entity entity, T defaultComponent) {
+    T GetComponentDefault(Entity entity, const T& defaultComponent) {
         if (HasComponent<T>(entity)) {
             return GetComponentArray<T>()->GetData(entity);
         }
@@ -83,4 +86,11 @@ class ComponentManager : public Singleton<ComponentManager> {
     }
 
     void EntityDestroyed(Entity entity);
+    // One call per component array instead of one per entity and array
+    void EntitiesDestroyed(const std::vector<Entity>& entities);
+    void AllEntitiesDestroyed();
+    // Returns true once every array has been reordered to match 'entityOrder'
+    bool ReorderComponentArrays(const std::vector<Entity>& entityOrder, unsigned int entityBudget);
+    // Abandons a reorder pass in flight, the next call starts over from the beginning of its order
+    void ResetReorder();
 };
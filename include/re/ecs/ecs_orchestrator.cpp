@@ -1,17 +1,31 @@
 #include "ecs_orchestrator.h"
 
-ECSOrchestrator::ECSOrchestrator(singleton) :
-    ecSystemManager(new ECSystemManager()),
-    entityManager(EntityManager::GetInstance()),
-    componentManager(ComponentManager::GetInstance()),
-    sceneManager(SceneManager::GetInstance()) {}
+#include <algorithm>
+
+#include "component/components/transform2d_component.h"
+#include "../project_properties.h"
+
+ECSOrchestrator::ECSOrchestrator(World* world) :
+    world(world),
+    ecSystemManager(new ECSystemManager(world)),
+    entityManager(world->GetEntityManager()),
+    componentManager(world->GetComponentManager()),
+    sceneManager(world->GetSceneManager()) {}
+
+ECSOrchestrator::ECSOrchestrator(singleton) : ECSOrchestrator(World::GetInstance()) {}
 
 ECSOrchestrator::~ECSOrchestrator() {
     if (ecSystemManager) {
         delete ecSystemManager;
     }
-    if (entityManager) {
-        delete entityManager;
+    if (transformPropagator) {
+        delete transformPropagator;
+    }
+    if (sceneHotReloader) {
+        delete sceneHotReloader;
+    }
+    if (worldStreamer) {
+        delete worldStreamer;
     }
 }
 
@@ -23,18 +37,71 @@ void ECSOrchestrator::RefreshEntitySignatureChanged(Entity entity) {
     ecSystemManager->EntitySignatureChanged(entity, entityManager->GetEnabledSignature(entity));
 }
 
+void ECSOrchestrator::MarkWorldTransformDirty(Entity entity) {
+    if (sceneManager->HasCurrentScene()) {
+        Scene* currentScene = sceneManager->GetCurrentScene();
+        currentScene->worldTransforms.MarkDirty(entity, currentScene->hierarchy);
+    }
+}
+
 void ECSOrchestrator::PrepareSceneChange(const std::string& filePath) {
     sceneToChangeFilePath = filePath;
     shouldDestroySceneNextFrame = true;
 }
 
+void ECSOrchestrator::PrepareSceneChangeAsync(const std::string& filePath) {
+    PrepareSceneChange(filePath);
+    sceneManager->StartSceneLoad(filePath);
+}
+
+bool ECSOrchestrator::UpdateSceneLoading(float timeBudgetMilliseconds) {
+    // Loaded entities are only created once the old scene is gone, otherwise its teardown would release them
+    if (shouldDestroySceneNextFrame) {
+        return false;
+    }
+    if (!sceneManager->IsLoadingScene()) {
+        return true;
+    }
+    return sceneManager->CommitSceneLoad(timeBudgetMilliseconds);
+}
+
+bool ECSOrchestrator::IsLoadingScene() const {
+    return sceneManager->IsLoadingScene();
+}
+
+float ECSOrchestrator::GetSceneLoadingProgress() const {
+    return sceneManager->GetSceneLoadProgress();
+}
+
 void ECSOrchestrator::ChangeToScene() {
-    sceneManager->ChangeToScene(sceneToChangeFilePath);
+    if (sceneManager->IsLoadingScene()) {
+        sceneManager->ChangeToLoadedScene();
+    } else {
+        sceneManager->ChangeToScene(sceneToChangeFilePath);
+    }
+    currentSceneFilePath = sceneToChangeFilePath;
     sceneToChangeFilePath.clear();
 }
 
+// Every entity belongs to the current scene, so teardown resets each store in bulk instead of destroying entities one
+// at a time.  Dense arrays keep their capacity for the next scene.
 void ECSOrchestrator::DestroyScene() {
     shouldDestroySceneNextFrame = false;
+    if (sceneManager->HasCurrentScene()) {
+        ecSystemManager->OnSceneEndSystems(sceneManager->GetCurrentScene());
+    }
+    ecSystemManager->AllEntitiesDestroyed();
+    componentManager->AllEntitiesDestroyed();
+    entityManager->DestroyAllEntities();
+    sceneManager->DestroyCurrentScene();
+    entitiesQueuedForDeletion.clear();
+    componentReorderEntityOrder.clear();
+    if (transformPropagator) {
+        transformPropagator->Reset();
+    }
+    if (worldStreamer) {
+        worldStreamer->Reset();
+    }
 }
 
 bool ECSOrchestrator::HasSceneToCreate() const {
@@ -45,17 +112,76 @@ bool ECSOrchestrator::HasSceneToDestroy() const {
     return shouldDestroySceneNextFrame;
 }
 
+void ECSOrchestrator::UpdateSceneHotReload() {
+    if (!sceneManager->HasCurrentScene() || currentSceneFilePath.empty()) {
+        return;
+    }
+    if (!sceneHotReloader) {
+        sceneHotReloader = new SceneHotReloader(entityManager, componentManager);
+    }
+    if (sceneHotReloader->GetSceneFilePath() != currentSceneFilePath) {
+        sceneHotReloader->Watch(currentSceneFilePath);
+        return;
+    }
+    SceneReloadChanges changes;
+    if (!sceneHotReloader->Update(sceneManager->GetCurrentScene(), changes)) {
+        return;
+    }
+    for (Entity entity : changes.createdEntities) {
+        RefreshEntitySignatureChanged(entity);
+        ecSystemManager->OnEntityTagsUpdatedSystems(entity, {}, componentManager->GetComponent<SceneComponent>(entity).tags);
+    }
+    for (const UpdatedSceneNode& updatedNode : changes.updatedNodes) {
+        RefreshEntitySignatureChanged(updatedNode.entity);
+        const SceneComponent& sceneComponent = componentManager->GetComponent<SceneComponent>(updatedNode.entity);
+        ecSystemManager->OnEntityTagsUpdatedSystems(updatedNode.entity, updatedNode.previousTags, sceneComponent.tags);
+    }
+    for (Entity entity : changes.deletedEntities) {
+        DestroyEntity(entity);
+    }
+    Logger::GetInstance()->Debug("Reloaded scene '%s', %d created %d updated %d deleted", currentSceneFilePath.c_str(),
+                                 static_cast<int>(changes.createdEntities.size()), static_cast<int>(changes.updatedNodes.size()), static_cast<int>(changes.deletedEntities.size()));
+}
+
+void ECSOrchestrator::StartWorldStreaming(const std::string& worldFilePath) {
+    if (!worldStreamer) {
+        worldStreamer = new WorldStreamer(entityManager, componentManager);
+    }
+    worldStreamer->LoadWorldFile(worldFilePath);
+}
+
+void ECSOrchestrator::UpdateWorldStreaming(float commitBudgetMilliseconds) {
+    if (!worldStreamer || !sceneManager->HasCurrentScene() || shouldDestroySceneNextFrame) {
+        return;
+    }
+    WorldStreamingChanges changes;
+    if (!worldStreamer->Update(sceneManager->GetCurrentScene(), GetCameraCenter(), commitBudgetMilliseconds, changes)) {
+        return;
+    }
+    for (Entity cellRootEntity : changes.unloadedCellRootEntities) {
+        DestroySubtree(cellRootEntity);
+    }
+    for (Entity entity : changes.createdEntities) {
+        RefreshEntitySignatureChanged(entity);
+        ecSystemManager->OnEntityTagsUpdatedSystems(entity, {}, componentManager->GetComponent<SceneComponent>(entity).tags);
+    }
+}
+
+// World position at the center of the screen
+Vector2 ECSOrchestrator::GetCameraCenter() const {
+    const Camera2D camera = world->GetCameraManager()->GetCurrentCamera();
+    const ProjectProperties* projectProperties = ProjectProperties::GetInstance();
+    const Vector2 screenSize = Vector2(static_cast<float>(projectProperties->GetWindowWidth()), static_cast<float>(projectProperties->GetWindowHeight()));
+    return camera.viewport - camera.offset + screenSize * 0.5f / camera.zoom;
+}
+
 void ECSOrchestrator::RegisterLoadedSceneNodeComponents() {
     Scene* currentScene = sceneManager->GetCurrentScene();
-    const std::function<void(const SceneNode& sceneNode)> registerNodeFunc = [this, &registerNodeFunc](const SceneNode& sceneNode) {
-        RefreshEntitySignatureChanged(sceneNode.entity);
-        SceneComponent sceneComponent = componentManager->GetComponentDefault<SceneComponent>(sceneNode.entity, {});
-        ecSystemManager->OnEntityTagsUpdatedSystems(sceneNode.entity, {}, sceneComponent.tags);
-        for (const SceneNode& childNode : sceneNode.children) {
-            registerNodeFunc(childNode);
-        }
-    };
-    registerNodeFunc(currentScene->rootNode);
+    currentScene->hierarchy.TraverseDepthFirst(currentScene->rootEntity, [this](Entity entity) {
+        RefreshEntitySignatureChanged(entity);
+        SceneComponent sceneComponent = componentManager->GetComponentDefault<SceneComponent>(entity, {});
+        ecSystemManager->OnEntityTagsUpdatedSystems(entity, {}, sceneComponent.tags);
+    });
 }
 
 void ECSOrchestrator::AddRootNode(Entity rootEntity) {
@@ -91,10 +217,84 @@ void ECSOrchestrator::DestroyEntity(Entity entity) {
     componentManager->EntityDestroyed(entity);
 }
 
+void ECSOrchestrator::DestroySubtree(Entity entity) {
+    destroyedSubtreeEntities.clear();
+    sceneManager->DeleteSubtree(entity, destroyedSubtreeEntities);
+    entityManager->DestroyEntities(destroyedSubtreeEntities);
+    ecSystemManager->EntitiesDestroyed(destroyedSubtreeEntities, [this](Entity destroyedEntity) -> const std::vector<std::string>& {
+        static const std::vector<std::string> noTags;
+        return componentManager->HasComponent<SceneComponent>(destroyedEntity) ? componentManager->GetComponent<SceneComponent>(destroyedEntity).tags : noTags;
+    });
+    componentManager->EntitiesDestroyed(destroyedSubtreeEntities);
+}
+
+void ECSOrchestrator::RefreshWorldTransforms() {
+    if (!sceneManager->HasCurrentScene()) {
+        return;
+    }
+    Scene* currentScene = sceneManager->GetCurrentScene();
+    if (currentScene->hierarchy.GetNodeCount() < TransformPropagator::BATCHED_NODE_THRESHOLD) {
+        currentScene->worldTransforms.Refresh(currentScene->hierarchy, componentManager);
+        return;
+    }
+    if (!transformPropagator) {
+        transformPropagator = new TransformPropagator();
+    }
+    currentScene->worldTransforms.RefreshBatched(currentScene->hierarchy, componentManager, *transformPropagator);
+}
+
+void ECSOrchestrator::SetComponentOrderKey(ComponentOrderKey orderKey) {
+    componentOrderKey = orderKey;
+    componentReorderEntityOrder.clear();
+    componentManager->ResetReorder();
+}
+
+void ECSOrchestrator::ReorderComponents(unsigned int entityBudget) {
+    if (!sceneManager->HasCurrentScene()) {
+        return;
+    }
+    if (componentReorderEntityOrder.empty()) {
+        BuildComponentReorderEntityOrder();
+        if (componentReorderEntityOrder.empty()) {
+            return;
+        }
+    }
+    // Order is kept until the pass completes so every array is laid out against the same snapshot
+    if (componentManager->ReorderComponentArrays(componentReorderEntityOrder, entityBudget)) {
+        componentReorderEntityOrder.clear();
+    }
+}
+
+void ECSOrchestrator::BuildComponentReorderEntityOrder() {
+    componentReorderEntityOrder.clear();
+    const SceneHierarchy& hierarchy = sceneManager->GetCurrentScene()->hierarchy;
+    hierarchy.TraverseDepthFirst(NULL_ENTITY, [this](Entity entity) {
+        componentReorderEntityOrder.emplace_back(entity);
+    });
+
+    if (componentOrderKey == ComponentOrderKey::ENTITY_ID) {
+        std::sort(componentReorderEntityOrder.begin(), componentReorderEntityOrder.end());
+        return;
+    }
+
+    if (componentOrderKey == ComponentOrderKey::Z_INDEX) {
+        // Stable so nodes sharing a z index keep depth first order
+        std::stable_sort(componentReorderEntityOrder.begin(), componentReorderEntityOrder.end(), [this](Entity entityA, Entity entityB) {
+            const int zIndexA = componentManager->HasComponent<Transform2DComponent>(entityA) ? componentManager->GetComponent<Transform2DComponent>(entityA).zIndex : 0;
+            const int zIndexB = componentManager->HasComponent<Transform2DComponent>(entityB) ? componentManager->GetComponent<Transform2DComponent>(entityB).zIndex : 0;
+            return zIndexA < zIndexB;
+        });
+    }
+}
+
 bool ECSOrchestrator::IsNodeInScene(Entity entity) const {
     return sceneManager->IsNodeInScene(entity);
 }
 
+Entity ECSOrchestrator::GetNode(const std::string& nodePath) const {
+    return sceneManager->GetNode(nodePath);
+}
+
 Scene* ECSOrchestrator::GetCurrentScene() {
     return sceneManager->GetCurrentScene();
 }
@@ -103,11 +303,15 @@ void ECSOrchestrator::UpdateSystems(float deltaTime) {
     ecSystemManager->UpdateSystems(deltaTime);
 }
 
+// Only subtrees written since the last refresh are recomputed, so refreshing before physics and again before rendering
+// costs nothing when nothing moved in between
 void ECSOrchestrator::PhysicsUpdateSystems(float deltaTime) {
+    RefreshWorldTransforms();
     ecSystemManager->PhysicsUpdateSystems(deltaTime);
 }
 
 void ECSOrchestrator::RenderSystems() {
+    RefreshWorldTransforms();
     ecSystemManager->RenderSystems();
 }
 
@@ -2,17 +2,36 @@
 
 #include "../utils/singleton.h"
 
+#include <type_traits>
 #include <vector>
 
+#include "world.h"
 #include "system/ec_system_manager.h"
+#include "component/components/transform2d_component.h"
 #include "../scene/scene_manager.h"
+#include "../scene/scene_hot_reloader.h"
+#include "../scene/world_streamer.h"
+
+// Key used to lay out dense component arrays so cross array iteration is sequential
+enum class ComponentOrderKey : int {
+    ENTITY_ID = 0, // Order systems iterate their entity sets
+    SCENE_DEPTH_FIRST = 1,
+    Z_INDEX = 2,
+};
 
 class ECSOrchestrator : public Singleton<ECSOrchestrator> {
   public:
+    ECSOrchestrator(World* world);
     ECSOrchestrator(singleton);
     ~ECSOrchestrator();
 
+    World* GetWorld() const {
+        return world;
+    }
+
     void DestroyEntity(Entity entity);
+    // Destroys 'entity' with all of its descendants, systems and component arrays are notified once for the batch
+    void DestroySubtree(Entity entity);
     void DeleteEntitiesQueuedForDeletion();
 
     // Entity
@@ -34,11 +53,18 @@ class ECSOrchestrator : public Singleton<ECSOrchestrator> {
         entityManager->SetSignature(entity, signature);
         entityManager->SetEnabledSignature(entity, signature);
         RefreshEntitySignatureChanged(entity);
+        if (std::is_same<T, Transform2DComponent>::value) {
+            MarkWorldTransformDirty(entity);
+        }
     }
 
+    // Transforms have to be written through here, so world transforms cached by the scene are refreshed
     template<typename T>
     void UpdateComponent(Entity entity, T component) {
         componentManager->UpdateComponent(entity, component);
+        if (std::is_same<T, Transform2DComponent>::value) {
+            MarkWorldTransformDirty(entity);
+        }
     }
 
     template<typename T>
@@ -52,6 +78,9 @@ class ECSOrchestrator : public Singleton<ECSOrchestrator> {
         enabledSignature.set(componentManager->GetComponentType<T>(), false);
         entityManager->SetEnabledSignature(entity, enabledSignature);
         ecSystemManager->EntitySignatureChanged(entity, enabledSignature);
+        if (std::is_same<T, Transform2DComponent>::value) {
+            MarkWorldTransformDirty(entity);
+        }
     }
 
     template<typename T>
@@ -91,11 +120,17 @@ class ECSOrchestrator : public Singleton<ECSOrchestrator> {
         return componentManager->HasComponent<T>(entity);
     }
 
+    // Recomputes world transforms of the current scene's dirty subtrees in hierarchy order
+    void RefreshWorldTransforms();
+
+    void SetComponentOrderKey(ComponentOrderKey orderKey);
+    void ReorderComponents(unsigned int entityBudget);
+
 
     // EC System
     template<typename T>
-    T* RegisterSystem(ComponentSignature initialComponentSignature = {}, ECSystemRegistration ecSystemRegistration = ECSystemRegistration::NONE) {
-        T *system = ecSystemManager->RegisterSystem<T>(ecSystemRegistration);
+    T* RegisterSystem(ComponentSignature initialComponentSignature = {}, ECSystemRegistration ecSystemRegistration = ECSystemRegistration::NONE, const ECSystemTickSettings& tickSettings = {}) {
+        T *system = ecSystemManager->RegisterSystem<T>(ecSystemRegistration, tickSettings);
         SetSystemSignature<T>(initialComponentSignature);
         return system;
     }
@@ -110,6 +145,11 @@ class ECSOrchestrator : public Singleton<ECSOrchestrator> {
         return ecSystemManager->HasSystem<T>();
     }
 
+    template<typename T>
+    void SetSystemTickSettings(const ECSystemTickSettings& tickSettings) {
+        ecSystemManager->SetTickSettings<T>(tickSettings);
+    }
+
     template<typename T>
     void SetSystemSignature(ComponentSignature signature) {
         ecSystemManager->SetSignature<T>(signature);
@@ -129,10 +169,21 @@ class ECSOrchestrator : public Singleton<ECSOrchestrator> {
 
     // Scene
     void PrepareSceneChange(const std::string& filePath);
+    // Starts parsing 'filePath' on a background thread, entities are created by 'UpdateSceneLoading'
+    void PrepareSceneChangeAsync(const std::string& filePath);
+    // Creates loaded entities within the time budget, returns true once the scene can be changed to
+    bool UpdateSceneLoading(float timeBudgetMilliseconds);
+    bool IsLoadingScene() const;
+    float GetSceneLoadingProgress() const;
     void ChangeToScene();
     void DestroyScene();
     bool HasSceneToCreate() const;
     bool HasSceneToDestroy() const;
+    // Applies saves of the current scene's file to the running scene, call once per frame while iterating on content
+    void UpdateSceneHotReload();
+    // Streams cells of 'worldFilePath' into the current scene around the camera, kept across scene changes
+    void StartWorldStreaming(const std::string& worldFilePath);
+    void UpdateWorldStreaming(float commitBudgetMilliseconds);
 
     // Triggered when an entity enters a scene
     void RegisterLoadedSceneNodeComponents(); // From scene json
@@ -140,18 +191,30 @@ class ECSOrchestrator : public Singleton<ECSOrchestrator> {
     void AddChildNode(Entity child, Entity parent); // from script
 
     bool IsNodeInScene(Entity entity) const;
+    Entity GetNode(const std::string& nodePath) const;
     void QueueDestroyEntity(Entity entity);
     void DestroyQueuedEntities();
     Scene* GetCurrentScene();
 
   private:
+    World *world = nullptr;
     ECSystemManager *ecSystemManager = nullptr;
     EntityManager *entityManager = nullptr;
     ComponentManager *componentManager = nullptr;
     SceneManager *sceneManager = nullptr;
     std::string sceneToChangeFilePath;
+    std::string currentSceneFilePath;
     bool shouldDestroySceneNextFrame = false;
     std::vector<Entity> entitiesQueuedForDeletion;
+    std::vector<Entity> destroyedSubtreeEntities; // Reused across 'DestroySubtree' calls
+    ComponentOrderKey componentOrderKey = ComponentOrderKey::SCENE_DEPTH_FIRST;
+    std::vector<Entity> componentReorderEntityOrder;
+    TransformPropagator *transformPropagator = nullptr; // Created once a scene is large enough to batch
+    SceneHotReloader *sceneHotReloader = nullptr; // Created once hot reload is first used
+    WorldStreamer *worldStreamer = nullptr; // Created once a world is streamed
 
     void RefreshEntitySignatureChanged(Entity entity);
+    void MarkWorldTransformDirty(Entity entity);
+    void BuildComponentReorderEntityOrder();
+    Vector2 GetCameraCenter() const;
 };
@@ -1,5 +1,7 @@
 #include "entity_manager.h"
 
+#include <algorithm>
+
 Entity EntityManager::CreateEntity() {
     assert(livingEntityCounter < MAX_ENTITIES && "Too many entities to create!");
 
@@ -13,6 +15,11 @@ void EntityManager::DestroyEntity(Entity entity) {
     livingEntityCounter--;
 }
 
+void EntityManager::DestroyEntities(const std::vector<Entity>& entities) {
+    entitiesToDelete.insert(entitiesToDelete.end(), entities.begin(), entities.end());
+    livingEntityCounter -= static_cast<unsigned int>(entities.size());
+}
+
 void EntityManager::DeleteEntitiesQueuedForDeletion() {
     for (Entity entity : entitiesToDelete) {
         signatures[entity].reset();
@@ -22,6 +29,17 @@ void EntityManager::DeleteEntitiesQueuedForDeletion() {
     entitiesToDelete.clear();
 }
 
+void EntityManager::DestroyAllEntities() {
+    // Only ids below the counter were ever handed out
+    const size_t usedIdCount = std::min(static_cast<size_t>(entityIdCounter), signatures.size());
+    std::fill(signatures.begin(), signatures.begin() + usedIdCount, ComponentSignature());
+    std::fill(enabledSignatures.begin(), enabledSignatures.begin() + usedIdCount, ComponentSignature());
+    std::queue<Entity>().swap(availableEntityIds);
+    entitiesToDelete.clear();
+    entityIdCounter = 1;
+    livingEntityCounter = 0;
+}
+
 unsigned int EntityManager::GetAliveEntities() {
     return livingEntityCounter;
 }
@@ -13,10 +13,14 @@
 
 class EntityManager : public Singleton<EntityManager> {
   public:
+    EntityManager() = default;
     EntityManager(singleton) {}
     Entity CreateEntity();
     void DestroyEntity(Entity entity);
+    void DestroyEntities(const std::vector<Entity>& entities);
     void DeleteEntitiesQueuedForDeletion();
+    // Releases every entity at once, ids are handed out from 1 again
+    void DestroyAllEntities();
     unsigned int GetAliveEntities();
     void SetSignature(Entity entity, ComponentSignature signature);
     void SetEnabledSignature(Entity entity, ComponentSignature signature);
@@ -24,6 +24,10 @@ class EntityTagCache {
         }
     }
 
+    void Clear() {
+        entityTagCache.clear();
+    }
+
     bool HasTag(const std::string& tag) {
         return entityTagCache.count(tag) > 0;
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cmath>
 #include <set>
 
 #include "../entity/entity_tag_cache.h"
@@ -7,8 +8,18 @@
 
 const unsigned int MAX_SYSTEMS = 32;
 
+class World;
+
+struct ECSystemTickSettings {
+    float ticksPerSecond = 0.0f; // 0 ticks every frame
+    unsigned int entityBudget = 0; // Max entities processed per tick, 0 processes all of them
+};
+
 class ECSystem {
   public:
+    explicit ECSystem(World* world) : world(world) {}
+    virtual ~ECSystem() = default;
+
     virtual void Initialize()  {
         enabled = true;
     }
@@ -21,6 +32,19 @@ class ECSystem {
         entities.erase(entity);
     }
 
+    virtual void UnregisterEntities(const std::vector<Entity>& destroyedEntities) {
+        for (Entity entity : destroyedEntities) {
+            entities.erase(entity);
+        }
+    }
+
+    // Scene teardown, drops every entity without unregistering them one at a time
+    virtual void UnregisterAllEntities() {
+        entities.clear();
+        entityTagCache.Clear();
+        entitySliceCursor = NULL_ENTITY;
+    }
+
     virtual void Enable() {
         enabled = true;
     }
@@ -37,6 +61,26 @@ class ECSystem {
         return entities.count(entity) > 0;
     }
 
+    void SetTickSettings(const ECSystemTickSettings& settings) {
+        tickSettings = settings;
+        updateTimeAccumulator = 0.0f;
+        physicsUpdateTimeAccumulator = 0.0f;
+    }
+
+    ECSystemTickSettings GetTickSettings() const {
+        return tickSettings;
+    }
+
+    // Accumulates frame time and returns true once enough has passed to tick at the system's rate.
+    // 'tickDeltaTime' is set to the whole tick intervals accumulated since the last tick.
+    bool ConsumeUpdateTick(float deltaTime, float& tickDeltaTime) {
+        return ConsumeTick(updateTimeAccumulator, deltaTime, tickDeltaTime);
+    }
+
+    bool ConsumePhysicsUpdateTick(float deltaTime, float& tickDeltaTime) {
+        return ConsumeTick(physicsUpdateTimeAccumulator, deltaTime, tickDeltaTime);
+    }
+
     // Event hooks
     virtual void Update(float deltaTime) {}
     virtual void PhysicsUpdate(float deltaTime) {}
@@ -50,7 +94,51 @@ class ECSystem {
     virtual void OnEntityTagsRemoved(Entity entity, const std::vector<std::string>& tags) {}
 
   protected:
+    World* world = nullptr;
     bool enabled = false;
     std::set<Entity> entities;
     EntityTagCache entityTagCache;
+    ECSystemTickSettings tickSettings;
+
+    // Round-robins through entities, visiting at most 'entityBudget' per call and resuming after the last visited entity.
+    // 'func' must not register or unregister entities.
+    template<typename Func>
+    void ForEachEntityInSlice(Func func) {
+        if (tickSettings.entityBudget == 0 || tickSettings.entityBudget >= entities.size()) {
+            for (Entity entity : entities) {
+                func(entity);
+            }
+            return;
+        }
+        auto it = entities.upper_bound(entitySliceCursor);
+        for (unsigned int i = 0; i < tickSettings.entityBudget; i++) {
+            if (it == entities.end()) {
+                it = entities.begin();
+            }
+            entitySliceCursor = *it;
+            func(*it);
+            ++it;
+        }
+    }
+
+  private:
+    float updateTimeAccumulator = 0.0f;
+    float physicsUpdateTimeAccumulator = 0.0f;
+    Entity entitySliceCursor = NULL_ENTITY;
+
+    bool ConsumeTick(float& accumulator, float deltaTime, float& tickDeltaTime) {
+        if (tickSettings.ticksPerSecond <= 0.0f) {
+            tickDeltaTime = deltaTime;
+            return true;
+        }
+        const float tickInterval = 1.0f / tickSettings.ticksPerSecond;
+        accumulator += deltaTime;
+        if (accumulator < tickInterval) {
+            return false;
+        }
+        // A long frame is caught up in one tick, the part of an interval left over carries into the next tick
+        tickDeltaTime = std::floor(accumulator / tickInterval) * tickInterval;
+        accumulator -= tickDeltaTime;
+        return true;
+    }
 };
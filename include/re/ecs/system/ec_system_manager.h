@@ -6,6 +6,7 @@
 #include <unordered_map>
 
 #include "ec_system.h"
+#include "../world.h"
 #include "../component/component.h"
 #include "../../utils/logger.h"
 #include "../../utils/helper.h"
@@ -26,6 +27,7 @@ class ECSystemManager {
   private:
     std::unordered_map<const char*, ComponentSignature> signatures{};
     std::unordered_map<const char*, ECSystem*> systems{};
+    World *world = nullptr;
     std::vector<ECSystem*> updateSystems{};
     std::vector<ECSystem*> physicsUpdateSystems{};
     std::vector<ECSystem*> renderSystems{};
@@ -59,7 +61,14 @@ class ECSystemManager {
     }
 
   public:
-    ECSystemManager() : logger(Logger::GetInstance()) {}
+    ECSystemManager(World* world) : world(world), logger(Logger::GetInstance()) {}
+    ECSystemManager() : ECSystemManager(World::GetInstance()) {}
+
+    ~ECSystemManager() {
+        for (auto const& pair : systems) {
+            delete pair.second;
+        }
+    }
 
     template<typename T>
     T* GetSystem() {
@@ -69,13 +78,14 @@ class ECSystemManager {
     }
 
     template<typename T>
-    T* RegisterSystem(ECSystemRegistration ecSystemRegistration = ECSystemRegistration::NONE) {
+    T* RegisterSystem(ECSystemRegistration ecSystemRegistration = ECSystemRegistration::NONE, const ECSystemTickSettings& tickSettings = {}) {
         const char *typeName = typeid(T).name();
 
         assert(!HasSystem<T>() && "Registering system more than once.");
 
-        auto *system = new T();
+        auto *system = new T(world);
         system->Enable();
+        system->SetTickSettings(tickSettings);
         systems.insert({typeName, system});
         ProcessSystemRegistration(system, ecSystemRegistration);
         return system;
@@ -114,6 +124,11 @@ class ECSystemManager {
         }
     }
 
+    template<typename T>
+    void SetTickSettings(const ECSystemTickSettings& tickSettings) {
+        GetSystem<T>()->SetTickSettings(tickSettings);
+    }
+
     template<typename T>
     void SetSignature(ComponentSignature signature) {
         const char* typeName = typeid(T).name();
@@ -149,6 +164,30 @@ class ECSystemManager {
         }
     }
 
+    // Subtree teardown, each system is handed the whole batch once.  'getEntityTags' returns an entity's tags and is only
+    // called while its components are still alive.
+    template<typename TagsFunc>
+    void EntitiesDestroyed(const std::vector<Entity>& entities, TagsFunc getEntityTags) {
+        for (auto const& pair : systems) {
+            pair.second->UnregisterEntities(entities);
+        }
+        if (onEntityTagsUpdatedSystems.empty()) {
+            return;
+        }
+        for (Entity entity : entities) {
+            const std::vector<std::string>& tags = getEntityTags(entity);
+            for (ECSystem* entityTagUpdateSystem : onEntityTagsUpdatedSystems) {
+                entityTagUpdateSystem->OnEntityTagsRemoved(entity, tags);
+            }
+        }
+    }
+
+    void AllEntitiesDestroyed() {
+        for (auto const& pair : systems) {
+            pair.second->UnregisterAllEntities();
+        }
+    }
+
     void EntitySignatureChanged(Entity entity, ComponentSignature entitySignature) {
         // Notify each system that an entity's signature changed
         for (auto const& pair : systems) {
@@ -167,13 +206,19 @@ class ECSystemManager {
 
     void UpdateSystems(float deltaTime) {
         for (ECSystem* updateSystem : updateSystems) {
-            updateSystem->Update(deltaTime);
+            float tickDeltaTime = 0.0f;
+            if (updateSystem->ConsumeUpdateTick(deltaTime, tickDeltaTime)) {
+                updateSystem->Update(tickDeltaTime);
+            }
         }
     }
 
     void PhysicsUpdateSystems(float deltaTime) {
         for (ECSystem* physicsUpdateSystem : physicsUpdateSystems) {
-            physicsUpdateSystem->PhysicsUpdate(deltaTime);
+            float tickDeltaTime = 0.0f;
+            if (physicsUpdateSystem->ConsumePhysicsUpdateTick(deltaTime, tickDeltaTime)) {
+                physicsUpdateSystem->PhysicsUpdate(tickDeltaTime);
+            }
         }
     }
 
@@ -13,30 +13,20 @@ class AnimatedSpriteRenderingECSystem : public ECSystem {
     ComponentManager *componentManager = nullptr;
 
   public:
-    AnimatedSpriteRenderingECSystem() : renderer2D(Renderer2D::GetInstance()), componentManager(ComponentManager::GetInstance()) {}
+    AnimatedSpriteRenderingECSystem(World* world) : ECSystem(world), renderer2D(Renderer2D::GetInstance()), componentManager(world->GetComponentManager()) {}
 
     void Render() override {
         if (IsEnabled()) {
+            // Frame changes can be spread across frames with an entity budget, sprites keep drawing their current frame
+            ForEachEntityInSlice([this] (Entity entity) {
+                AdvanceAnimation(entity);
+            });
             for (Entity entity : entities) {
                 Transform2DComponent transform2DComponent = componentManager->GetComponent<Transform2DComponent>(entity);
                 AnimatedSpriteComponent animatedSpriteComponent = componentManager->GetComponent<AnimatedSpriteComponent>(entity);
-                // Process Animation
-                Animation& currentAnimation = animatedSpriteComponent.currentAnimation;
-                AnimationFrame currentFrame = currentAnimation.animationFrames[animatedSpriteComponent.currentFrameIndex];
-                if (animatedSpriteComponent.isPlaying) {
-                    unsigned int newIndex = static_cast<unsigned int>((SDL_GetTicks() / currentAnimation.speed) % currentAnimation.frames);
-                    if (newIndex != animatedSpriteComponent.currentFrameIndex) {
-                        // Index changed
-                        currentFrame = currentAnimation.animationFrames[newIndex];
-                        if (newIndex + 1 == currentAnimation.frames) {
-                            // Animation Finished
-                        }
-                        animatedSpriteComponent.currentFrameIndex = newIndex;
-                        componentManager->UpdateComponent(entity, animatedSpriteComponent);
-                    }
-                }
+                const AnimationFrame& currentFrame = animatedSpriteComponent.currentAnimation.animationFrames[animatedSpriteComponent.currentFrameIndex];
                 // Submit draw batch
-                Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity);
+                Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity, world);
                 Vector2 drawDestinationSize = Vector2(currentFrame.drawSource.w * translatedTransform.scale.x, currentFrame.drawSource.h * translatedTransform.scale.y);
                 Rect2 drawDestination = Rect2(translatedTransform.position, drawDestinationSize);
                 renderer2D->SubmitSpriteBatchItem(
@@ -52,4 +42,22 @@ class AnimatedSpriteRenderingECSystem : public ECSystem {
             }
         }
     }
+
+  private:
+    void AdvanceAnimation(Entity entity) {
+        AnimatedSpriteComponent animatedSpriteComponent = componentManager->GetComponent<AnimatedSpriteComponent>(entity);
+        if (!animatedSpriteComponent.isPlaying) {
+            return;
+        }
+        const Animation& currentAnimation = animatedSpriteComponent.currentAnimation;
+        unsigned int newIndex = static_cast<unsigned int>((SDL_GetTicks() / currentAnimation.speed) % currentAnimation.frames);
+        if (newIndex != animatedSpriteComponent.currentFrameIndex) {
+            // Index changed
+            if (newIndex + 1 == currentAnimation.frames) {
+                // Animation Finished
+            }
+            animatedSpriteComponent.currentFrameIndex = newIndex;
+            componentManager->UpdateComponent(entity, animatedSpriteComponent);
+        }
+    }
 };
@@ -11,10 +11,11 @@
 
 class CollisionECSystem : public ECSystem {
   public:
-    CollisionECSystem() :
-        collisionContext(CollisionContext::GetInstance()),
+    CollisionECSystem(World* world) :
+        ECSystem(world),
+        collisionContext(world->GetCollisionContext()),
         renderer2D(Renderer2D::GetInstance()),
-        componentManager(ComponentManager::GetInstance()) {
+        componentManager(world->GetComponentManager()) {
         collisionBaseTexture = new Texture(1, 1);
     }
     ~CollisionECSystem() {
@@ -26,7 +27,7 @@ class CollisionECSystem : public ECSystem {
     void Render() override {
         if (IsEnabled()) {
             for (Entity entity : entities) {
-                Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity);
+                Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity, world);
                 ColliderComponent colliderComponent = componentManager->GetComponent<ColliderComponent>(entity);
                 Vector2 drawDestinationSize = Vector2(colliderComponent.collider.w * translatedTransform.scale.x, colliderComponent.collider.h * translatedTransform.scale.y);
                 Rect2 drawDestination = Rect2(translatedTransform.position, drawDestinationSize);
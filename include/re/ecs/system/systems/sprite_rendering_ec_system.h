@@ -13,12 +13,12 @@ class SpriteRenderingECSystem : public ECSystem {
     ComponentManager *componentManager = nullptr;
 
   public:
-    SpriteRenderingECSystem() : renderer2D(Renderer2D::GetInstance()), componentManager(ComponentManager::GetInstance()) {}
+    SpriteRenderingECSystem(World* world) : ECSystem(world), renderer2D(Renderer2D::GetInstance()), componentManager(world->GetComponentManager()) {}
 
     void Render() override {
         if (IsEnabled()) {
             for (Entity entity : entities) {
-                Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity);
+                Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity, world);
                 SpriteComponent spriteComponent = componentManager->GetComponent<SpriteComponent>(entity);
                 Vector2 drawDestinationSize = Vector2(spriteComponent.drawSource.w * translatedTransform.scale.x, spriteComponent.drawSource.h * translatedTransform.scale.y);
                 spriteComponent.drawDestination = Rect2(translatedTransform.position, drawDestinationSize);
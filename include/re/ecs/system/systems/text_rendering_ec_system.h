@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "../ec_system.h"
 
 #include "../../../scene/scene_node_utils.h"
@@ -7,26 +9,46 @@
 #include "../../component/components/text_label_component.h"
 #include "../../../rendering/renderer_2d.h"
 
+// Labels keep their laid out glyphs between frames, a label is only laid out again when its font, text or scale changes
 class TextRenderingECSystem : public ECSystem {
   private:
     Renderer2D *renderer2D = nullptr;
     ComponentManager *componentManager = nullptr;
+    std::unordered_map<Entity, TextLayout> textLayouts;
 
   public:
-    TextRenderingECSystem() : renderer2D(Renderer2D::GetInstance()), componentManager(ComponentManager::GetInstance()) {}
+    TextRenderingECSystem(World* world) : ECSystem(world), renderer2D(Renderer2D::GetInstance()), componentManager(world->GetComponentManager()) {}
+
+    void UnregisterEntity(Entity entity) override {
+        ECSystem::UnregisterEntity(entity);
+        textLayouts.erase(entity);
+    }
+
+    void UnregisterEntities(const std::vector<Entity>& destroyedEntities) override {
+        ECSystem::UnregisterEntities(destroyedEntities);
+        for (Entity entity : destroyedEntities) {
+            textLayouts.erase(entity);
+        }
+    }
+
+    void UnregisterAllEntities() override {
+        ECSystem::UnregisterAllEntities();
+        textLayouts.clear();
+    }
 
     void Render() override {
         if (IsEnabled()) {
             for (Entity entity : entities) {
-                Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity);
-                TextLabelComponent textLabelComponent = componentManager->GetComponent<TextLabelComponent>(entity);
-                renderer2D->SubmitFontBatchItem(
-                    textLabelComponent.font,
-                    textLabelComponent.text,
+                Transform2DComponent translatedTransform = SceneNodeUtils::TranslateEntityTransformIntoWorld(entity, world);
+                const TextLabelComponent& textLabelComponent = componentManager->GetComponent<TextLabelComponent>(entity);
+                // Layouts are only read when the renderer flushes, later this frame
+                TextLayout& textLayout = textLayouts[entity];
+                FontRenderer::UpdateLayout(textLayout, textLabelComponent.font, textLabelComponent.text, translatedTransform.scale.x);
+                renderer2D->SubmitTextLayoutBatchItem(
+                    &textLayout,
                     translatedTransform.position.x,
                     translatedTransform.position.y,
                     translatedTransform.zIndex,
-                    translatedTransform.scale.x,
                     textLabelComponent.color
                 );
             }
@@ -0,0 +1,49 @@
+#include "world.h"
+
+World::World() :
+    entityManager(new EntityManager()),
+    componentManager(new ComponentManager()),
+    cameraManager(new CameraManager()),
+    ownsManagers(true) {
+    sceneManager = new SceneManager(entityManager, componentManager);
+    collisionContext = new CollisionContext(this);
+}
+
+World::World(singleton) :
+    entityManager(EntityManager::GetInstance()),
+    componentManager(ComponentManager::GetInstance()),
+    sceneManager(SceneManager::GetInstance()),
+    cameraManager(CameraManager::GetInstance()),
+    ownsManagers(false) {
+    collisionContext = new CollisionContext(this);
+}
+
+World::~World() {
+    delete collisionContext;
+    if (ownsManagers) {
+        delete sceneManager;
+        delete componentManager;
+        delete entityManager;
+        delete cameraManager;
+    }
+}
+
+EntityManager* World::GetEntityManager() const {
+    return entityManager;
+}
+
+ComponentManager* World::GetComponentManager() const {
+    return componentManager;
+}
+
+SceneManager* World::GetSceneManager() const {
+    return sceneManager;
+}
+
+CameraManager* World::GetCameraManager() const {
+    return cameraManager;
+}
+
+CollisionContext* World::GetCollisionContext() const {
+    return collisionContext;
+}
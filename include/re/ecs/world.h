@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../utils/singleton.h"
+
+#include "entity/entity_manager.h"
+#include "component/component_manager.h"
+#include "../scene/scene_manager.h"
+#include "../camera/camera_manager.h"
+#include "../collision/collision_context.h"
+
+// Owns the managers backing one ECS world.  The default world (GetInstance) wraps the global manager singletons, while
+// constructed worlds own their managers so several worlds can be simulated on separate threads.  Worlds share the
+// AssetManager and SceneTemplateCache, which lock their lookups; assets are still loaded on the main thread.
+class World : public Singleton<World> {
+  public:
+    World();
+    World(singleton);
+    ~World();
+    EntityManager* GetEntityManager() const;
+    ComponentManager* GetComponentManager() const;
+    SceneManager* GetSceneManager() const;
+    CameraManager* GetCameraManager() const;
+    CollisionContext* GetCollisionContext() const;
+
+  private:
+    EntityManager *entityManager = nullptr;
+    ComponentManager *componentManager = nullptr;
+    SceneManager *sceneManager = nullptr;
+    CameraManager *cameraManager = nullptr;
+    CollisionContext *collisionContext = nullptr;
+    bool ownsManagers = false;
+};
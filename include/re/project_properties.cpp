@@ -8,6 +8,10 @@ std::string ProjectProperties::GetInitialScenePath() const {
     return initialScenePath;
 }
 
+std::string ProjectProperties::GetInitialWorldPath() const {
+    return initialWorldPath;
+}
+
 unsigned int ProjectProperties::GetWindowWidth() const {
     return windowWidth;
 }
@@ -31,25 +35,40 @@ InputActionsConfigurations ProjectProperties::GetInputActionsConfigurations() {
 void ProjectProperties::SetProjectProperties(const nlohmann::json& propertiesJson) {
     gameTitle = JsonHelper::Get<std::string>(propertiesJson, "game_title");
     initialScenePath = JsonHelper::Get<std::string>(propertiesJson, "initial_scene");
-    nlohmann::json baseResolutionJson = JsonHelper::Get<nlohmann::json>(propertiesJson, "base_resolution");
+    initialWorldPath = JsonHelper::GetDefault<std::string>(propertiesJson, "initial_world", "");
+    const nlohmann::json& baseResolutionJson = JsonHelper::GetJson(propertiesJson, "base_resolution");
     windowWidth = JsonHelper::Get<int>(baseResolutionJson, "width");
     windowHeight = JsonHelper::Get<int>(baseResolutionJson, "height");
     areColliderVisible = JsonHelper::Get<bool>(propertiesJson, "colliders_visible");
+    isSceneHotReloadEnabled = JsonHelper::GetDefault<bool>(propertiesJson, "scene_hot_reload", false);
     targetFPS = JsonHelper::Get<unsigned int>(propertiesJson, "target_fps");
-    nlohmann::json backgroundColorJson = JsonHelper::Get<nlohmann::json>(propertiesJson, "background_color");
+    const nlohmann::json& backgroundColorJson = JsonHelper::GetJson(propertiesJson, "background_color");
     const int backgroundRed = JsonHelper::Get<int>(backgroundColorJson, "red");
     const int backgroundGreen = JsonHelper::Get<int>(backgroundColorJson, "green");
     const int backgroundBlue = JsonHelper::Get<int>(backgroundColorJson, "blue");
     backgroundClearColor = Color::NormalizedColor(backgroundRed, backgroundGreen, backgroundBlue);
-    nlohmann::json assetsJsonArray = JsonHelper::Get<nlohmann::json>(propertiesJson, "assets");
+    const nlohmann::json& assetsJsonArray = JsonHelper::GetJson(propertiesJson, "assets");
     assetConfigurations = LoadProjectAssets(assetsJsonArray);
-    nlohmann::json inputActionsJsonArray = JsonHelper::Get<nlohmann::json>(propertiesJson, "input_actions");
+    if (propertiesJson.contains("texture_atlas")) {
+        const nlohmann::json& textureAtlasJson = JsonHelper::GetJson(propertiesJson, "texture_atlas");
+        TextureAtlasConfiguration& textureAtlasConfiguration = assetConfigurations.textureAtlasConfiguration;
+        textureAtlasConfiguration.enabled = JsonHelper::GetDefault<bool>(textureAtlasJson, "enabled", textureAtlasConfiguration.enabled);
+        textureAtlasConfiguration.pageSize = JsonHelper::GetDefault<int>(textureAtlasJson, "page_size", textureAtlasConfiguration.pageSize);
+        textureAtlasConfiguration.padding = JsonHelper::GetDefault<int>(textureAtlasJson, "padding", textureAtlasConfiguration.padding);
+    }
+    if (propertiesJson.contains("glyph_cache")) {
+        const nlohmann::json& glyphCacheJson = JsonHelper::GetJson(propertiesJson, "glyph_cache");
+        GlyphCacheConfiguration& glyphCacheConfiguration = assetConfigurations.glyphCacheConfiguration;
+        glyphCacheConfiguration.pageSize = JsonHelper::GetDefault<int>(glyphCacheJson, "page_size", glyphCacheConfiguration.pageSize);
+        glyphCacheConfiguration.maxPages = JsonHelper::GetDefault<int>(glyphCacheJson, "max_pages", glyphCacheConfiguration.maxPages);
+    }
+    const nlohmann::json& inputActionsJsonArray = JsonHelper::GetJson(propertiesJson, "input_actions");
     inputActionsConfigurations = LoadProjectInputActions(inputActionsJsonArray);
 }
 
 AssetConfigurations ProjectProperties::LoadProjectAssets(const nlohmann::json& assetsJsonArray) {
     AssetConfigurations loadedAssetConfigurations;
-    for (nlohmann::json assetJson : assetsJsonArray) {
+    for (const nlohmann::json& assetJson : assetsJsonArray) {
         const std::string &assetType = JsonHelper::Get<std::string>(assetJson, "type");
         const std::string &assetsFilePath = JsonHelper::Get<std::string>(assetJson, "file_path");
         if (assetType == "texture") {
@@ -67,10 +86,12 @@ AssetConfigurations ProjectProperties::LoadProjectAssets(const nlohmann::json& a
         } else if (assetType == "font") {
             const std::string &fontId = JsonHelper::Get<std::string>(assetJson, "uid");
             int fontSize = JsonHelper::Get<int>(assetJson, "size");
+            const bool fontDistanceField = JsonHelper::GetDefault<bool>(assetJson, "distance_field", false);
             loadedAssetConfigurations.fontConfigurations.emplace_back(FontConfiguration{
                 .filePath = assetsFilePath,
                 .uid = fontId,
-                .size = fontSize
+                .size = fontSize,
+                .distanceField = fontDistanceField
             });
         } else if (assetType == "music") {
             loadedAssetConfigurations.musicConfigurations.emplace_back(MusicConfiguration{
@@ -87,10 +108,10 @@ AssetConfigurations ProjectProperties::LoadProjectAssets(const nlohmann::json& a
 
 InputActionsConfigurations ProjectProperties::LoadProjectInputActions(const nlohmann::json& inputActionsJsonArray) {
     InputActionsConfigurations loadInputActionsConfigurations;
-    for (nlohmann::json inputActionJson : inputActionsJsonArray) {
+    for (const nlohmann::json& inputActionJson : inputActionsJsonArray) {
         const std::string &actionName = JsonHelper::Get<std::string>(inputActionJson, "name");
         std::vector<std::string> inputActionValues;
-        nlohmann::json actionValuesArray = JsonHelper::Get<nlohmann::json>(inputActionJson, "values");
+        const nlohmann::json& actionValuesArray = JsonHelper::GetJson(inputActionJson, "values");
         for (const auto &value : actionValuesArray) {
             inputActionValues.emplace_back(value);
         }
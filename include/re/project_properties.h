@@ -20,6 +20,8 @@ struct FontConfiguration {
     std::string filePath;
     std::string uid;
     int size;
+    // Sizes of a distance field font share one set of glyphs rasterized per file
+    bool distanceField = false;
 };
 
 struct MusicConfiguration {
@@ -30,11 +32,26 @@ struct SoundConfiguration {
     std::string filePath;
 };
 
+// Textures listed in the project are packed into shared pages when they load so their sprites batch together
+struct TextureAtlasConfiguration {
+    bool enabled = true;
+    int pageSize = 2048;
+    int padding = 2;
+};
+
+// Fonts rasterize glyphs on demand into pages of this size, up to 'maxPages' per font
+struct GlyphCacheConfiguration {
+    int pageSize = 512;
+    int maxPages = 4;
+};
+
 struct AssetConfigurations {
     std::vector<TextureConfiguration> textureConfigurations;
     std::vector<FontConfiguration> fontConfigurations;
     std::vector<MusicConfiguration> musicConfigurations;
     std::vector<SoundConfiguration> soundConfigurations;
+    TextureAtlasConfiguration textureAtlasConfiguration;
+    GlyphCacheConfiguration glyphCacheConfiguration;
 };
 
 struct InputConfiguration {
@@ -50,10 +67,12 @@ class ProjectProperties : public Singleton<ProjectProperties> {
   public:
     Color backgroundClearColor = Color::NormalizedColor(50, 50, 50);
     bool areColliderVisible = false;
+    bool isSceneHotReloadEnabled = false;
 
     ProjectProperties(singleton) {}
     std::string GetGameTitle() const;
     std::string GetInitialScenePath() const;
+    std::string GetInitialWorldPath() const;
     unsigned int GetWindowWidth() const;
     unsigned int GetWindowHeight() const;
     unsigned int GetTargetFPS() const;
@@ -64,6 +83,7 @@ class ProjectProperties : public Singleton<ProjectProperties> {
 private:
     std::string gameTitle;
     std::string initialScenePath;
+    std::string initialWorldPath; // Optional, streamed into every scene
     unsigned int windowWidth = 800;
     unsigned int windowHeight = 600;
     unsigned int targetFPS = 60;
@@ -3,7 +3,15 @@
 #include <iostream>
 
 #include <string>
-#include <map>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+#include <memory>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -15,107 +23,551 @@
 #include "../utils/logger.h"
 
 struct Character {
-    GLuint textureID;
+    // Glyphs without pixels (spaces, glyphs larger than a page) aren't on a page and only move the cursor
+    static const unsigned int NO_PAGE = UINT_MAX;
+    // Glyph that didn't fit while every page was in use this frame, it's drawn once it can be cached
+    static const unsigned int NOT_CACHED = UINT_MAX - 1;
+
     Vector2 size;
     Vector2 bearing;
     unsigned int advance;
+    // Glyph's rectangle in its page, in texture coordinates
+    Vector2 textureTopLeft;
+    Vector2 textureBottomRight;
+    unsigned int page = NO_PAGE;
 };
 
-class Font {
+// Squared distance to the other side of the outline when a glyph has no pixel there, larger than any glyph
+static const float DISTANCE_FIELD_FAR = 1.0e10f;
+
+enum class FontRenderMode {
+    Bitmap,
+    // Glyphs are stored as distance to their outline, which stays sharp when scaled
+    DistanceField
+};
+
+struct GlyphCacheSettings {
+    int pageSize = 512; // Width and height of a page, a page takes pageSize * pageSize bytes of texture memory
+    int maxPages = 4; // Pages a font fills before the least recently used one is cleared for new glyphs
+};
+
+// Glyphs are rasterized the first time a string uses them and packed into a few shared GL_RED pages, so any Unicode
+// text can be drawn without loading whole character ranges up front.  Once 'maxPages' are full the page least
+// recently used is cleared, pages used during the current frame are never cleared.  Pixels of new glyphs are kept
+// on the CPU until 'UploadGlyphs', which sends each page's changed rows in a single call before the text is drawn.
+class GlyphCache {
   public:
-    std::map<GLchar, Character> characters;
-    GLuint VAO;
-    GLuint VBO;
+    // Distance fields are rasterized at this size whatever the size of the text
+    static const int DISTANCE_FIELD_SIZE = 32;
+    // Pixels around the outline covered by a distance field, glyphs grow by this much on every side
+    static const int DISTANCE_FIELD_SPREAD = 4;
 
-    Font(FT_Library freeTypeLibrary, const char* fileName, int size) : filePath(std::string(fileName)), size(size) {
-        LoadFont(freeTypeLibrary, fileName, size);
-        ConfigureVertex();
+    GlyphCache(FT_Library freeTypeLibrary, const std::string &filePath, int rasterSize, const GlyphCacheSettings &glyphCacheSettings, FontRenderMode renderMode)
+        : filePath(filePath), rasterSize(rasterSize), glyphCacheSettings(glyphCacheSettings), renderMode(renderMode) {
+        LoadFace(freeTypeLibrary);
     }
 
-    std::string GetFilePath() const {
-        return filePath;
+    ~GlyphCache() {
+        for (GlyphPage &page : pages) {
+            glDeleteTextures(1, &page.textureID);
+        }
+        if (face != nullptr) {
+            FT_Done_Face(face);
+        }
     }
 
-    int GetSize() const {
-        return size;
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+
+    // Rasterizes the glyph into the cache if it isn't there yet and marks its page as used this frame
+    const Character& GetCharacter(uint32_t codepoint) {
+        const Character* character = codepoint < asciiCharacters.size() ? asciiCharacters[codepoint] : nullptr;
+        if (character == nullptr) {
+            const auto characterIt = characters.find(codepoint);
+            character = characterIt != characters.end() ? &characterIt->second : CacheCharacter(codepoint);
+        }
+        if (character->page < pages.size()) {
+            pages[character->page].lastUsedFrame = GetCurrentFrame();
+        }
+        return *character;
+    }
+
+    void MarkPageUsed(unsigned int page) {
+        pages[page].lastUsedFrame = GetCurrentFrame();
+    }
+
+    unsigned int GetPageGeneration(unsigned int page) const {
+        return pages[page].generation;
+    }
+
+    GLuint GetPageTextureID(unsigned int page) const {
+        return pages[page].textureID;
+    }
+
+    void UploadGlyphs() {
+        for (GlyphPage &page : pages) {
+            if (page.dirtyTop >= page.dirtyBottom) {
+                continue;
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glBindTexture(GL_TEXTURE_2D, page.textureID);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, page.dirtyTop, glyphCacheSettings.pageSize, page.dirtyBottom - page.dirtyTop,
+                            GL_RED, GL_UNSIGNED_BYTE, &page.pixels[page.dirtyTop * glyphCacheSettings.pageSize]);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            page.dirtyTop = INT_MAX;
+            page.dirtyBottom = 0;
+        }
+    }
+
+    size_t GetPageCount() const {
+        return pages.size();
+    }
+
+    size_t GetCachedGlyphCount() const {
+        return characters.size();
+    }
+
+    int GetRasterSize() const {
+        return rasterSize;
+    }
+
+    FontRenderMode GetRenderMode() const {
+        return renderMode;
     }
 
     bool IsValid() const {
-        return valid;
+        return face != nullptr;
+    }
+
+    static void AdvanceFrame() {
+        GetCurrentFrame()++;
     }
 
   private:
+    // Glyphs are surrounded by a copy of their edge pixels, so linear filtering at a glyph's edge clamps like a texture
+    // of its own instead of blending in a neighbour
+    static const int GLYPH_PADDING = 1;
+
+    struct GlyphImage {
+        const unsigned char* pixels;
+        int width;
+        int rows;
+        int pitch;
+    };
+
+    struct GlyphShelf {
+        int y;
+        int height;
+        int x;
+    };
+
+    struct GlyphPage {
+        GLuint textureID = 0;
+        std::vector<unsigned char> pixels;
+        std::vector<GlyphShelf> shelves;
+        int shelvesBottom = 0;
+        // Rows changed since the last upload
+        int dirtyTop = INT_MAX;
+        int dirtyBottom = 0;
+        unsigned int lastUsedFrame = 0;
+        unsigned int generation = 0;
+        std::vector<uint32_t> codepoints;
+    };
+
     std::string filePath;
-    int size;
-    bool valid = false;
+    int rasterSize;
+    GlyphCacheSettings glyphCacheSettings;
+    FontRenderMode renderMode;
+    FT_Face face = nullptr;
+    std::unordered_map<uint32_t, Character> characters;
+    // Pointers into 'characters' so ASCII skips the hash lookup
+    std::array<const Character*, 128> asciiCharacters{};
+    std::vector<GlyphPage> pages;
+    // Handed out while every page is in use this frame, the glyph is rasterized again on its next use
+    Character uncachedCharacter;
+    bool isCacheFullReported = false;
+    // Scratch buffers of distance field glyphs
+    std::vector<unsigned char> distanceFieldPixels;
+    std::vector<float> distanceToInside;
+    std::vector<float> distanceToOutside;
+    std::vector<float> transformInput;
+    std::vector<float> transformOutput;
+    std::vector<int> transformParabolas;
+    std::vector<float> transformBoundaries;
+
+    static unsigned int& GetCurrentFrame() {
+        static unsigned int currentFrame = 0;
+        return currentFrame;
+    }
 
-    void LoadFont(FT_Library freeTypeLibrary, const char* fileName, int size) {
+    void LoadFace(FT_Library freeTypeLibrary) {
         static Logger *logger = Logger::GetInstance();
-        if(!FileHelper::DoesFileExist(fileName)) {
-            logger->Error("Font doesn't exist at path: %s", fileName);
+        if(!FileHelper::DoesFileExist(filePath)) {
+            logger->Error("Font doesn't exist at path: %s", filePath.c_str());
         }
-        FT_Face face;
-        if(FT_New_Face(freeTypeLibrary, fileName, 0, &face)) {
+        if(FT_New_Face(freeTypeLibrary, filePath.c_str(), 0, &face)) {
             logger->Error("Freetype failed to load font!");
-        } else {
-            // set size to load glyphs. width set to 0 to dynamically adjust
-            FT_Set_Pixel_Sizes(face, 0, size);
+            face = nullptr;
+            return;
+        }
+        // set size to load glyphs. width set to 0 to dynamically adjust
+        FT_Set_Pixel_Sizes(face, 0, rasterSize);
+        // printable ASCII is common enough to cache up front, everything else waits until it's drawn
+        for (uint32_t codepoint = 32; codepoint < 127; codepoint++) {
+            CacheCharacter(codepoint);
+        }
+    }
 
-            // disable byte-alignment restriction
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    const Character* CacheCharacter(uint32_t codepoint) {
+        static Logger *logger = Logger::GetInstance();
+        Character character{};
+        // Hinting snaps outlines to the raster size's pixel grid, which is wrong at every other size
+        const FT_Int32 loadFlags = renderMode == FontRenderMode::DistanceField ? FT_LOAD_RENDER | FT_LOAD_NO_HINTING : FT_LOAD_RENDER;
+        if (face == nullptr || FT_Load_Char(face, codepoint, loadFlags)) {
+            logger->Error("Freetype Failed to load Glyph");
+            return AddCharacter(codepoint, character);
+        }
+        const FT_GlyphSlot glyph = face->glyph;
+        const FT_Bitmap &bitmap = glyph->bitmap;
+        character.advance = static_cast<unsigned int>(glyph->advance.x);
+        if (bitmap.width == 0 || bitmap.rows == 0) {
+            return AddCharacter(codepoint, character);
+        }
+        GlyphImage image{ bitmap.buffer, static_cast<int>(bitmap.width), static_cast<int>(bitmap.rows), bitmap.pitch };
+        character.bearing = Vector2(glyph->bitmap_left, glyph->bitmap_top);
+        if (renderMode == FontRenderMode::DistanceField) {
+            image = ComputeDistanceField(image);
+            character.bearing = Vector2(glyph->bitmap_left - DISTANCE_FIELD_SPREAD, glyph->bitmap_top + DISTANCE_FIELD_SPREAD);
+        }
+        character.size = Vector2(image.width, image.rows);
 
-            // load first 128 characters of ASCII set
-            for(unsigned char c = 0; c < 128; c++) {
-                // load character glyph
-                if(FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-                    logger->Error("Freetype Failed to load Glyph");
-                    continue;
+        const int cellWidth = image.width + GLYPH_PADDING * 2;
+        const int cellHeight = image.rows + GLYPH_PADDING * 2;
+        int x = 0;
+        int y = 0;
+        const unsigned int page = FindGlyphSpace(cellWidth, cellHeight, x, y);
+        if (page == Character::NO_PAGE) {
+            // Metrics are still right so the rest of the string keeps its place
+            uncachedCharacter = character;
+            uncachedCharacter.size = Vector2(0.0f, 0.0f);
+            if (cellWidth > glyphCacheSettings.pageSize || cellHeight > glyphCacheSettings.pageSize) {
+                logger->Error("Glyph %u of font '%s' is larger than a glyph cache page!", codepoint, filePath.c_str());
+                return AddCharacter(codepoint, uncachedCharacter);
+            }
+            uncachedCharacter.page = Character::NOT_CACHED;
+            if (!isCacheFullReported) {
+                logger->Warn("Glyph cache of font '%s' is full for this frame, raise 'max_pages' of 'glyph_cache'", filePath.c_str());
+                isCacheFullReported = true;
+            }
+            return &uncachedCharacter;
+        }
+
+        GlyphPage &glyphPage = pages[page];
+        const int pageSize = glyphCacheSettings.pageSize;
+        const int glyphX = x + GLYPH_PADDING;
+        const int glyphY = y + GLYPH_PADDING;
+        const int width = image.width;
+        const int rows = image.rows;
+        for (int row = -GLYPH_PADDING; row < rows + GLYPH_PADDING; row++) {
+            const int sourceRow = std::min(std::max(row, 0), rows - 1);
+            const unsigned char* sourceRowPixels = image.pixels + sourceRow * image.pitch;
+            unsigned char* pageRowPixels = &glyphPage.pixels[(glyphY + row) * pageSize + glyphX];
+            std::copy_n(sourceRowPixels, width, pageRowPixels);
+            for (int column = 1; column <= GLYPH_PADDING; column++) {
+                pageRowPixels[-column] = sourceRowPixels[0];
+                pageRowPixels[width - 1 + column] = sourceRowPixels[width - 1];
+            }
+        }
+        glyphPage.dirtyTop = std::min(glyphPage.dirtyTop, y);
+        glyphPage.dirtyBottom = std::max(glyphPage.dirtyBottom, y + cellHeight);
+        glyphPage.codepoints.emplace_back(codepoint);
+        glyphPage.lastUsedFrame = GetCurrentFrame();
+
+        character.page = page;
+        character.textureTopLeft = Vector2(static_cast<float>(glyphX) / pageSize, static_cast<float>(glyphY) / pageSize);
+        character.textureBottomRight = Vector2(static_cast<float>(glyphX + width) / pageSize, static_cast<float>(glyphY + rows) / pageSize);
+        return AddCharacter(codepoint, character);
+    }
+
+    // Signed distance from every pixel center to the glyph's outline, 128 is on the outline and the value changes by
+    // 127 / DISTANCE_FIELD_SPREAD per pixel, growing inside.  Squared distances to the nearest pixel on the other side
+    // of the outline come from two separable passes of Felzenszwalb and Huttenlocher's transform, partly covered
+    // pixels place the outline inside their own pixel.
+    GlyphImage ComputeDistanceField(const GlyphImage &coverage) {
+        const int spread = DISTANCE_FIELD_SPREAD;
+        const int width = coverage.width + spread * 2;
+        const int rows = coverage.rows + spread * 2;
+        const size_t pixelCount = static_cast<size_t>(width) * rows;
+        const auto coverageAt = [&coverage, spread] (int x, int y) -> float {
+            x -= spread;
+            y -= spread;
+            if (x < 0 || y < 0 || x >= coverage.width || y >= coverage.rows) {
+                return 0.0f;
+            }
+            return coverage.pixels[y * coverage.pitch + x] / 255.0f;
+        };
+        distanceToInside.assign(pixelCount, DISTANCE_FIELD_FAR);
+        distanceToOutside.assign(pixelCount, DISTANCE_FIELD_FAR);
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < width; x++) {
+                (coverageAt(x, y) >= 0.5f ? distanceToInside : distanceToOutside)[y * width + x] = 0.0f;
+            }
+        }
+        DistanceTransform(distanceToInside, width, rows);
+        DistanceTransform(distanceToOutside, width, rows);
+
+        distanceFieldPixels.resize(pixelCount);
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < width; x++) {
+                const size_t index = y * width + x;
+                const float pixelCoverage = coverageAt(x, y);
+                // Neighbouring pixel centers are half a pixel away from an outline between them
+                float distance = pixelCoverage >= 0.5f ? std::sqrt(distanceToOutside[index]) - 0.5f : 0.5f - std::sqrt(distanceToInside[index]);
+                if (pixelCoverage > 0.0f && pixelCoverage < 1.0f) {
+                    distance = pixelCoverage - 0.5f;
                 }
-                // generate texture
-                unsigned int textTexture;
-                glGenTextures(1, &textTexture);
-                glBindTexture(GL_TEXTURE_2D, textTexture);
-                glTexImage2D(
-                    GL_TEXTURE_2D,
-                    0,
-                    GL_RED,
-                    face->glyph->bitmap.width,
-                    face->glyph->bitmap.rows,
-                    0,
-                    GL_RED,
-                    GL_UNSIGNED_BYTE,
-                    face->glyph->bitmap.buffer
-                );
-                // set texture options
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                // store character for later use
-                Character character = {
-                    .textureID = textTexture,
-                    .size = Vector2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-                    .bearing = Vector2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-                    .advance = static_cast<unsigned int>(face->glyph->advance.x)
-                };
-                characters.insert(std::pair<char, Character>(c, character));
+                const float value = 128.0f + distance * 127.0f / spread;
+                distanceFieldPixels[index] = static_cast<unsigned char>(std::min(std::max(value, 0.0f), 255.0f) + 0.5f);
             }
-            glBindTexture(GL_TEXTURE_2D, 0);
-            valid = true;
         }
-        FT_Done_Face(face);
+        return GlyphImage{ distanceFieldPixels.data(), width, rows, width };
     }
 
-    void ConfigureVertex() {
-        // configure VAO & VBO texture quads
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), nullptr);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+    void DistanceTransform(std::vector<float> &distances, int width, int rows) {
+        const int length = std::max(width, rows);
+        transformInput.resize(length);
+        transformOutput.resize(length);
+        transformParabolas.resize(length);
+        transformBoundaries.resize(length + 1);
+        for (int x = 0; x < width; x++) {
+            for (int y = 0; y < rows; y++) {
+                transformInput[y] = distances[y * width + x];
+            }
+            DistanceTransform1D(rows);
+            for (int y = 0; y < rows; y++) {
+                distances[y * width + x] = transformOutput[y];
+            }
+        }
+        for (int y = 0; y < rows; y++) {
+            std::copy_n(distances.begin() + y * width, width, transformInput.begin());
+            DistanceTransform1D(width);
+            std::copy_n(transformOutput.begin(), width, distances.begin() + y * width);
+        }
     }
+
+    // Lower envelope of the parabolas rooted at every sample
+    void DistanceTransform1D(int length) {
+        int parabolaIndex = 0;
+        transformParabolas[0] = 0;
+        transformBoundaries[0] = -DISTANCE_FIELD_FAR;
+        transformBoundaries[1] = DISTANCE_FIELD_FAR;
+        for (int q = 1; q < length; q++) {
+            float intersection = 0.0f;
+            while (true) {
+                const int v = transformParabolas[parabolaIndex];
+                intersection = ((transformInput[q] + q * q) - (transformInput[v] + v * v)) / (2.0f * (q - v));
+                if (intersection > transformBoundaries[parabolaIndex]) {
+                    break;
+                }
+                parabolaIndex--;
+            }
+            parabolaIndex++;
+            transformParabolas[parabolaIndex] = q;
+            transformBoundaries[parabolaIndex] = intersection;
+            transformBoundaries[parabolaIndex + 1] = DISTANCE_FIELD_FAR;
+        }
+        parabolaIndex = 0;
+        for (int q = 0; q < length; q++) {
+            while (transformBoundaries[parabolaIndex + 1] < q) {
+                parabolaIndex++;
+            }
+            const int v = transformParabolas[parabolaIndex];
+            transformOutput[q] = (q - v) * (q - v) + transformInput[v];
+        }
+    }
+
+    const Character* AddCharacter(uint32_t codepoint, const Character &character) {
+        const Character* cachedCharacter = &characters.emplace(codepoint, character).first->second;
+        if (codepoint < asciiCharacters.size()) {
+            asciiCharacters[codepoint] = cachedCharacter;
+        }
+        return cachedCharacter;
+    }
+
+    // Tries the pages in order, then a new page while under the budget, then the least recently used page
+    unsigned int FindGlyphSpace(int width, int height, int &outX, int &outY) {
+        if (width > glyphCacheSettings.pageSize || height > glyphCacheSettings.pageSize) {
+            return Character::NO_PAGE;
+        }
+        for (unsigned int page = 0; page < pages.size(); page++) {
+            if (PlaceOnShelf(pages[page], width, height, outX, outY)) {
+                return page;
+            }
+        }
+        unsigned int page = Character::NO_PAGE;
+        if (pages.size() < static_cast<size_t>(glyphCacheSettings.maxPages)) {
+            page = static_cast<unsigned int>(pages.size());
+            AddPage();
+        } else {
+            const unsigned int currentFrame = GetCurrentFrame();
+            for (unsigned int candidate = 0; candidate < pages.size(); candidate++) {
+                if (pages[candidate].lastUsedFrame != currentFrame
+                        && (page == Character::NO_PAGE || pages[candidate].lastUsedFrame < pages[page].lastUsedFrame)) {
+                    page = candidate;
+                }
+            }
+            if (page == Character::NO_PAGE) {
+                return Character::NO_PAGE;
+            }
+            ClearPage(page);
+        }
+        PlaceOnShelf(pages[page], width, height, outX, outY);
+        return page;
+    }
+
+    // Glyphs go on the shelf that wastes the least height, a new shelf is opened below the others when none fits
+    bool PlaceOnShelf(GlyphPage &page, int width, int height, int &outX, int &outY) const {
+        const int pageSize = glyphCacheSettings.pageSize;
+        GlyphShelf* bestShelf = nullptr;
+        for (GlyphShelf &shelf : page.shelves) {
+            if (shelf.height >= height && shelf.x + width <= pageSize && (bestShelf == nullptr || shelf.height < bestShelf->height)) {
+                bestShelf = &shelf;
+            }
+        }
+        if (bestShelf == nullptr) {
+            if (page.shelvesBottom + height > pageSize) {
+                return false;
+            }
+            page.shelves.emplace_back(GlyphShelf{ page.shelvesBottom, height, 0 });
+            page.shelvesBottom += height;
+            bestShelf = &page.shelves.back();
+        }
+        outX = bestShelf->x;
+        outY = bestShelf->y;
+        bestShelf->x += width;
+        return true;
+    }
+
+    void AddPage() {
+        const int pageSize = glyphCacheSettings.pageSize;
+        GlyphPage page;
+        page.pixels.assign(static_cast<size_t>(pageSize) * pageSize, 0);
+        glGenTextures(1, &page.textureID);
+        glBindTexture(GL_TEXTURE_2D, page.textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, pageSize, pageSize, 0, GL_RED, GL_UNSIGNED_BYTE, page.pixels.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        pages.emplace_back(std::move(page));
+    }
+
+    void ClearPage(unsigned int pageIndex) {
+        GlyphPage &page = pages[pageIndex];
+        for (uint32_t codepoint : page.codepoints) {
+            characters.erase(codepoint);
+            if (codepoint < asciiCharacters.size()) {
+                asciiCharacters[codepoint] = nullptr;
+            }
+        }
+        // Only the rows under the shelves ever held glyphs
+        std::fill_n(page.pixels.begin(), static_cast<size_t>(page.shelvesBottom) * glyphCacheSettings.pageSize, 0);
+        page.dirtyTop = 0;
+        page.dirtyBottom = std::max(page.dirtyBottom, page.shelvesBottom);
+        page.codepoints.clear();
+        page.shelves.clear();
+        page.shelvesBottom = 0;
+        page.generation++;
+    }
+};
+
+// A typeface at one size.  Bitmap fonts rasterize their own glyphs at that size, distance field fonts loaded from
+// the same file can share one cache rasterized at 'GlyphCache::DISTANCE_FIELD_SIZE' and scale its glyphs to their
+// size when laid out.
+class Font {
+  public:
+    Font(FT_Library freeTypeLibrary, const char* fileName, int size, const GlyphCacheSettings &glyphCacheSettings = GlyphCacheSettings(),
+         FontRenderMode renderMode = FontRenderMode::Bitmap)
+        : filePath(std::string(fileName)), size(size) {
+        int rasterSize = size;
+        if (renderMode == FontRenderMode::DistanceField) {
+            rasterSize = GlyphCache::DISTANCE_FIELD_SIZE;
+        }
+        glyphCache = std::make_shared<GlyphCache>(freeTypeLibrary, filePath, rasterSize, glyphCacheSettings, renderMode);
+        glyphScale = static_cast<float>(size) / static_cast<float>(rasterSize);
+    }
+
+    // Draws the glyphs of a distance field font at another size without rasterizing them again
+    Font(const Font &distanceFieldFont, int size) : filePath(distanceFieldFont.filePath), size(size), glyphCache(distanceFieldFont.glyphCache) {
+        glyphScale = static_cast<float>(size) / static_cast<float>(glyphCache->GetRasterSize());
+    }
+
+    Font(const Font&) = delete;
+    Font& operator=(const Font&) = delete;
+
+    // Rasterizes the glyph into the cache if it isn't there yet and marks its page as used this frame, metrics are
+    // in the cache's pixels and have to be multiplied by 'GetGlyphScale'
+    const Character& GetCharacter(uint32_t codepoint) {
+        return glyphCache->GetCharacter(codepoint);
+    }
+
+    // Keeps a page from being cleared this frame, for text laid out earlier that is drawn again
+    void MarkPageUsed(unsigned int page) {
+        glyphCache->MarkPageUsed(page);
+    }
+
+    // Changes every time the page is cleared, glyphs laid out from an older generation are gone
+    unsigned int GetPageGeneration(unsigned int page) const {
+        return glyphCache->GetPageGeneration(page);
+    }
+
+    GLuint GetPageTextureID(unsigned int page) const {
+        return glyphCache->GetPageTextureID(page);
+    }
+
+    // Uploads the pixels of glyphs rasterized since the last call
+    void UploadGlyphs() {
+        glyphCache->UploadGlyphs();
+    }
+
+    size_t GetPageCount() const {
+        return glyphCache->GetPageCount();
+    }
+
+    size_t GetCachedGlyphCount() const {
+        return glyphCache->GetCachedGlyphCount();
+    }
+
+    float GetGlyphScale() const {
+        return glyphScale;
+    }
+
+    FontRenderMode GetRenderMode() const {
+        return glyphCache->GetRenderMode();
+    }
+
+    std::string GetFilePath() const {
+        return filePath;
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+    bool IsValid() const {
+        return glyphCache->IsValid();
+    }
+
+    // Pages used since the last call can't be cleared, Renderer2D calls it once a frame has been drawn
+    static void AdvanceFrame() {
+        GlyphCache::AdvanceFrame();
+    }
+
+  private:
+    std::string filePath;
+    int size;
+    std::shared_ptr<GlyphCache> glyphCache;
+    float glyphScale = 1.0f;
 };
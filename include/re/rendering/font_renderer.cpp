@@ -1,64 +1,257 @@
 #include "font_renderer.h"
 
+#include <algorithm>
+#include <cstddef>
+
 #include <glm/gtc/matrix_transform.hpp>
 
+static GLubyte NormalizedToByte(float value) {
+    return static_cast<GLubyte>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+// Malformed sequences decode to U+FFFD one byte at a time
+static uint32_t DecodeUtf8(const std::string &text, size_t &index) {
+    static const uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+    const unsigned char lead = static_cast<unsigned char>(text[index++]);
+    if (lead < 0x80) {
+        return lead;
+    }
+    size_t continuationCount = 0;
+    uint32_t codepoint = 0;
+    uint32_t minimumCodepoint = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        continuationCount = 1;
+        codepoint = lead & 0x1F;
+        minimumCodepoint = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        continuationCount = 2;
+        codepoint = lead & 0x0F;
+        minimumCodepoint = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        continuationCount = 3;
+        codepoint = lead & 0x07;
+        minimumCodepoint = 0x10000;
+    } else {
+        return REPLACEMENT_CHARACTER;
+    }
+    if (index + continuationCount > text.size()) {
+        return REPLACEMENT_CHARACTER;
+    }
+    for (size_t i = 0; i < continuationCount; i++) {
+        const unsigned char continuation = static_cast<unsigned char>(text[index + i]);
+        if ((continuation & 0xC0) != 0x80) {
+            return REPLACEMENT_CHARACTER;
+        }
+        codepoint = (codepoint << 6) | (continuation & 0x3F);
+    }
+    index += continuationCount;
+    if (codepoint < minimumCodepoint || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return REPLACEMENT_CHARACTER;
+    }
+    return codepoint;
+}
+
 FontRenderer::FontRenderer() : projectProperties(ProjectProperties::GetInstance()) {
+    // Every glyph is two triangles over its four corners, so the index buffer never changes
+    std::vector<GLushort> indices(MAX_BATCH_GLYPHS * 6);
+    for (unsigned int glyph = 0; glyph < MAX_BATCH_GLYPHS; glyph++) {
+        const GLushort firstVertex = static_cast<GLushort>(glyph * 4);
+        GLushort* glyphIndices = &indices[glyph * 6];
+        glyphIndices[0] = firstVertex;
+        glyphIndices[1] = firstVertex + 1;
+        glyphIndices[2] = firstVertex + 2;
+        glyphIndices[3] = firstVertex;
+        glyphIndices[4] = firstVertex + 2;
+        glyphIndices[5] = firstVertex + 3;
+    }
+    vertices.reserve(MAX_BATCH_GLYPHS * 4);
+
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glGenBuffers(1, &quadEBO);
+
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_GLYPHS * 4 * sizeof(FontVertex), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(FontVertex), (void*) offsetof(FontVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(FontVertex), (void*) offsetof(FontVertex, texCoords));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(FontVertex), (void*) offsetof(FontVertex, color));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
     shader = Shader(OPENGL_SHADER_SOURCE_FONT);
+    shader.Use();
+    shader.SetInt("textValue", 0);
+    distanceFieldShader = Shader(OPENGL_SHADER_SOURCE_DISTANCE_FIELD_FONT);
+    distanceFieldShader.Use();
+    distanceFieldShader.SetInt("textValue", 0);
     UpdateProjection();
 }
 
+FontRenderer::~FontRenderer() {
+    glDeleteBuffers(1, &quadEBO);
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteVertexArrays(1, &quadVAO);
+}
+
 void FontRenderer::Draw(Font *font, const std::string &text, float x, float y, float scale, const Color color) {
-    Vector2 currentScale = Vector2(scale, scale);
-    shader.Use();
-    shader.SetVec4Float("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(font->VAO);
+    UpdateLayout(drawLayout, font, text, scale);
+    DrawLayout(drawLayout, x, y, color);
+}
+
+void FontRenderer::DrawLayout(const TextLayout &layout, float x, float y, const Color color) {
+    if (layout.vertices.empty()) {
+        return;
+    }
+    const GLubyte red = NormalizedToByte(color.r);
+    const GLubyte green = NormalizedToByte(color.g);
+    const GLubyte blue = NormalizedToByte(color.b);
+    const GLubyte alpha = NormalizedToByte(color.a);
 
     y = ConvertMinMax(y,
                       static_cast<float>(projectProperties->GetWindowWidth()),
                       0,
                       0,
                       static_cast<float>(projectProperties->GetWindowHeight()));
-    y -= font->GetSize() * 0.8f;
-
-    // iterate through all characters
-    std::string::const_iterator c;
-    for(c = text.begin(); c != text.end(); c++) {
-        Character ch = font->characters[*c];
-
-        const float xPos = x + (ch.bearing.x * currentScale.x);
-        const float yPos = y - (ch.size.y - ch.bearing.y) * currentScale.y;
-
-        const float w = ch.size.x * currentScale.x;
-        const float h = ch.size.y * currentScale.y;
-        // update VBO for each character
-        GLfloat vertices[6][4] = {
-            {xPos,     yPos + h, 0.0f, 0.0f},
-            {xPos,     yPos,     0.0f, 1.0f},
-            {xPos + w, yPos,     1.0f, 1.0f},
-
-            {xPos,     yPos + h, 0.0f, 0.0f},
-            {xPos + w, yPos,     1.0f, 1.0f},
-            {xPos + w, yPos + h, 1.0f, 0.0f}
-        };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.textureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, font->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        // advance cursor for next glyph (note that advance is number of 1/64 pixels)
-        x += (ch.advance >> 6) * currentScale.x; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
+    y -= layout.font->GetSize() * 0.8f;
+
+    // Runs longer than a batch are split on glyph boundaries, batches always hold whole quads
+    size_t layoutIndex = 0;
+    for (const TextLayoutRun &run : layout.runs) {
+        const GLuint pageTexture = layout.font->GetPageTextureID(run.page);
+        if (pageTexture != batchTexture) {
+            Flush();
+            batchFont = layout.font;
+            batchTexture = pageTexture;
+        }
+        const size_t runEnd = layoutIndex + run.vertexCount;
+        while (layoutIndex < runEnd) {
+            if (vertices.size() >= MAX_BATCH_GLYPHS * 4) {
+                Flush();
+            }
+            const size_t copyEnd = std::min(runEnd, layoutIndex + MAX_BATCH_GLYPHS * 4 - vertices.size());
+            for (; layoutIndex < copyEnd; layoutIndex++) {
+                const FontVertex &layoutVertex = layout.vertices[layoutIndex];
+                vertices.emplace_back(FontVertex{
+                    { layoutVertex.position[0] + x, layoutVertex.position[1] + y },
+                    { layoutVertex.texCoords[0], layoutVertex.texCoords[1] },
+                    { red, green, blue, alpha }
+                });
+            }
+        }
+    }
+}
+
+void FontRenderer::Flush() {
+    if (vertices.empty()) {
+        return;
+    }
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    // Orphaning the buffer lets the driver hand out fresh storage instead of waiting on the previous batch's draw
+    glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_GLYPHS * 4 * sizeof(FontVertex), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(FontVertex), vertices.data());
+
+    // Glyphs rasterized while laying out the frame's text go up together before the first draw that needs them
+    batchFont->UploadGlyphs();
+    if (batchFont->GetRenderMode() == FontRenderMode::DistanceField) {
+        distanceFieldShader.Use();
+    } else {
+        shader.Use();
     }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, batchTexture);
+
+    const GLsizei glyphCount = static_cast<GLsizei>(vertices.size() / 4);
+    glDrawElements(GL_TRIANGLES, glyphCount * 6, GL_UNSIGNED_SHORT, nullptr);
+    drawCallCount++;
+
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
+    vertices.clear();
 }
 
 void FontRenderer::UpdateProjection() {
     glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(projectProperties->GetWindowWidth()), 0.0f, static_cast<float>(projectProperties->GetWindowHeight()), -1.0f, 1.0f);
     shader.Use();
     shader.SetMatrix4Float("projection", projection);
+    distanceFieldShader.Use();
+    distanceFieldShader.SetMatrix4Float("projection", projection);
+}
+
+unsigned int FontRenderer::GetDrawCallCount() const {
+    return drawCallCount;
+}
+
+void FontRenderer::ResetDrawCallCount() {
+    drawCallCount = 0;
+}
+
+bool FontRenderer::UpdateLayout(TextLayout &layout, Font *font, const std::string &text, float scale) {
+    if (IsLayoutCurrent(layout, font, text, scale)) {
+        return false;
+    }
+    layout.font = font;
+    layout.text = text;
+    layout.scale = scale;
+    layout.isComplete = true;
+    layout.vertices.clear();
+    layout.runs.clear();
+    // Glyphs of distance field fonts are rasterized at another size than the font's
+    const float glyphScale = scale * font->GetGlyphScale();
+    float x = 0.0f;
+    size_t textIndex = 0;
+    while (textIndex < text.size()) {
+        const Character &ch = font->GetCharacter(DecodeUtf8(text, textIndex));
+        if (ch.page == Character::NOT_CACHED) {
+            layout.isComplete = false;
+        }
+        // Spaces and characters without a glyph only move the cursor
+        if (ch.size.x > 0.0f && ch.size.y > 0.0f) {
+            const float xPos = x + (ch.bearing.x * glyphScale);
+            const float yPos = -(ch.size.y - ch.bearing.y) * glyphScale;
+            const float w = ch.size.x * glyphScale;
+            const float h = ch.size.y * glyphScale;
+            const float left = ch.textureTopLeft.x;
+            const float top = ch.textureTopLeft.y;
+            const float right = ch.textureBottomRight.x;
+            const float bottom = ch.textureBottomRight.y;
+            // Top left, bottom left, bottom right, top right, the projection's y axis points up
+            layout.vertices.emplace_back(FontVertex{ { xPos, yPos + h }, { left, top }, {} });
+            layout.vertices.emplace_back(FontVertex{ { xPos, yPos }, { left, bottom }, {} });
+            layout.vertices.emplace_back(FontVertex{ { xPos + w, yPos }, { right, bottom }, {} });
+            layout.vertices.emplace_back(FontVertex{ { xPos + w, yPos + h }, { right, top }, {} });
+            if (layout.runs.empty() || layout.runs.back().page != ch.page) {
+                layout.runs.emplace_back(TextLayoutRun{ ch.page, font->GetPageGeneration(ch.page), 0 });
+            }
+            layout.runs.back().vertexCount += 4;
+        }
+        // advance cursor for next glyph (note that advance is number of 1/64 pixels, unhinted distance field glyphs
+        // advance by fractions of a pixel)
+        x += (static_cast<float>(ch.advance) / 64.0f) * glyphScale;
+    }
+    return true;
+}
+
+// A layout whose pages are all still holding its glyphs marks them used, so they stay cached until it's drawn
+bool FontRenderer::IsLayoutCurrent(const TextLayout &layout, const Font *font, const std::string &text, float scale) {
+    if (layout.font != font || layout.scale != scale || !layout.isComplete || layout.text != text) {
+        return false;
+    }
+    for (const TextLayoutRun &run : layout.runs) {
+        if (layout.font->GetPageGeneration(run.page) != run.pageGeneration) {
+            return false;
+        }
+    }
+    for (const TextLayoutRun &run : layout.runs) {
+        layout.font->MarkPageUsed(run.page);
+    }
+    return true;
 }
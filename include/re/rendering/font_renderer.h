@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <glad/glad.h>
 
 #include "shader.h"
@@ -10,24 +12,28 @@
 
 static const std::string &OPENGL_SHADER_SOURCE_VERTEX_FONT =
     "#version 330 core\n"
-    "layout (location = 0) in vec4 vertex; // (pos, tex)\n"
+    "layout (location = 0) in vec2 position;\n"
+    "layout (location = 1) in vec2 vertexTexCoords;\n"
+    "layout (location = 2) in vec4 vertexColor;\n"
     "\n"
     "out vec2 texCoords;\n"
+    "out vec4 textColor;\n"
     "\n"
     "uniform mat4 projection;\n"
     "\n"
     "void main() {\n"
-    "    gl_Position = projection * vec4(vertex.xy, 0.0f, 1.0f);\n"
-    "    texCoords = vertex.zw;\n"
+    "    gl_Position = projection * vec4(position, 0.0f, 1.0f);\n"
+    "    texCoords = vertexTexCoords;\n"
+    "    textColor = vertexColor;\n"
     "}";
 
 static const std::string &OPENGL_SHADER_SOURCE_FRAGMENT_FONT =
     "#version 330 core\n"
     "in vec2 texCoords;\n"
+    "in vec4 textColor;\n"
     "out vec4 color;\n"
     "\n"
     "uniform sampler2D textValue;\n"
-    "uniform vec4 textColor;\n"
     "\n"
     "void main() {\n"
     "    vec4 sampled = vec4(1.0f, 1.0f, 1.0f, texture(textValue, texCoords).r);\n"
@@ -39,6 +45,26 @@ static const OpenGLShaderSourceCode OPENGL_SHADER_SOURCE_FONT = OpenGLShaderSour
     .fragment = OPENGL_SHADER_SOURCE_FRAGMENT_FONT
 };
 
+// 128 in the distance field is on the outline, coverage ramps over one screen pixel whatever the text's scale
+static const std::string &OPENGL_SHADER_SOURCE_FRAGMENT_DISTANCE_FIELD_FONT =
+    "#version 330 core\n"
+    "in vec2 texCoords;\n"
+    "in vec4 textColor;\n"
+    "out vec4 color;\n"
+    "\n"
+    "uniform sampler2D textValue;\n"
+    "\n"
+    "void main() {\n"
+    "    float distance = texture(textValue, texCoords).r - 128.0f / 255.0f;\n"
+    "    float coverage = clamp(distance / max(fwidth(distance), 0.0001f) + 0.5f, 0.0f, 1.0f);\n"
+    "    color = textColor * vec4(1.0f, 1.0f, 1.0f, coverage);\n"
+    "}";
+
+static const OpenGLShaderSourceCode OPENGL_SHADER_SOURCE_DISTANCE_FIELD_FONT = OpenGLShaderSourceCode{
+    .vertex = OPENGL_SHADER_SOURCE_VERTEX_FONT,
+    .fragment = OPENGL_SHADER_SOURCE_FRAGMENT_DISTANCE_FIELD_FONT
+};
+
 struct FontDrawBatch {
     Font *font = nullptr;
     std::string text = "";
@@ -48,15 +74,67 @@ struct FontDrawBatch {
     Color color = Color(1.0f, 1.0f, 1.0f, 1.0f);
 };
 
+struct FontVertex {
+    GLfloat position[2];
+    GLfloat texCoords[2];
+    GLubyte color[4];
+};
+
+// Consecutive glyph quads of a layout that sample the same glyph cache page
+struct TextLayoutRun {
+    unsigned int page;
+    unsigned int pageGeneration;
+    size_t vertexCount;
+};
+
+// Glyph quads of a UTF-8 string laid out from the origin.  Callers whose text rarely changes keep one around so
+// drawing it skips the glyph walk, vertex colors are filled in when it's drawn.
+struct TextLayout {
+    Font *font = nullptr;
+    std::string text;
+    float scale = 0.0f;
+    // False while a glyph is missing because the glyph cache was full
+    bool isComplete = false;
+    std::vector<FontVertex> vertices;
+    std::vector<TextLayoutRun> runs;
+};
+
+// Glyph quads of every string drawn from the same glyph cache page are collected into one vertex buffer and drawn with
+// a single call, distance field fonts of different sizes sharing a cache share its batches too.  Pending text is drawn
+// when the page changes, the batch is full or 'Flush' is called, so anything drawn with another renderer in between has
+// to flush first to keep the draw order.  Layouts have to be updated in the frame they're drawn, that's what keeps
+// their glyphs in the cache.
 class FontRenderer {
   public:
     FontRenderer();
+    ~FontRenderer();
     void Draw(Font *font, const std::string &text, float x, float y, float scale = 1.0f, const Color color = Color(1.0f, 1.0f, 1.0f, 1.0f));
+    void DrawLayout(const TextLayout &layout, float x, float y, const Color color = Color(1.0f, 1.0f, 1.0f, 1.0f));
+    void Flush();
     void UpdateProjection();
+    unsigned int GetDrawCallCount() const;
+    void ResetDrawCallCount();
+    // Lays 'text' out into 'layout' unless it already holds the same font, text and scale and its glyphs are still
+    // cached, returns true if it did
+    static bool UpdateLayout(TextLayout &layout, Font *font, const std::string &text, float scale);
 
   private:
+    // Indices are 16 bit, four vertices per glyph
+    static const unsigned int MAX_BATCH_GLYPHS = 4096;
+
     Shader shader;
+    Shader distanceFieldShader;
+    GLuint quadVAO = 0;
+    GLuint quadVBO = 0;
+    GLuint quadEBO = 0;
     ProjectProperties *projectProperties = nullptr;
+    std::vector<FontVertex> vertices;
+    Font *batchFont = nullptr;
+    GLuint batchTexture = 0;
+    unsigned int drawCallCount = 0;
+    TextLayout drawLayout;
+
+    static bool IsLayoutCurrent(const TextLayout &layout, const Font *font, const std::string &text, float scale);
 
     static float ConvertMinMax(float input, float inputLow, float inputHigh, float outputLow, float outputHigh) {
         return (((input - inputLow) / (inputHigh - inputLow)) * (outputHigh - outputLow) + outputLow);
@@ -55,29 +55,47 @@ void Renderer2D::SubmitFontBatchItem(Font *font, const std::string &text, float
     rendererBatcher.BatchDrawFont(fontBatchItem, zIndex);
 }
 
+void Renderer2D::SubmitTextLayoutBatchItem(const TextLayout *layout, float x, float y, int zIndex, Color color) {
+    FontBatchItem fontBatchItem;
+    fontBatchItem.layout = layout;
+    fontBatchItem.x = x;
+    fontBatchItem.y = y;
+    fontBatchItem.color = color;
+    rendererBatcher.BatchDrawFont(fontBatchItem, zIndex);
+}
+
 void Renderer2D::FlushBatches() {
     assert(spriteRenderer != nullptr && "SpriteRenderer is NULL, initialize the Renderer2D before using!");
 
-    const RenderFlushFunction &renderFlushFunction = [this] (const int zIndex, const ZIndexDrawBatch &zIndexDrawBatch) {
-        // Draw Sprites
-        for (const SpriteBatchItem &spriteBatchItem : zIndexDrawBatch.spriteDrawBatches) {
-            spriteRenderer->Draw(spriteBatchItem.texture2D,
-                                 spriteBatchItem.sourceRectangle,
-                                 spriteBatchItem.destinationRectangle,
-                                 spriteBatchItem.rotation,
-                                 spriteBatchItem.color,
-                                 spriteBatchItem.flipX,
-                                 spriteBatchItem.flipY);
-        }
-        // Draw Font
-        for (const FontBatchItem &fontBatchItem : zIndexDrawBatch.fontDrawBatches) {
-            fontRenderer->Draw(fontBatchItem.font,
-                               fontBatchItem.text,
-                               fontBatchItem.x,
-                               fontBatchItem.y,
-                               fontBatchItem.scale,
-                               fontBatchItem.color);
+    // Switching between renderers flushes the other one's batch, both return right away when there's nothing pending
+    const SpriteFlushFunction &spriteFlushFunction = [this] (const SpriteBatchItem &spriteBatchItem) {
+        // Text from earlier z indices is drawn before sprites that may cover it
+        fontRenderer->Flush();
+        spriteRenderer->Draw(spriteBatchItem.texture2D,
+                             spriteBatchItem.sourceRectangle,
+                             spriteBatchItem.destinationRectangle,
+                             spriteBatchItem.rotation,
+                             spriteBatchItem.color,
+                             spriteBatchItem.flipX,
+                             spriteBatchItem.flipY);
+    };
+    const FontFlushFunction &fontFlushFunction = [this] (const FontBatchItem &fontBatchItem) {
+        // Sprites can stay batched across z indices until text has to be drawn over them
+        spriteRenderer->Flush();
+        if (fontBatchItem.layout != nullptr) {
+            fontRenderer->DrawLayout(*fontBatchItem.layout, fontBatchItem.x, fontBatchItem.y, fontBatchItem.color);
+            return;
         }
+        fontRenderer->Draw(fontBatchItem.font,
+                           fontBatchItem.text,
+                           fontBatchItem.x,
+                           fontBatchItem.y,
+                           fontBatchItem.scale,
+                           fontBatchItem.color);
     };
-    rendererBatcher.Flush(renderFlushFunction);
+    rendererBatcher.Flush(spriteFlushFunction, fontFlushFunction);
+    spriteRenderer->Flush();
+    fontRenderer->Flush();
+    // Glyphs drawn this frame may be evicted from the glyph caches from now on
+    Font::AdvanceFrame();
 }
@@ -11,6 +11,7 @@ class Renderer2D {
     void Initialize();
     void SubmitSpriteBatchItem(Texture *texture2D, Rect2 sourceRectangle, Rect2 destinationRectangle, int zIndex, float rotation = 0.0f, Color color = Color(1.0f, 1.0f, 1.0f), bool flipX = false, bool flipY = false);
     void SubmitFontBatchItem(Font *font, const std::string &text, float x, float y, int zIndex, float scale, Color color);
+    void SubmitTextLayoutBatchItem(const TextLayout *layout, float x, float y, int zIndex, Color color);
     void FlushBatches();
 
   private:
@@ -1,24 +1,120 @@
 #include "./renderer_batcher.h"
 
-void RendererBatcher::BatchDrawSprite(SpriteBatchItem spriteBatchItem, int zIndex) {
-    if (drawBatches.find(zIndex) == drawBatches.end()) {
-        drawBatches.emplace(zIndex, ZIndexDrawBatch{});
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include "./font_renderer.h"
+
+// Key layout from the most significant bit: z index (32), layer type (4), shader (4), texture (24)
+static const uint64_t LAYER_TYPE_SHIFT = 28;
+static const uint64_t SHADER_SHIFT = 24;
+static const uint32_t SHADER_MASK = 0xF;
+static const uint32_t TEXTURE_MASK = 0xFFFFFF;
+
+void RendererBatcher::BatchDrawSprite(const SpriteBatchItem &spriteBatchItem, int zIndex) {
+    // Sprites share one shader and are grouped by the atlas page they're drawn from
+    const uint32_t texture = spriteBatchItem.texture2D->GetAtlasPage()->GetID();
+    commands.emplace_back(DrawCommand{
+        CreateSortKey(zIndex, DrawLayerType::Sprite, 0, texture),
+        static_cast<uint32_t>(spriteItems.size())
+    });
+    spriteItems.emplace_back(spriteBatchItem);
+}
+
+void RendererBatcher::BatchDrawFont(const FontBatchItem &fontBatchItem, int zIndex) {
+    // Text is grouped by the page of its first glyphs, or the first page of fonts laid out while flushing
+    const Font *font = fontBatchItem.layout != nullptr ? fontBatchItem.layout->font : fontBatchItem.font;
+    uint32_t shader = 0;
+    uint32_t texture = 0;
+    if (font != nullptr) {
+        shader = static_cast<uint32_t>(font->GetRenderMode());
+        if (fontBatchItem.layout != nullptr && !fontBatchItem.layout->runs.empty()) {
+            texture = font->GetPageTextureID(fontBatchItem.layout->runs.front().page);
+        } else if (font->GetPageCount() > 0) {
+            texture = font->GetPageTextureID(0);
+        }
+    }
+    commands.emplace_back(DrawCommand{
+        CreateSortKey(zIndex, DrawLayerType::Font, shader, texture),
+        static_cast<uint32_t>(fontItemCount)
+    });
+    if (fontItemCount < fontItems.size()) {
+        fontItems[fontItemCount] = fontBatchItem;
+    } else {
+        fontItems.emplace_back(fontBatchItem);
     }
-    drawBatches[zIndex].spriteDrawBatches.emplace_back(spriteBatchItem);
+    fontItemCount++;
 }
 
-void RendererBatcher::BatchDrawFont(FontBatchItem fontBatchItem, int zIndex) {
-    if (drawBatches.find(zIndex) == drawBatches.end()) {
-        drawBatches.emplace(zIndex, ZIndexDrawBatch{});
+void RendererBatcher::Flush(const SpriteFlushFunction &spriteFlushFunction, const FontFlushFunction &fontFlushFunction) {
+    SortCommands();
+    for (const DrawCommand &command : commands) {
+        if (GetLayerType(command.sortKey) == DrawLayerType::Sprite) {
+            spriteFlushFunction(spriteItems[command.itemIndex]);
+        } else {
+            fontFlushFunction(fontItems[command.itemIndex]);
+        }
     }
-    drawBatches[zIndex].fontDrawBatches.emplace_back(fontBatchItem);
+    commands.clear();
+    spriteItems.clear();
+    fontItemCount = 0;
+}
+
+uint64_t RendererBatcher::CreateSortKey(int zIndex, DrawLayerType layerType, uint32_t shader, uint32_t texture) {
+    assert(shader <= SHADER_MASK && "Shader doesn't fit into the sort key!");
+    // Flipping the sign bit makes negative z indices compare below positive ones as unsigned values
+    const uint32_t biasedZIndex = static_cast<uint32_t>(zIndex) ^ 0x80000000u;
+    return (static_cast<uint64_t>(biasedZIndex) << 32)
+           | (static_cast<uint64_t>(layerType) << LAYER_TYPE_SHIFT)
+           | (static_cast<uint64_t>(shader & SHADER_MASK) << SHADER_SHIFT)
+           | (texture & TEXTURE_MASK);
 }
 
-void RendererBatcher::Flush(const RenderFlushFunction &renderFlushFunction) {
-    for (const auto &pair : drawBatches) {
-        const int zIndex = pair.first;
-        const ZIndexDrawBatch &zIndexDrawBatch = pair.second;
-        renderFlushFunction(zIndex, zIndexDrawBatch);
+RendererBatcher::DrawLayerType RendererBatcher::GetLayerType(uint64_t sortKey) {
+    return static_cast<DrawLayerType>((sortKey >> LAYER_TYPE_SHIFT) & 0xF);
+}
+
+// Least significant digit radix sort over the key's bytes, stable so equal keys keep their submission order.  Bytes
+// every key shares, like the upper z index bytes, are skipped.
+void RendererBatcher::SortCommands() {
+    static const size_t DIGIT_COUNT = sizeof(uint64_t);
+    static const size_t BUCKET_COUNT = 256;
+    const size_t commandCount = commands.size();
+    if (commandCount < 2) {
+        return;
+    }
+    sortedCommands.resize(commandCount);
+
+    size_t histograms[DIGIT_COUNT][BUCKET_COUNT];
+    std::memset(histograms, 0, sizeof(histograms));
+    for (const DrawCommand &command : commands) {
+        for (size_t digit = 0; digit < DIGIT_COUNT; digit++) {
+            histograms[digit][(command.sortKey >> (digit * 8)) & 0xFF]++;
+        }
+    }
+
+    DrawCommand* source = commands.data();
+    DrawCommand* destination = sortedCommands.data();
+    for (size_t digit = 0; digit < DIGIT_COUNT; digit++) {
+        const size_t shift = digit * 8;
+        size_t* histogram = histograms[digit];
+        if (histogram[(source[0].sortKey >> shift) & 0xFF] == commandCount) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            const size_t bucketSize = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketSize;
+        }
+        for (size_t i = 0; i < commandCount; i++) {
+            destination[histogram[(source[i].sortKey >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+    // Swapping the vectors keeps both allocations for the next frame
+    if (source != commands.data()) {
+        commands.swap(sortedCommands);
     }
-    drawBatches.clear();
 }
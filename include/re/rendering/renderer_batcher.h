@@ -1,8 +1,8 @@
 #pragma once
 
 #include <vector>
-#include <map>
 #include <string>
+#include <cstdint>
 #include <functional>
 
 #include "./texture.h"
@@ -20,6 +20,8 @@ struct SpriteBatchItem {
     bool flipY = false;
 };
 
+struct TextLayout;
+
 struct FontBatchItem {
     Font *font = nullptr;
     std::string text;
@@ -27,21 +29,40 @@ struct FontBatchItem {
     float y = 0.0f;
     float scale = 1.0f;
     Color color = Color(1.0f, 1.0f, 1.0f, 1.0f);
+    const TextLayout *layout = nullptr; // Drawn instead of 'font' and 'text' when set, has to outlive the flush
 };
 
-struct ZIndexDrawBatch {
-    std::vector<SpriteBatchItem> spriteDrawBatches;
-    std::vector<FontBatchItem> fontDrawBatches;
-};
-
-using RenderFlushFunction = std::function<void(const int zIndex, const ZIndexDrawBatch &zIndexDrawBatch)>;
+using SpriteFlushFunction = std::function<void(const SpriteBatchItem &spriteBatchItem)>;
+using FontFlushFunction = std::function<void(const FontBatchItem &fontBatchItem)>;
 
+// Submitted items are appended to flat arrays with one draw command each, the commands are radix sorted by a 64 bit key
+// when flushed.  Keys order by z index, then sprites before text, then shader and texture, items with equal keys stay
+// in submission order.  Every array is kept across frames so a steady scene submits without allocating.
 class RendererBatcher {
   public:
-    void BatchDrawSprite(SpriteBatchItem spriteBatchItem, int zIndex);
-    void BatchDrawFont(FontBatchItem fontBatchItem, int zIndex);
-    void Flush(const RenderFlushFunction &renderFlushFunction);
+    void BatchDrawSprite(const SpriteBatchItem &spriteBatchItem, int zIndex);
+    void BatchDrawFont(const FontBatchItem &fontBatchItem, int zIndex);
+    void Flush(const SpriteFlushFunction &spriteFlushFunction, const FontFlushFunction &fontFlushFunction);
 
   private:
-    std::map<int, ZIndexDrawBatch> drawBatches;
+    enum class DrawLayerType : uint64_t {
+        Sprite = 0,
+        Font = 1
+    };
+
+    struct DrawCommand {
+        uint64_t sortKey;
+        uint32_t itemIndex; // Into the sprite or font items, depending on the key's layer type
+    };
+
+    std::vector<SpriteBatchItem> spriteItems;
+    // Slots past 'fontItemCount' are left from earlier frames so their strings' storage gets reused
+    std::vector<FontBatchItem> fontItems;
+    size_t fontItemCount = 0;
+    std::vector<DrawCommand> commands;
+    std::vector<DrawCommand> sortedCommands;
+
+    static uint64_t CreateSortKey(int zIndex, DrawLayerType layerType, uint32_t shader, uint32_t texture);
+    static DrawLayerType GetLayerType(uint64_t sortKey);
+    void SortCommands();
 };
@@ -1,30 +1,31 @@
 #include "sprite_renderer.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 #include <glm/gtc/matrix_transform.hpp>
 
+static GLubyte NormalizedToByte(float value) {
+    return static_cast<GLubyte>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
 SpriteRenderer::SpriteRenderer() : projectProperties(ProjectProperties::GetInstance()) {
-    GLfloat vertices[] = {
-        // positions // texture coordinates
-        0.0f, 1.0f, 0.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f,
-
-        0.0f, 1.0f, 0.0f, 1.0f,
-        1.0f, 1.0f, 1.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f
-    };
-
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &quadVBO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindVertexArray(quadVAO);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*) nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    instances.reserve(MAX_BATCH_SPRITES);
+
+    glGenVertexArrays(1, &instanceVAO);
+    glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(instanceVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, RING_SECTION_COUNT * RING_SECTION_SPRITES * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+    for (GLuint attribute = 0; attribute < 5; attribute++) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    SetInstanceAttributes(0);
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     shader = Shader(OPENGL_SHADER_SOURCE_SPRITE);
     shader.Use();
@@ -33,74 +34,103 @@ SpriteRenderer::SpriteRenderer() : projectProperties(ProjectProperties::GetInsta
     shader.SetMatrix4Float("projection", projection);
 }
 
+SpriteRenderer::~SpriteRenderer() {
+    for (GLsync &fence : ringSectionFences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteVertexArrays(1, &instanceVAO);
+}
+
 void
 SpriteRenderer::Draw(Texture *texture2D, const Rect2 &sourceRectangle, const Rect2 &destinationRectangle, float rotation, const Color &color,
                      bool flipX, bool flipY) {
-    // 1. Translation
-    Matrix4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(destinationRectangle.x, destinationRectangle.y, 0.0f));  // first translate (transformations are: scale happens first, then rotation, and then final translation happens; reversed order)
-    // 2. Rotation
-    model = glm::translate(model, Vector3(0.5f * destinationRectangle.w, 0.5f * destinationRectangle.h, 0.0f)); // move origin of rotation to center of quad
-    model = glm::rotate(model, glm::radians(rotation), Vector3(0.0f, 0.0f, 1.0f)); // then rotate
-    model = glm::translate(model, Vector3(-0.5f * destinationRectangle.w, -0.5f * destinationRectangle.h, 0.0f)); // move origin back
-    // 3. Scaling
-    model = glm::scale(model, Vector3(destinationRectangle.w, destinationRectangle.h, 1.0f)); // last scale
-
-    glBindVertexArray(quadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    // Textures packed into the same atlas page share a batch
+    const Texture* page = texture2D->GetAtlasPage();
+    if (page != batchTexture || instances.size() >= MAX_BATCH_SPRITES) {
+        Flush();
+        batchTexture = page;
+    }
 
-    shader.Use();
-    shader.SetMatrix4Float("model", model);
-    shader.SetVec4Float("spriteColor", color.r, color.g, color.b, color.a);
+    // Source rectangles are in the texture's own pixels, atlas regions are offset into their page
+    const float pageWidth = static_cast<float>(page->GetWidth());
+    const float pageHeight = static_cast<float>(page->GetHeight());
+    const float sourceX = static_cast<float>(texture2D->GetAtlasX()) + sourceRectangle.x;
+    const float sourceY = static_cast<float>(texture2D->GetAtlasY()) + sourceRectangle.y;
+    instances.emplace_back(SpriteInstance{
+        { destinationRectangle.x, destinationRectangle.y, destinationRectangle.w, destinationRectangle.h },
+        { sourceX / pageWidth, sourceY / pageHeight, (sourceX + sourceRectangle.w) / pageWidth, (sourceY + sourceRectangle.h) / pageHeight },
+        rotation,
+        { NormalizedToByte(color.r), NormalizedToByte(color.g), NormalizedToByte(color.b), NormalizedToByte(color.a) },
+        (flipX ? SPRITE_FLIP_X : 0) | (flipY ? SPRITE_FLIP_Y : 0)
+    });
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    texture2D->Bind();
-
-    // render subimage based on source rectangle
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, texture2D->GetWidth());
-    glPixelStorei(GL_UNPACK_SKIP_PIXELS, sourceRectangle.x);
-    glPixelStorei(GL_UNPACK_SKIP_ROWS, sourceRectangle.y);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sourceRectangle.w, sourceRectangle.h, 0, texture2D->GetImageFormat(), GL_UNSIGNED_BYTE, texture2D->GetData());
-
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
-    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
-
-    // Render Container
-    GLfloat vertices[6][4] = {
-        // positions // texture coordinates
-        0.0f, 1.0f, 0.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 0.0f,
-
-        0.0f, 1.0f, 0.0f, 1.0f,
-        1.0f, 1.0f, 1.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f
-    };
-
-    static const int VERT_X = 2;
-    static const int VERT_Y = 3;
-    if (flipX) {
-        vertices[0][VERT_X] = 1.0f;
-        vertices[1][VERT_X] = 0.0f;
-        vertices[2][VERT_X] = 1.0f;
-        vertices[3][VERT_X] = 1.0f;
-        vertices[4][VERT_X] = 0.0f;
-        vertices[5][VERT_X] = 0.0f;
+void SpriteRenderer::Flush() {
+    if (instances.empty()) {
+        return;
     }
+    const unsigned int instanceCount = static_cast<unsigned int>(instances.size());
+    const unsigned int firstInstance = ReserveRingSpace(instanceCount);
+
+    glBindVertexArray(instanceVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // The section's fence has already been waited on, so the driver doesn't need to synchronize the write
+    void* mappedInstances = glMapBufferRange(GL_ARRAY_BUFFER, firstInstance * sizeof(SpriteInstance), instanceCount * sizeof(SpriteInstance),
+                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    std::memcpy(mappedInstances, instances.data(), instanceCount * sizeof(SpriteInstance));
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    SetInstanceAttributes(firstInstance);
 
-    if (flipY) {
-        vertices[0][VERT_Y] = 0.0f;
-        vertices[1][VERT_Y] = 1.0f;
-        vertices[2][VERT_Y] = 1.0f;
-        vertices[3][VERT_Y] = 0.0f;
-        vertices[4][VERT_Y] = 0.0f;
-        vertices[5][VERT_Y] = 1.0f;
-    }
+    shader.Use();
+    glActiveTexture(GL_TEXTURE0);
+    batchTexture->Bind();
 
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instanceCount));
+    drawCallCount++;
 
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    instances.clear();
+}
+
+unsigned int SpriteRenderer::GetDrawCallCount() const {
+    return drawCallCount;
+}
+
+void SpriteRenderer::ResetDrawCallCount() {
+    drawCallCount = 0;
+}
+
+// Batches are appended to the current section, a batch that doesn't fit fences the section and moves on to the next
+// one once the GPU is done reading it
+unsigned int SpriteRenderer::ReserveRingSpace(unsigned int instanceCount) {
+    const unsigned int sectionEnd = (ringSection + 1) * RING_SECTION_SPRITES;
+    if (ringWriteIndex + instanceCount > sectionEnd) {
+        ringSectionFences[ringSection] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        ringSection = (ringSection + 1) % RING_SECTION_COUNT;
+        ringWriteIndex = ringSection * RING_SECTION_SPRITES;
+        GLsync &fence = ringSectionFences[ringSection];
+        if (fence != nullptr) {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    const unsigned int firstInstance = ringWriteIndex;
+    ringWriteIndex += instanceCount;
+    return firstInstance;
+}
+
+// Core 3.3 has no base instance for draws, so the attributes are pointed at the batch's first record instead
+void SpriteRenderer::SetInstanceAttributes(unsigned int firstInstance) const {
+    const size_t baseOffset = firstInstance * sizeof(SpriteInstance);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*) (baseOffset + offsetof(SpriteInstance, destination)));
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*) (baseOffset + offsetof(SpriteInstance, textureRectangle)));
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*) (baseOffset + offsetof(SpriteInstance, rotation)));
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteInstance), (void*) (baseOffset + offsetof(SpriteInstance, color)));
+    glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, sizeof(SpriteInstance), (void*) (baseOffset + offsetof(SpriteInstance, flipFlags)));
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <glad/glad.h>
 
 #include "shader.h"
@@ -9,19 +11,42 @@
 
 #include "re/project_properties.h"
 
+// Each instance is one sprite, the quad's corners come from gl_VertexID and are rotated around the sprite's center
 static const std::string &OPENGL_SHADER_SOURCE_VERTEX_SPRITE =
     "#version 330 core\n"
     "\n"
-    "layout (location = 0) in vec4 vertex;\n"
+    "layout (location = 0) in vec4 destination;\n"
+    "layout (location = 1) in vec4 textureRectangle;\n"
+    "layout (location = 2) in float rotation;\n"
+    "layout (location = 3) in vec4 instanceColor;\n"
+    "layout (location = 4) in uint flipFlags;\n"
     "\n"
     "out vec2 texCoord;\n"
+    "out vec4 spriteColor;\n"
     "\n"
     "uniform mat4 projection;\n"
-    "uniform mat4 model;\n"
+    "\n"
+    "// Triangle strip order: top left, top right, bottom left, bottom right\n"
+    "const vec2 CORNERS[4] = vec2[4](vec2(-1.0f, -1.0f), vec2(1.0f, -1.0f), vec2(-1.0f, 1.0f), vec2(1.0f, 1.0f));\n"
     "\n"
     "void main() {\n"
-    "    texCoord = vertex.zw;\n"
-    "    gl_Position = projection * model * vec4(vertex.xy, 0.0f, 1.0f);\n"
+    "    vec2 corner = CORNERS[gl_VertexID];\n"
+    "    vec2 halfSize = 0.5f * destination.zw;\n"
+    "    vec2 offset = corner * halfSize;\n"
+    "    float angle = radians(rotation);\n"
+    "    float cosine = cos(angle);\n"
+    "    float sine = sin(angle);\n"
+    "    vec2 position = destination.xy + halfSize + vec2(offset.x * cosine - offset.y * sine, offset.x * sine + offset.y * cosine);\n"
+    "    vec2 textureCorner = 0.5f * corner + 0.5f;\n"
+    "    if ((flipFlags & 1u) != 0u) {\n"
+    "        textureCorner.x = 1.0f - textureCorner.x;\n"
+    "    }\n"
+    "    if ((flipFlags & 2u) != 0u) {\n"
+    "        textureCorner.y = 1.0f - textureCorner.y;\n"
+    "    }\n"
+    "    texCoord = mix(textureRectangle.xy, textureRectangle.zw, textureCorner);\n"
+    "    spriteColor = instanceColor;\n"
+    "    gl_Position = projection * vec4(position, 0.0f, 1.0f);\n"
     "}\n"
     "";
 
@@ -29,10 +54,10 @@ static const std::string &OPENGL_SHADER_SOURCE_FRAGMENT_SPRITE =
     "#version 330 core\n"
     "\n"
     "in vec2 texCoord;\n"
+    "in vec4 spriteColor;\n"
     "out vec4 color;\n"
     "\n"
     "uniform sampler2D sprite;\n"
-    "uniform vec4 spriteColor;\n"
     "\n"
     "void main() {\n"
     "    color = spriteColor * texture(sprite, texCoord);\n"
@@ -44,16 +69,51 @@ static const OpenGLShaderSourceCode OPENGL_SHADER_SOURCE_SPRITE = OpenGLShaderSo
     .fragment = OPENGL_SHADER_SOURCE_FRAGMENT_SPRITE
 };
 
-class SpriteRenderer {
-  private:
-    Shader shader;
-    GLuint quadVAO;
-    GLuint quadVBO;
-    ProjectProperties *projectProperties = nullptr;
+static const GLuint SPRITE_FLIP_X = 1;
+static const GLuint SPRITE_FLIP_Y = 2;
+
+// One sprite as drawn, the quad is expanded and rotated in the vertex shader
+struct SpriteInstance {
+    GLfloat destination[4]; // x, y, width, height
+    GLfloat textureRectangle[4]; // Left, top, right and bottom texture coordinates in the texture or atlas page
+    GLfloat rotation; // Degrees
+    GLubyte color[4];
+    GLuint flipFlags;
+};
 
+// Sprites are collected into instance records and drawn with a single instanced call per run of sprites sharing a
+// texture or atlas page.  Pending sprites are drawn when the texture changes, the batch is full or 'Flush' is called, so
+// anything drawn with another renderer in between has to flush first to keep the draw order.
+// Records are written into a ring buffer split into sections guarded by fences, so a batch never waits on the GPU
+// reading an earlier one unless the whole ring is still in flight.
+class SpriteRenderer {
   public:
     SpriteRenderer();
+    ~SpriteRenderer();
 
     void Draw(Texture *texture2D, const Rect2 &sourceRectangle, const Rect2 &destinationRectangle, float rotation,
               const Color &color, bool flipX, bool flipY);
+    void Flush();
+    unsigned int GetDrawCallCount() const;
+    void ResetDrawCallCount();
+
+  private:
+    static const unsigned int MAX_BATCH_SPRITES = 4096;
+    // Sections hold a few full batches, about a frame's worth, so the ring only wraps onto a section a couple of frames old
+    static const unsigned int RING_SECTION_SPRITES = MAX_BATCH_SPRITES * 4;
+    static const unsigned int RING_SECTION_COUNT = 3;
+
+    Shader shader;
+    GLuint instanceVAO = 0;
+    GLuint instanceVBO = 0;
+    ProjectProperties *projectProperties = nullptr;
+    std::vector<SpriteInstance> instances;
+    const Texture *batchTexture = nullptr;
+    unsigned int drawCallCount = 0;
+    unsigned int ringSection = 0;
+    unsigned int ringWriteIndex = 0; // In instances, from the start of the buffer
+    GLsync ringSectionFences[RING_SECTION_COUNT] = {};
+
+    unsigned int ReserveRingSpace(unsigned int instanceCount);
+    void SetInstanceAttributes(unsigned int firstInstance) const;
 };
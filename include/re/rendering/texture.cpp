@@ -1,5 +1,7 @@
 #include "texture.h"
 
+#include <cstdlib>
+
 #include <stb_image/stb_image.h>
 
 Texture::Texture(const char* filePath, unsigned int wrapS, unsigned int wrapT, unsigned int filterMin, unsigned int filterMag) :
@@ -33,7 +35,8 @@ Texture::Texture(unsigned int width, unsigned int height, unsigned int colorValu
     width(width),
     height(height),
     logger(Logger::GetInstance()) {
-    data = new unsigned char[width * height * 4];
+    // Freed with the loaded images' stbi_image_free
+    data = static_cast<unsigned char*>(std::malloc(width * height * 4));
     for(int i = 0; i < (int)(width * height * 4); i++) {
         data[i] = colorValue;
     }
@@ -44,6 +47,36 @@ Texture::Texture(unsigned int width, unsigned int height, unsigned int colorValu
     }
 }
 
+Texture::Texture(unsigned int width, unsigned int height, unsigned char* rgbaData, const std::string &filterMin, const std::string &filterMag) :
+    logger(Logger::GetInstance()),
+    data(rgbaData),
+    width(width),
+    height(height),
+    nrChannels(4) {
+    this->filterMin = GetFilterFromString(filterMin);
+    this->filterMag = GetFilterFromString(filterMag);
+    if(IsValid()) {
+        Generate();
+    } else {
+        logger->Error("Failed to create texture from pixel data");
+    }
+}
+
+Texture::Texture(const Texture* atlasPage, const std::string &filePath, int atlasX, int atlasY, int width, int height) :
+    logger(Logger::GetInstance()),
+    fileName(filePath),
+    ID(atlasPage->ID),
+    width(width),
+    height(height),
+    nrChannels(4),
+    wrapS(atlasPage->wrapS),
+    wrapT(atlasPage->wrapT),
+    filterMin(atlasPage->filterMin),
+    filterMag(atlasPage->filterMag),
+    atlasPage(atlasPage),
+    atlasX(atlasX),
+    atlasY(atlasY) {}
+
 Texture::~Texture() {
     stbi_image_free(data);
     data = nullptr;
@@ -104,6 +137,10 @@ std::string Texture::GetFilePath() const {
     return fileName;
 }
 
+unsigned int Texture::GetID() const {
+    return ID;
+}
+
 int Texture::GetWidth() const {
     return width;
 }
@@ -121,8 +158,20 @@ unsigned char* Texture::GetData() const {
 }
 
 bool Texture::IsValid() const {
-    if(data) {
+    if(data || atlasPage) {
         return true;
     }
     return false;
 }
+
+const Texture* Texture::GetAtlasPage() const {
+    return atlasPage ? atlasPage : this;
+}
+
+int Texture::GetAtlasX() const {
+    return atlasX;
+}
+
+int Texture::GetAtlasY() const {
+    return atlasY;
+}
@@ -9,14 +9,23 @@ class Texture {
     Texture(const char* filePath, unsigned int wrapS = GL_CLAMP_TO_BORDER, unsigned int wrapT = GL_CLAMP_TO_BORDER, unsigned int filterMin = GL_NEAREST, unsigned int filterMag = GL_NEAREST);
     Texture(const char* filePath, const std::string &wrapS, const std::string &wrapT, const std::string &filterMin, const std::string &filterMag);
     Texture(unsigned int width, unsigned int height, unsigned int colorValue = 255); // colorValue default to white
+    // Takes ownership of 'rgbaData', which has to be allocated with malloc
+    Texture(unsigned int width, unsigned int height, unsigned char* rgbaData, const std::string &filterMin, const std::string &filterMag);
+    // Region of an atlas page, shares the page's GL texture and has no pixel data of its own
+    Texture(const Texture* atlasPage, const std::string &filePath, int atlasX, int atlasY, int width, int height);
     ~Texture();
     void Bind() const;
+    unsigned int GetID() const;
     std::string GetFilePath() const;
     int GetWidth() const;
     int GetHeight() const;
     unsigned int GetImageFormat() const;
     unsigned char* GetData() const;
     bool IsValid() const;
+    // Texture to bind and compute texture coordinates against, the texture itself unless it's in an atlas
+    const Texture* GetAtlasPage() const;
+    int GetAtlasX() const;
+    int GetAtlasY() const;
 
   private:
     Logger *logger = nullptr;
@@ -34,6 +43,9 @@ class Texture {
     GLint wrapT = GL_CLAMP_TO_BORDER;
     GLint filterMin = GL_NEAREST;
     GLint filterMag = GL_NEAREST;
+    const Texture* atlasPage = nullptr;
+    int atlasX = 0;
+    int atlasY = 0;
 
     void Generate();
     unsigned int GetWrapFromString(const std::string &wrap) const;
@@ -0,0 +1,234 @@
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#include <stb_image/stb_image.h>
+
+// Repeating images sample past their own edges, which would show their neighbours on a page
+static bool IsPackableWrap(const std::string &wrap) {
+    return wrap == "clamp_to_border" || wrap == "clamp_to_edge";
+}
+
+TextureAtlas::TextureAtlas(const TextureAtlasSettings &settings) : settings(settings) {}
+
+TextureAtlas::~TextureAtlas() {
+    for (AtlasImage &image : images) {
+        stbi_image_free(image.data);
+    }
+    for (Texture* pageTexture : pageTextures) {
+        delete pageTexture;
+    }
+}
+
+bool TextureAtlas::AddImageFile(const std::string &id, const std::string &filePath, const std::string &wrapS, const std::string &wrapT, const std::string &filterMin, const std::string &filterMag) {
+    // Header only, so images that won't be packed aren't decoded twice
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    if (!stbi_info(filePath.c_str(), &width, &height, &channels)) {
+        return false;
+    }
+    if (!IsPackable(width, height, wrapS, wrapT)) {
+        return false;
+    }
+    stbi_set_flip_vertically_on_load(false);
+    unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, 4);
+    if (!data) {
+        return false;
+    }
+    return AddImage(id, data, width, height, wrapS, wrapT, filterMin, filterMag);
+}
+
+bool TextureAtlas::AddImage(const std::string &id, unsigned char* rgbaData, int width, int height, const std::string &wrapS, const std::string &wrapT, const std::string &filterMin, const std::string &filterMag) {
+    if (!IsPackable(width, height, wrapS, wrapT)) {
+        return false;
+    }
+    AtlasImage image;
+    image.id = id;
+    image.data = rgbaData;
+    image.width = width;
+    image.height = height;
+    image.extrudeS = wrapS == "clamp_to_edge";
+    image.extrudeT = wrapT == "clamp_to_edge";
+    image.filterMin = filterMin;
+    image.filterMag = filterMag;
+    images.emplace_back(image);
+    return true;
+}
+
+bool TextureAtlas::IsPackable(int width, int height, const std::string &wrapS, const std::string &wrapT) const {
+    const int paddedWidth = width + settings.padding * 2;
+    const int paddedHeight = height + settings.padding * 2;
+    return IsPackableWrap(wrapS) && IsPackableWrap(wrapT) && width > 0 && height > 0
+           && paddedWidth <= settings.pageSize && paddedHeight <= settings.pageSize;
+}
+
+std::unordered_map<std::string, Texture*> TextureAtlas::Build() {
+    std::unordered_map<std::string, Texture*> regionTextures;
+    // Tallest first keeps the skyline flat, which wastes the least space
+    std::vector<size_t> packOrder(images.size());
+    for (size_t i = 0; i < images.size(); i++) {
+        packOrder[i] = i;
+    }
+    std::stable_sort(packOrder.begin(), packOrder.end(), [this](size_t a, size_t b) {
+        if (images[a].height != images[b].height) {
+            return images[a].height > images[b].height;
+        }
+        return images[a].width > images[b].width;
+    });
+    for (size_t imageIndex : packOrder) {
+        PlaceImage(images[imageIndex]);
+    }
+
+    // Pages are trimmed to the space used, a page holding a few small images stays small
+    std::vector<unsigned char*> pageData(pages.size());
+    for (size_t pageIndex = 0; pageIndex < pages.size(); pageIndex++) {
+        const AtlasPage &page = pages[pageIndex];
+        pageData[pageIndex] = static_cast<unsigned char*>(std::calloc(static_cast<size_t>(page.usedWidth) * page.usedHeight, 4));
+        pagePixelCount += static_cast<size_t>(page.usedWidth) * page.usedHeight;
+    }
+    for (AtlasImage &image : images) {
+        CopyImageToPage(image, pageData[image.pageIndex], pages[image.pageIndex].usedWidth);
+        packedPixelCount += static_cast<size_t>(image.width) * image.height;
+        stbi_image_free(image.data);
+        image.data = nullptr;
+    }
+    for (size_t pageIndex = 0; pageIndex < pages.size(); pageIndex++) {
+        const AtlasPage &page = pages[pageIndex];
+        pageTextures.emplace_back(new Texture(page.usedWidth, page.usedHeight, pageData[pageIndex], page.filterMin, page.filterMag));
+    }
+    for (const AtlasImage &image : images) {
+        Texture* regionTexture = new Texture(pageTextures[image.pageIndex], image.id, image.x, image.y, image.width, image.height);
+        regionTextures.emplace(image.id, regionTexture);
+    }
+    return regionTextures;
+}
+
+size_t TextureAtlas::GetPageCount() const {
+    return pages.size();
+}
+
+size_t TextureAtlas::GetImageCount() const {
+    return images.size();
+}
+
+float TextureAtlas::GetPageUsage() const {
+    if (pagePixelCount == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(packedPixelCount) / static_cast<float>(pagePixelCount);
+}
+
+bool TextureAtlas::PlaceImage(AtlasImage &image) {
+    const int paddedWidth = image.width + settings.padding * 2;
+    const int paddedHeight = image.height + settings.padding * 2;
+    // Pages only share a GL texture's filtering, so images are kept on pages with the same filters
+    for (size_t pageIndex = 0; pageIndex <= pages.size(); pageIndex++) {
+        if (pageIndex == pages.size()) {
+            AtlasPage newPage;
+            newPage.filterMin = image.filterMin;
+            newPage.filterMag = image.filterMag;
+            newPage.skyline.emplace_back(SkylineSegment{ 0, 0, settings.pageSize });
+            pages.emplace_back(newPage);
+        }
+        AtlasPage &page = pages[pageIndex];
+        if (page.filterMin != image.filterMin || page.filterMag != image.filterMag) {
+            continue;
+        }
+        int x = 0;
+        int y = 0;
+        size_t segmentIndex = 0;
+        if (!FindSkylinePosition(page, paddedWidth, paddedHeight, x, y, segmentIndex)) {
+            continue;
+        }
+        AddSkylineSegment(page, segmentIndex, x, y + paddedHeight, paddedWidth);
+        page.usedWidth = std::max(page.usedWidth, x + paddedWidth);
+        page.usedHeight = std::max(page.usedHeight, y + paddedHeight);
+        image.pageIndex = pageIndex;
+        image.x = x + settings.padding;
+        image.y = y + settings.padding;
+        return true;
+    }
+    return false;
+}
+
+// Bottom left rule, the position whose top stays lowest on the skyline wins and ties go to the leftmost
+bool TextureAtlas::FindSkylinePosition(const AtlasPage &page, int width, int height, int &outX, int &outY, size_t &outSegmentIndex) const {
+    bool isFound = false;
+    int bestTop = settings.pageSize + 1;
+    for (size_t segmentIndex = 0; segmentIndex < page.skyline.size(); segmentIndex++) {
+        const int x = page.skyline[segmentIndex].x;
+        if (x + width > settings.pageSize) {
+            break;
+        }
+        // Resting on the highest segment under the image's width
+        int y = 0;
+        int coveredWidth = 0;
+        for (size_t i = segmentIndex; i < page.skyline.size() && coveredWidth < width; i++) {
+            y = std::max(y, page.skyline[i].y);
+            coveredWidth += page.skyline[i].width;
+        }
+        if (y + height > settings.pageSize || y + height >= bestTop) {
+            continue;
+        }
+        bestTop = y + height;
+        outX = x;
+        outY = y;
+        outSegmentIndex = segmentIndex;
+        isFound = true;
+    }
+    return isFound;
+}
+
+void TextureAtlas::AddSkylineSegment(AtlasPage &page, size_t segmentIndex, int x, int y, int width) {
+    std::vector<SkylineSegment> &skyline = page.skyline;
+    skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(segmentIndex), SkylineSegment{ x, y, width });
+    // Segments now under the new one are shortened or removed
+    for (size_t i = segmentIndex + 1; i < skyline.size();) {
+        const SkylineSegment &previous = skyline[i - 1];
+        SkylineSegment &segment = skyline[i];
+        const int overlap = previous.x + previous.width - segment.x;
+        if (overlap <= 0) {
+            break;
+        }
+        if (segment.width <= overlap) {
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+            continue;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        break;
+    }
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        } else {
+            i++;
+        }
+    }
+}
+
+// Padding repeats the image's edge pixels for axes clamped to edge, the rest stays transparent like a clamped border
+void TextureAtlas::CopyImageToPage(const AtlasImage &image, unsigned char* pageData, int pageWidth) const {
+    const int padding = settings.padding;
+    for (int row = -padding; row < image.height + padding; row++) {
+        const bool isPaddingRow = row < 0 || row >= image.height;
+        if (isPaddingRow && !image.extrudeT) {
+            continue;
+        }
+        const int sourceRow = std::min(std::max(row, 0), image.height - 1);
+        const unsigned char* sourceRowData = image.data + static_cast<size_t>(sourceRow) * image.width * 4;
+        unsigned char* pageRowData = pageData + (static_cast<size_t>(image.y + row) * pageWidth + image.x) * 4;
+        std::memcpy(pageRowData, sourceRowData, static_cast<size_t>(image.width) * 4);
+        if (image.extrudeS) {
+            for (int column = 1; column <= padding; column++) {
+                std::memcpy(pageRowData - column * 4, sourceRowData, 4);
+                std::memcpy(pageRowData + (image.width - 1 + column) * 4, sourceRowData + (image.width - 1) * 4, 4);
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "texture.h"
+
+struct TextureAtlasSettings {
+    int pageSize = 2048; // Largest width and height of a page
+    int padding = 2; // Pixels kept around every image so filtering never reaches into a neighbour
+};
+
+// Packs images into a few shared pages at load time so sprites cut from different images can be drawn in one batch.
+// Every packed image becomes a region texture that keeps its own size and shares its page's GL texture, so source
+// rectangles stay in image pixels.  Images that repeat or don't fit on a page are left to be loaded on their own.
+class TextureAtlas {
+  public:
+    explicit TextureAtlas(const TextureAtlasSettings &settings);
+    ~TextureAtlas();
+
+    // Returns false when the image can't be packed, it should then be loaded as a standalone texture
+    bool AddImageFile(const std::string &id, const std::string &filePath, const std::string &wrapS, const std::string &wrapT, const std::string &filterMin, const std::string &filterMag);
+    // Takes ownership of 'rgbaData' (allocated with malloc) only when the image is packed
+    bool AddImage(const std::string &id, unsigned char* rgbaData, int width, int height, const std::string &wrapS, const std::string &wrapT, const std::string &filterMin, const std::string &filterMag);
+    // Packs and uploads every added image.  Pages belong to the atlas, the returned region textures to the caller.
+    std::unordered_map<std::string, Texture*> Build();
+    size_t GetPageCount() const;
+    size_t GetImageCount() const;
+    // Share of the uploaded page pixels covered by images
+    float GetPageUsage() const;
+
+  private:
+    struct AtlasImage {
+        std::string id;
+        unsigned char* data = nullptr;
+        int width = 0;
+        int height = 0;
+        bool extrudeS = false; // Clamped to edge, otherwise the padding stays transparent like a clamped border
+        bool extrudeT = false;
+        std::string filterMin;
+        std::string filterMag;
+        size_t pageIndex = 0;
+        int x = 0;
+        int y = 0;
+    };
+
+    struct SkylineSegment {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct AtlasPage {
+        std::string filterMin;
+        std::string filterMag;
+        std::vector<SkylineSegment> skyline;
+        int usedWidth = 0;
+        int usedHeight = 0;
+    };
+
+    TextureAtlasSettings settings;
+    std::vector<AtlasImage> images;
+    std::vector<AtlasPage> pages;
+    std::vector<Texture*> pageTextures;
+    size_t packedPixelCount = 0;
+    size_t pagePixelCount = 0;
+
+    bool IsPackable(int width, int height, const std::string &wrapS, const std::string &wrapT) const;
+    bool PlaceImage(AtlasImage &image);
+    bool FindSkylinePosition(const AtlasPage &page, int width, int height, int &outX, int &outY, size_t &outSegmentIndex) const;
+    static void AddSkylineSegment(AtlasPage &page, size_t segmentIndex, int x, int y, int width);
+    void CopyImageToPage(const AtlasImage &image, unsigned char* pageData, int pageWidth) const;
+};
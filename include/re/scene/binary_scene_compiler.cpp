@@ -0,0 +1,308 @@
+#include "binary_scene_compiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "scene_node_naming.h"
+#include "../utils/json_helper.h"
+#include "../utils/file_helper.h"
+
+using namespace BinarySceneFormat;
+
+template<typename T>
+static void AppendRecord(std::vector<char>& bytes, const T& record) {
+    const char* recordBytes = reinterpret_cast<const char*>(&record);
+    bytes.insert(bytes.end(), recordBytes, recordBytes + sizeof(T));
+}
+
+static void AlignToFourBytes(std::vector<char>& bytes) {
+    bytes.resize((bytes.size() + 3) & ~static_cast<size_t>(3), 0);
+}
+
+static void ReadNormalizedColor(const nlohmann::json& colorJson, float* color) {
+    color[0] = JsonHelper::Get<int>(colorJson, "red") / 255.0f;
+    color[1] = JsonHelper::Get<int>(colorJson, "green") / 255.0f;
+    color[2] = JsonHelper::Get<int>(colorJson, "blue") / 255.0f;
+    color[3] = JsonHelper::Get<int>(colorJson, "alpha") / 255.0f;
+}
+
+static void ReadDrawSource(const nlohmann::json& drawSourceJson, float* drawSource) {
+    drawSource[0] = JsonHelper::Get<float>(drawSourceJson, "x");
+    drawSource[1] = JsonHelper::Get<float>(drawSourceJson, "y");
+    drawSource[2] = JsonHelper::Get<float>(drawSourceJson, "width");
+    drawSource[3] = JsonHelper::Get<float>(drawSourceJson, "height");
+}
+
+bool BinarySceneCompiler::CompileSceneFile(const std::string& sceneFilePath, const std::string& outputFilePath) {
+    if (!FileHelper::DoesFileExist(sceneFilePath)) {
+        std::cerr << "Scene file '" << sceneFilePath << "' not found!" << std::endl;
+        return false;
+    }
+    const std::vector<char> compiledScene = CompileSceneJson(JsonFileHelper::LoadJsonFile(sceneFilePath), sceneFilePath);
+    std::ofstream outputFile(outputFilePath, std::ios::binary | std::ios::trunc);
+    if (!outputFile.write(compiledScene.data(), compiledScene.size())) {
+        std::cerr << "Failed to write compiled scene '" << outputFilePath << "'!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::vector<char> BinarySceneCompiler::CompileSceneJson(const nlohmann::json& sceneJson, const std::string& sceneFilePath) {
+    std::vector<std::string> externalSceneFilePaths;
+    return CompileSceneJson(sceneJson, sceneFilePath, externalSceneFilePaths);
+}
+
+std::vector<char> BinarySceneCompiler::CompileSceneJson(const nlohmann::json& sceneJson, const std::string& sceneFilePath, std::vector<std::string>& externalSceneFilePaths) {
+    BinarySceneCompiler compiler;
+    if (!sceneFilePath.empty()) {
+        compiler.externalSceneStack.emplace_back(sceneFilePath);
+    }
+    compiler.CompileNode(sceneJson, NO_PARENT, JsonHelper::Get<std::string>(sceneJson, "name"));
+    externalSceneFilePaths.assign(compiler.externalSceneFilePaths.begin(), compiler.externalSceneFilePaths.end());
+    // Stored so loaders can tell the compiled scene is stale when any inlined scene changed
+    for (const std::string& externalSceneFilePath : externalSceneFilePaths) {
+        compiler.dependencies.emplace_back(compiler.AddString(externalSceneFilePath));
+    }
+    return compiler.Assemble();
+}
+
+uint32_t BinarySceneCompiler::AddString(const std::string& text) {
+    auto it = stringIndices.find(text);
+    if (it != stringIndices.end()) {
+        return it->second;
+    }
+    const uint32_t stringIndex = static_cast<uint32_t>(strings.size());
+    strings.emplace_back(text);
+    stringIndices.emplace(text, stringIndex);
+    return stringIndex;
+}
+
+void BinarySceneCompiler::CompileNode(const nlohmann::json& nodeJson, uint32_t parentIndex, const std::string& uniqueNodeName) {
+    const uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+    Node node{};
+    node.parentIndex = parentIndex;
+    node.name = AddString(uniqueNodeName);
+    node.firstTag = static_cast<uint32_t>(tags.size());
+    for (const nlohmann::json& nodeTag : JsonHelper::GetJson(nodeJson, "tags")) {
+        tags.emplace_back(AddString(nodeTag.get_ref<const std::string&>()));
+    }
+    node.tagCount = static_cast<uint32_t>(tags.size()) - node.firstTag;
+    node.componentsOffset = static_cast<uint32_t>(componentData.size());
+    node.componentCount = 0;
+    nodes.emplace_back(node);
+
+    for (const nlohmann::json& nodeComponentJson : JsonHelper::GetJson(nodeJson, "components")) {
+        nlohmann::json::const_iterator it = nodeComponentJson.begin();
+        CompileComponent(it.key(), it.value(), nodeIndex);
+    }
+
+    // External scene is inlined, its root components fill in types the node doesn't define
+    const std::string& externalSceneSource = JsonHelper::Get<std::string>(nodeJson, "external_scene_source");
+    const nlohmann::json* externalSceneJson = externalSceneSource.empty() ? nullptr : LoadExternalScene(externalSceneSource);
+    const bool hasExternalScene = externalSceneJson != nullptr;
+    if (hasExternalScene) {
+        for (const nlohmann::json& templateComponentJson : JsonHelper::GetJson(*externalSceneJson, "components")) {
+            nlohmann::json::const_iterator it = templateComponentJson.begin();
+            ComponentRecordType componentRecordType;
+            if (GetComponentRecordType(it.key(), componentRecordType) && !HasComponentRecord(nodeIndex, componentRecordType)) {
+                CompileComponent(it.key(), it.value(), nodeIndex);
+            }
+        }
+    }
+
+    SceneNodeNaming childNaming;
+    for (const nlohmann::json& nodeChildJson : JsonHelper::GetJson(nodeJson, "children")) {
+        CompileNode(nodeChildJson, nodeIndex, childNaming.AddName(JsonHelper::Get<std::string>(nodeChildJson, "name")));
+    }
+
+    if (hasExternalScene) {
+        // Names are unique within the external scene first, then against the node's own children like at runtime
+        SceneNodeNaming templateChildNaming;
+        for (const nlohmann::json& templateChildJson : JsonHelper::GetJson(*externalSceneJson, "children")) {
+            const std::string templateChildName = templateChildNaming.AddName(JsonHelper::Get<std::string>(templateChildJson, "name"));
+            CompileNode(templateChildJson, nodeIndex, childNaming.AddName(templateChildName));
+        }
+        externalSceneStack.pop_back();
+    }
+}
+
+// Each external scene file is read once per compile, scenes usually instance the same few many times
+const nlohmann::json* BinarySceneCompiler::LoadExternalScene(const std::string& externalSceneSource) {
+    if (std::find(externalSceneStack.begin(), externalSceneStack.end(), externalSceneSource) != externalSceneStack.end()) {
+        std::cerr << "External scene '" << externalSceneSource << "' includes itself, skipping!" << std::endl;
+        return nullptr;
+    }
+    externalSceneFilePaths.emplace(externalSceneSource);
+    auto it = externalSceneJsons.find(externalSceneSource);
+    if (it == externalSceneJsons.end()) {
+        if (!FileHelper::DoesFileExist(externalSceneSource)) {
+            std::cerr << "External scene '" << externalSceneSource << "' not found!" << std::endl;
+            return nullptr;
+        }
+        it = externalSceneJsons.emplace(externalSceneSource, JsonFileHelper::LoadJsonFile(externalSceneSource)).first;
+    }
+    externalSceneStack.emplace_back(externalSceneSource);
+    return &it->second;
+}
+
+bool BinarySceneCompiler::GetComponentRecordType(const std::string& componentType, ComponentRecordType& componentRecordType) {
+    static const std::unordered_map<std::string, ComponentRecordType> componentRecordTypes = {
+        { "transform2D", ComponentRecordType::TRANSFORM_2D },
+        { "sprite", ComponentRecordType::SPRITE },
+        { "text_label", ComponentRecordType::TEXT_LABEL },
+        { "animated_sprite", ComponentRecordType::ANIMATED_SPRITE },
+        { "collider", ComponentRecordType::COLLIDER },
+    };
+    auto it = componentRecordTypes.find(componentType);
+    if (it == componentRecordTypes.end()) {
+        return false;
+    }
+    componentRecordType = it->second;
+    return true;
+}
+
+// A node's records are the last ones written while its components are compiled
+bool BinarySceneCompiler::HasComponentRecord(uint32_t nodeIndex, ComponentRecordType componentRecordType) const {
+    size_t recordOffset = nodes[nodeIndex].componentsOffset;
+    for (uint32_t componentIndex = 0; componentIndex < nodes[nodeIndex].componentCount; componentIndex++) {
+        ComponentRecordHeader recordHeader;
+        std::memcpy(&recordHeader, componentData.data() + recordOffset, sizeof(ComponentRecordHeader));
+        if (recordHeader.type == static_cast<uint16_t>(componentRecordType)) {
+            return true;
+        }
+        recordOffset = (recordOffset + sizeof(ComponentRecordHeader) + recordHeader.size + 3) & ~static_cast<size_t>(3);
+    }
+    return false;
+}
+
+// Reads the same keys as SceneNodeJsonParser so both paths create identical components
+void BinarySceneCompiler::CompileComponent(const std::string& componentType, const nlohmann::json& componentJson, uint32_t nodeIndex) {
+    const bool isComponentEnabled = JsonHelper::GetDefault<bool>(componentJson, "enabled", true);
+    std::vector<char> payload;
+    if (componentType == "transform2D") {
+        const nlohmann::json& positionJson = JsonHelper::GetJson(componentJson, "position");
+        const nlohmann::json& scaleJson = JsonHelper::GetJson(componentJson, "scale");
+        Transform2DRecord record{};
+        record.position[0] = JsonHelper::Get<float>(positionJson, "x");
+        record.position[1] = JsonHelper::Get<float>(positionJson, "y");
+        record.scale[0] = JsonHelper::Get<float>(scaleJson, "x");
+        record.scale[1] = JsonHelper::Get<float>(scaleJson, "y");
+        record.rotation = JsonHelper::Get<float>(componentJson, "rotation");
+        record.zIndex = JsonHelper::Get<int>(componentJson, "z_index");
+        record.isZIndexRelativeToParent = JsonHelper::Get<bool>(componentJson, "z_index_relative_to_parent");
+        record.ignoreCamera = JsonHelper::Get<bool>(componentJson, "ignore_camera");
+        AppendRecord(payload, record);
+        AddComponentRecord(ComponentRecordType::TRANSFORM_2D, isComponentEnabled, payload, nodeIndex);
+    } else if (componentType == "sprite") {
+        const std::string& texturePath = JsonHelper::Get<std::string>(componentJson, "texture_path");
+        SpriteRecord record{};
+        record.texturePath = texturePath.empty() ? NO_STRING : AddString(texturePath);
+        ReadDrawSource(JsonHelper::GetJson(componentJson, "draw_source"), record.drawSource);
+        record.flipX = JsonHelper::Get<bool>(componentJson, "flip_x");
+        record.flipY = JsonHelper::GetDefault<bool>(componentJson, "flip_y", false);
+        ReadNormalizedColor(JsonHelper::GetJson(componentJson, "modulate"), record.modulate);
+        AppendRecord(payload, record);
+        AddComponentRecord(ComponentRecordType::SPRITE, isComponentEnabled && !texturePath.empty(), payload, nodeIndex);
+    } else if (componentType == "text_label") {
+        const std::string& fontUID = JsonHelper::Get<std::string>(componentJson, "font_uid");
+        TextLabelRecord record{};
+        record.text = AddString(JsonHelper::Get<std::string>(componentJson, "text"));
+        record.fontUID = fontUID.empty() ? NO_STRING : AddString(fontUID);
+        ReadNormalizedColor(JsonHelper::GetJson(componentJson, "color"), record.color);
+        AppendRecord(payload, record);
+        AddComponentRecord(ComponentRecordType::TEXT_LABEL, isComponentEnabled && !fontUID.empty(), payload, nodeIndex);
+    } else if (componentType == "animated_sprite") {
+        const nlohmann::json& animationsJson = JsonHelper::GetJson(componentJson, "animations");
+        const std::string& currentAnimationName = JsonHelper::Get<std::string>(componentJson, "current_animation");
+        bool hasCurrentAnimation = false;
+        AnimatedSpriteRecord record{};
+        record.currentAnimation = AddString(currentAnimationName);
+        record.isPlaying = JsonHelper::Get<bool>(componentJson, "is_playing");
+        record.flipX = JsonHelper::Get<bool>(componentJson, "flip_x");
+        record.flipY = JsonHelper::Get<bool>(componentJson, "flip_y");
+        ReadNormalizedColor(JsonHelper::GetJson(componentJson, "modulate"), record.modulate);
+        record.animationCount = static_cast<uint32_t>(animationsJson.size());
+        AppendRecord(payload, record);
+        for (const nlohmann::json& animationJson : animationsJson) {
+            const std::string& animationName = JsonHelper::Get<std::string>(animationJson, "name");
+            const nlohmann::json& framesJson = JsonHelper::GetJson(animationJson, "frames");
+            hasCurrentAnimation |= animationName == currentAnimationName;
+            AnimationRecord animationRecord{};
+            animationRecord.name = AddString(animationName);
+            animationRecord.speed = JsonHelper::Get<int>(animationJson, "speed");
+            animationRecord.frameCount = static_cast<uint32_t>(framesJson.size());
+            AppendRecord(payload, animationRecord);
+            for (const nlohmann::json& frameJson : framesJson) {
+                AnimationFrameRecord frameRecord{};
+                frameRecord.frame = JsonHelper::Get<int>(frameJson, "frame");
+                frameRecord.texturePath = AddString(JsonHelper::Get<std::string>(frameJson, "texture_path"));
+                ReadDrawSource(JsonHelper::GetJson(frameJson, "draw_source"), frameRecord.drawSource);
+                AppendRecord(payload, frameRecord);
+            }
+        }
+        assert(hasCurrentAnimation && "Trying to set current animation to an animation that doesn't exist!");
+        AddComponentRecord(ComponentRecordType::ANIMATED_SPRITE, isComponentEnabled, payload, nodeIndex);
+    } else if (componentType == "collider") {
+        const nlohmann::json& rectangleJson = JsonHelper::GetJson(componentJson, "rectangle");
+        ColliderRecord record{};
+        ReadDrawSource(rectangleJson, record.rectangle);
+        ReadNormalizedColor(JsonHelper::GetJson(componentJson, "color"), record.color);
+        AppendRecord(payload, record);
+        AddComponentRecord(ComponentRecordType::COLLIDER, isComponentEnabled, payload, nodeIndex);
+    }
+}
+
+void BinarySceneCompiler::AddComponentRecord(ComponentRecordType type, bool isEnabled, const std::vector<char>& payload, uint32_t nodeIndex) {
+    ComponentRecordHeader recordHeader{};
+    recordHeader.type = static_cast<uint16_t>(type);
+    recordHeader.isEnabled = isEnabled;
+    recordHeader.size = static_cast<uint32_t>(payload.size());
+    AppendRecord(componentData, recordHeader);
+    componentData.insert(componentData.end(), payload.begin(), payload.end());
+    AlignToFourBytes(componentData);
+    nodes[nodeIndex].componentCount++;
+}
+
+std::vector<char> BinarySceneCompiler::Assemble() const {
+    std::vector<char> output(sizeof(Header), 0);
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+
+    header.stringCount = static_cast<uint32_t>(strings.size());
+    header.stringOffsetsOffset = static_cast<uint32_t>(output.size());
+    uint32_t stringOffset = 0;
+    for (const std::string& text : strings) {
+        AppendRecord(output, stringOffset);
+        stringOffset += static_cast<uint32_t>(text.size()) + 1;
+    }
+    AppendRecord(output, stringOffset);
+    header.stringDataOffset = static_cast<uint32_t>(output.size());
+    for (const std::string& text : strings) {
+        output.insert(output.end(), text.c_str(), text.c_str() + text.size() + 1);
+    }
+    AlignToFourBytes(output);
+
+    header.nodeCount = static_cast<uint32_t>(nodes.size());
+    header.nodesOffset = static_cast<uint32_t>(output.size());
+    for (const Node& node : nodes) {
+        AppendRecord(output, node);
+    }
+    header.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    header.dependenciesOffset = static_cast<uint32_t>(output.size());
+    for (uint32_t dependency : dependencies) {
+        AppendRecord(output, dependency);
+    }
+    header.tagsOffset = static_cast<uint32_t>(output.size());
+    for (uint32_t tag : tags) {
+        AppendRecord(output, tag);
+    }
+    header.componentsOffset = static_cast<uint32_t>(output.size());
+    output.insert(output.end(), componentData.begin(), componentData.end());
+
+    header.fileSize = static_cast<uint32_t>(output.size());
+    std::memcpy(output.data(), &header, sizeof(Header));
+    return output;
+}
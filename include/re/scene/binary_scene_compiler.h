@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+#include <json/json.hpp>
+
+#include "binary_scene_format.h"
+
+// Converts json scenes into the compiled binary format.  Node names are made unique and component enabled states are
+// resolved here so loading a compiled scene only copies records into components.  Nodes with an external scene source
+// get the external scene inlined: its root components fill in component types the node doesn't have and its children
+// are added after the node's own children.
+class BinarySceneCompiler {
+  public:
+    static bool CompileSceneFile(const std::string& sceneFilePath, const std::string& outputFilePath);
+    // 'sceneFilePath' is only used to catch external scenes that include the scene being compiled
+    static std::vector<char> CompileSceneJson(const nlohmann::json& sceneJson, const std::string& sceneFilePath = "");
+    // Also lists the external scene files that were inlined, a change to any of them changes the compiled scene
+    static std::vector<char> CompileSceneJson(const nlohmann::json& sceneJson, const std::string& sceneFilePath, std::vector<std::string>& externalSceneFilePaths);
+
+  private:
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIndices;
+    std::vector<BinarySceneFormat::Node> nodes;
+    std::vector<uint32_t> tags;
+    std::vector<char> componentData;
+    std::vector<std::string> externalSceneStack; // External scenes being inlined, used to catch scenes including themselves
+    std::unordered_map<std::string, nlohmann::json> externalSceneJsons;
+    std::set<std::string> externalSceneFilePaths; // Every external scene referenced, missing ones included
+    std::vector<uint32_t> dependencies; // String indices of 'externalSceneFilePaths'
+
+    uint32_t AddString(const std::string& text);
+    void CompileNode(const nlohmann::json& nodeJson, uint32_t parentIndex, const std::string& uniqueNodeName);
+    // Returns nullptr if the scene doesn't exist or is already being inlined
+    const nlohmann::json* LoadExternalScene(const std::string& externalSceneSource);
+    static bool GetComponentRecordType(const std::string& componentType, BinarySceneFormat::ComponentRecordType& componentRecordType);
+    bool HasComponentRecord(uint32_t nodeIndex, BinarySceneFormat::ComponentRecordType componentRecordType) const;
+    void CompileComponent(const std::string& componentType, const nlohmann::json& componentJson, uint32_t nodeIndex);
+    void AddComponentRecord(BinarySceneFormat::ComponentRecordType type, bool isEnabled, const std::vector<char>& payload, uint32_t nodeIndex);
+    std::vector<char> Assemble() const;
+};
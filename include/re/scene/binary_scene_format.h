@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Compiled scene layout, written by BinarySceneCompiler and read in place by SceneNodeBinaryParser.  Every section
+// starts on a 4 byte boundary and all values are stored little endian.
+//
+//   Header
+//   uint32_t stringOffsets[stringCount + 1]   offsets into string data, entry i + 1 marks the end of string i
+//   char stringData[]                         null terminated strings
+//   Node nodes[nodeCount]                     pre-order, a parent always comes before its children
+//   uint32_t dependencies[dependencyCount]    string indices of every external scene file inlined
+//   uint32_t tags[]                           string indices referenced by Node::firstTag
+//   component records                         ComponentRecordHeader followed by its payload
+namespace BinarySceneFormat {
+const char MAGIC[4] = { 'R', 'E', 'S', 'C' };
+const uint32_t VERSION = 2;
+const uint32_t NO_PARENT = 0xFFFFFFFF;
+const uint32_t NO_STRING = 0xFFFFFFFF;
+const std::string FILE_EXTENSION = ".rescn";
+
+enum class ComponentRecordType : uint16_t {
+    TRANSFORM_2D = 0,
+    SPRITE = 1,
+    TEXT_LABEL = 2,
+    ANIMATED_SPRITE = 3,
+    COLLIDER = 4,
+};
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t stringCount;
+    uint32_t stringOffsetsOffset;
+    uint32_t stringDataOffset;
+    uint32_t nodeCount;
+    uint32_t nodesOffset;
+    uint32_t dependencyCount;
+    uint32_t dependenciesOffset;
+    uint32_t tagsOffset;
+    uint32_t componentsOffset;
+};
+
+struct Node {
+    uint32_t parentIndex;
+    uint32_t name; // Already made unique against its siblings
+    uint32_t firstTag;
+    uint32_t tagCount;
+    uint32_t componentsOffset; // Relative to Header::componentsOffset
+    uint32_t componentCount;
+};
+
+struct ComponentRecordHeader {
+    uint16_t type;
+    uint16_t isEnabled; // Final enabled state, e.g. a sprite without texture is stored disabled
+    uint32_t size; // Payload size
+};
+
+struct Transform2DRecord {
+    float position[2];
+    float scale[2];
+    float rotation;
+    int32_t zIndex;
+    uint8_t isZIndexRelativeToParent;
+    uint8_t ignoreCamera;
+    uint8_t padding[2];
+};
+
+struct SpriteRecord {
+    uint32_t texturePath; // NO_STRING for sprites without texture
+    float drawSource[4];
+    uint8_t flipX;
+    uint8_t flipY;
+    uint8_t padding[2];
+    float modulate[4]; // Normalized
+};
+
+struct TextLabelRecord {
+    uint32_t text;
+    uint32_t fontUID; // NO_STRING for labels without font
+    float color[4];
+};
+
+// Followed by 'animationCount' AnimationRecords, each followed by its AnimationFrameRecords
+struct AnimatedSpriteRecord {
+    uint32_t currentAnimation;
+    uint8_t isPlaying;
+    uint8_t flipX;
+    uint8_t flipY;
+    uint8_t padding;
+    float modulate[4];
+    uint32_t animationCount;
+};
+
+struct AnimationRecord {
+    uint32_t name;
+    int32_t speed;
+    uint32_t frameCount;
+};
+
+struct AnimationFrameRecord {
+    int32_t frame;
+    uint32_t texturePath;
+    float drawSource[4];
+};
+
+struct ColliderRecord {
+    float rectangle[4];
+    float color[4];
+};
+
+// Compiled file expected next to a json scene, 'scenes/main.json' compiles to 'scenes/main.rescn'
+inline std::string GetCompiledFilePath(const std::string& sceneFilePath) {
+    const std::string jsonExtension = ".json";
+    if (sceneFilePath.size() >= jsonExtension.size()
+            && sceneFilePath.compare(sceneFilePath.size() - jsonExtension.size(), jsonExtension.size(), jsonExtension) == 0) {
+        return sceneFilePath.substr(0, sceneFilePath.size() - jsonExtension.size()) + FILE_EXTENSION;
+    }
+    return sceneFilePath + FILE_EXTENSION;
+}
+
+inline bool IsCompiledFilePath(const std::string& filePath) {
+    return filePath.size() >= FILE_EXTENSION.size()
+           && filePath.compare(filePath.size() - FILE_EXTENSION.size(), FILE_EXTENSION.size(), FILE_EXTENSION) == 0;
+}
+}
@@ -1,24 +1,22 @@
 #pragma once
 
-#include <vector>
-#include <unordered_map>
-#include <cassert>
-
+#include "scene_hierarchy.h"
+#include "scene_node_index.h"
+#include "scene_transform_cache.h"
 #include "../ecs/entity/entity.h"
 #include "../utils/helper.h"
 
-struct SceneNode {
-    Entity entity = NULL_ENTITY;
-    Entity parent = NULL_ENTITY;
-    std::vector<SceneNode> children = {};
-};
-
 struct Scene {
-    SceneNode rootNode = {};
-    std::unordered_map<Entity, SceneNode> sceneNodes = {};
+    Entity rootEntity = NULL_ENTITY;
+    SceneHierarchy hierarchy;
+    SceneNodeIndex nodeIndex;
+    SceneTransformCache worldTransforms;
 
-    SceneNode GetSceneNode(Entity entity) {
-        assert(sceneNodes.count(entity) > 0 && "Entity doesn't have a scene node!");
-        return sceneNodes[entity];
+    // Resets the scene to empty while keeping its MAX_ENTITIES sized storage, which is costly to allocate and zero fill
+    void Clear() {
+        rootEntity = NULL_ENTITY;
+        hierarchy.Clear();
+        nodeIndex.Clear();
+        worldTransforms.Clear();
     }
 };
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <atomic>
+
+#include "../ecs/entity/entity.h"
+
+// Flat scene tree stored as per entity link arrays.  NULL_ENTITY acts as a virtual root whose children are the scene's
+// root level nodes, so every lookup is an array read and traversal never allocates.
+class SceneHierarchy {
+  public:
+    SceneHierarchy() :
+        parents(MAX_ENTITIES, NULL_ENTITY),
+        firstChildren(MAX_ENTITIES, NULL_ENTITY),
+        lastChildren(MAX_ENTITIES, NULL_ENTITY),
+        nextSiblings(MAX_ENTITIES, NULL_ENTITY),
+        previousSiblings(MAX_ENTITIES, NULL_ENTITY),
+        depths(MAX_ENTITIES, 0),
+        childCounts(MAX_ENTITIES, 0),
+        inHierarchy(MAX_ENTITIES, false) {}
+
+    // Appends 'entity' as the last child of 'parent' (NULL_ENTITY adds a root level node)
+    void AddNode(Entity entity, Entity parent = NULL_ENTITY) {
+        assert(entity != NULL_ENTITY && "Can't add null entity to scene hierarchy!");
+        assert(!HasNode(entity) && "Entity already in scene hierarchy!");
+        assert((parent == NULL_ENTITY || HasNode(parent)) && "Parent not in scene hierarchy!");
+        inHierarchy[entity] = true;
+        LinkChild(entity, parent);
+        nodeCount++;
+        structureVersion = NextStructureVersion();
+    }
+
+    // Removes 'entity' from the hierarchy, its children become root level nodes
+    void RemoveNode(Entity entity) {
+        assert(HasNode(entity) && "Entity not in scene hierarchy!");
+        Entity child = firstChildren[entity];
+        while (child != NULL_ENTITY) {
+            const Entity nextChild = nextSiblings[child];
+            UnlinkChild(child);
+            LinkChild(child, NULL_ENTITY);
+            child = nextChild;
+        }
+        UnlinkChild(entity);
+        inHierarchy[entity] = false;
+        nodeCount--;
+        structureVersion = NextStructureVersion();
+    }
+
+    // Removes 'root' and all of its descendants in one pass, appending them to 'removedEntities' in pre-order
+    void RemoveSubtree(Entity root, std::vector<Entity>& removedEntities) {
+        assert(HasNode(root) && "Entity not in scene hierarchy!");
+        const size_t firstRemovedIndex = removedEntities.size();
+        TraverseDepthFirst(root, [&removedEntities](Entity node) {
+            removedEntities.emplace_back(node);
+        });
+        UnlinkChild(root);
+        // Links inside the subtree go away with it, only the root was attached to a surviving node
+        for (size_t i = firstRemovedIndex; i < removedEntities.size(); i++) {
+            const Entity node = removedEntities[i];
+            parents[node] = NULL_ENTITY;
+            firstChildren[node] = NULL_ENTITY;
+            lastChildren[node] = NULL_ENTITY;
+            nextSiblings[node] = NULL_ENTITY;
+            previousSiblings[node] = NULL_ENTITY;
+            depths[node] = 0;
+            childCounts[node] = 0;
+            inHierarchy[node] = false;
+        }
+        nodeCount -= static_cast<unsigned int>(removedEntities.size() - firstRemovedIndex);
+        structureVersion = NextStructureVersion();
+    }
+
+    void Clear() {
+        std::fill(parents.begin(), parents.end(), NULL_ENTITY);
+        std::fill(firstChildren.begin(), firstChildren.end(), NULL_ENTITY);
+        std::fill(lastChildren.begin(), lastChildren.end(), NULL_ENTITY);
+        std::fill(nextSiblings.begin(), nextSiblings.end(), NULL_ENTITY);
+        std::fill(previousSiblings.begin(), previousSiblings.end(), NULL_ENTITY);
+        std::fill(depths.begin(), depths.end(), 0);
+        std::fill(childCounts.begin(), childCounts.end(), 0);
+        std::fill(inHierarchy.begin(), inHierarchy.end(), false);
+        nodeCount = 0;
+        structureVersion = NextStructureVersion();
+    }
+
+    bool HasNode(Entity entity) const {
+        return entity != NULL_ENTITY && entity < MAX_ENTITIES && inHierarchy[entity];
+    }
+
+    Entity GetParent(Entity entity) const {
+        return parents[entity];
+    }
+
+    Entity GetFirstChild(Entity entity) const {
+        return firstChildren[entity];
+    }
+
+    Entity GetNextSibling(Entity entity) const {
+        return nextSiblings[entity];
+    }
+
+    unsigned int GetDepth(Entity entity) const {
+        return depths[entity];
+    }
+
+    unsigned int GetChildCount(Entity entity) const {
+        return childCounts[entity];
+    }
+
+    unsigned int GetNodeCount() const {
+        return nodeCount;
+    }
+
+    // Changes whenever nodes are added or removed, unique across hierarchies so layouts built from one can be validated
+    unsigned int GetStructureVersion() const {
+        return structureVersion;
+    }
+
+    template<typename Func>
+    void ForEachChild(Entity parent, Func func) const {
+        for (Entity child = firstChildren[parent]; child != NULL_ENTITY; child = nextSiblings[child]) {
+            func(child);
+        }
+    }
+
+    // Pre-order traversal of 'root' and its descendants.  Passing NULL_ENTITY visits every node in the hierarchy.
+    template<typename Func>
+    void TraverseDepthFirst(Entity root, Func func) const {
+        Entity current = root == NULL_ENTITY ? firstChildren[NULL_ENTITY] : root;
+        while (current != NULL_ENTITY) {
+            func(current);
+            if (firstChildren[current] != NULL_ENTITY) {
+                current = firstChildren[current];
+                continue;
+            }
+            while (current != root && nextSiblings[current] == NULL_ENTITY) {
+                current = parents[current];
+            }
+            if (current == root) {
+                break;
+            }
+            current = nextSiblings[current];
+        }
+    }
+
+  private:
+    std::vector<Entity> parents;
+    std::vector<Entity> firstChildren;
+    std::vector<Entity> lastChildren;
+    std::vector<Entity> nextSiblings;
+    std::vector<Entity> previousSiblings;
+    std::vector<unsigned int> depths;
+    std::vector<unsigned int> childCounts;
+    std::vector<bool> inHierarchy;
+    unsigned int nodeCount = 0;
+    unsigned int structureVersion = NextStructureVersion();
+
+    static unsigned int NextStructureVersion() {
+        static std::atomic<unsigned int> versionCounter(0);
+        return ++versionCounter;
+    }
+
+    void LinkChild(Entity entity, Entity parent) {
+        parents[entity] = parent;
+        previousSiblings[entity] = lastChildren[parent];
+        nextSiblings[entity] = NULL_ENTITY;
+        if (lastChildren[parent] != NULL_ENTITY) {
+            nextSiblings[lastChildren[parent]] = entity;
+        } else {
+            firstChildren[parent] = entity;
+        }
+        lastChildren[parent] = entity;
+        childCounts[parent]++;
+        UpdateDepths(entity);
+    }
+
+    void UnlinkChild(Entity entity) {
+        const Entity parent = parents[entity];
+        const Entity previousSibling = previousSiblings[entity];
+        const Entity nextSibling = nextSiblings[entity];
+        if (previousSibling != NULL_ENTITY) {
+            nextSiblings[previousSibling] = nextSibling;
+        } else {
+            firstChildren[parent] = nextSibling;
+        }
+        if (nextSibling != NULL_ENTITY) {
+            previousSiblings[nextSibling] = previousSibling;
+        } else {
+            lastChildren[parent] = previousSibling;
+        }
+        childCounts[parent]--;
+        parents[entity] = NULL_ENTITY;
+        previousSiblings[entity] = NULL_ENTITY;
+        nextSiblings[entity] = NULL_ENTITY;
+    }
+
+    void UpdateDepths(Entity entity) {
+        const Entity parent = parents[entity];
+        const unsigned int baseDepth = parent == NULL_ENTITY ? 0 : depths[parent] + 1;
+        TraverseDepthFirst(entity, [this, entity, baseDepth](Entity node) {
+            depths[node] = node == entity ? baseDepth : depths[parents[node]] + 1;
+        });
+    }
+};
@@ -0,0 +1,215 @@
+#include "scene_hot_reloader.h"
+
+#include <unordered_map>
+
+#include "binary_scene_compiler.h"
+#include "scene_node_binary_parser.h"
+#include "scene_template_cache.h"
+#include "../ecs/component/components/scene_component.h"
+#include "../utils/mapped_file.h"
+#include "../utils/logger.h"
+#include "../utils/json_helper.h"
+
+// Names are only unique among siblings, so nodes are keyed by name and parent index
+static std::string GetNodeKey(const SceneNodeBinaryParser& sceneNodeBinaryParser, uint32_t nodeIndex, uint32_t parentIndex) {
+    return sceneNodeBinaryParser.GetNodeName(nodeIndex) + '/' + std::to_string(parentIndex);
+}
+
+SceneHotReloader::SceneHotReloader(EntityManager* entityManager, ComponentManager* componentManager) :
+    entityManager(entityManager),
+    componentManager(componentManager),
+    isCompiling(false) {}
+
+SceneHotReloader::~SceneHotReloader() {
+    if (compileThread.joinable()) {
+        compileThread.join();
+    }
+}
+
+bool SceneHotReloader::Watch(const std::string& filePath) {
+    if (compileThread.joinable()) {
+        compileThread.join();
+    }
+    isCompiling = false;
+    hasCompiledSave = false;
+    hasPendingSave = false;
+    fileWatcher.Clear();
+    sceneFilePath = filePath;
+    compiledScene.clear();
+    if (!CompileSceneFile(compiledScene, externalSceneFilePaths) || !fileWatcher.WatchFile(sceneFilePath)) {
+        compiledScene.clear();
+        return false;
+    }
+    WatchExternalScenes();
+    return true;
+}
+
+const std::string& SceneHotReloader::GetSceneFilePath() const {
+    return sceneFilePath;
+}
+
+bool SceneHotReloader::CompileSceneFile(std::vector<char>& compiledSceneFile, std::vector<std::string>& compiledExternalSceneFilePaths) const {
+    // Editors may save while the file is read, a broken save keeps the scene as is until the next one
+    MappedFile sceneFile(sceneFilePath);
+    if (!sceneFile.IsValid()) {
+        return false;
+    }
+    const nlohmann::json sceneJson = nlohmann::json::parse(sceneFile.GetData(), sceneFile.GetData() + sceneFile.GetSize(), nullptr, false);
+    if (sceneJson.is_discarded()) {
+        Logger::GetInstance()->Error("Scene '%s' isn't valid json, skipping reload!", sceneFilePath.c_str());
+        return false;
+    }
+    // Valid json can still miss keys or hold the wrong types, either would otherwise end the session
+    try {
+        JsonMissingKeyThrowScope missingKeyThrowScope;
+        compiledSceneFile = BinarySceneCompiler::CompileSceneJson(sceneJson, sceneFilePath, compiledExternalSceneFilePaths);
+    } catch (const nlohmann::json::exception& exception) {
+        Logger::GetInstance()->Error("Scene '%s' failed to compile, skipping reload: %s", sceneFilePath.c_str(), exception.what());
+        return false;
+    }
+    return true;
+}
+
+// Newly referenced external scenes are added, ones no longer referenced only cost a spurious recompile
+void SceneHotReloader::WatchExternalScenes() {
+    for (const std::string& externalSceneFilePath : externalSceneFilePaths) {
+        fileWatcher.WatchFile(externalSceneFilePath);
+    }
+}
+
+// Runs on the compile thread, only touches 'compiledSave', 'externalSceneFilePaths' and 'hasCompiledSave' until
+// 'isCompiling' is cleared
+void SceneHotReloader::CompileSave() {
+    std::vector<std::string> compiledExternalSceneFilePaths;
+    hasCompiledSave = CompileSceneFile(compiledSave, compiledExternalSceneFilePaths);
+    if (hasCompiledSave) {
+        externalSceneFilePaths.swap(compiledExternalSceneFilePaths);
+    }
+    isCompiling = false;
+}
+
+bool SceneHotReloader::Update(Scene* scene, SceneReloadChanges& changes) {
+    if (compiledScene.empty()) {
+        return false;
+    }
+    if (!fileWatcher.GetChangedFiles().empty()) {
+        // Instances added at runtime should use the saved external scenes too
+        SceneTemplateCache::GetInstance()->Clear();
+        hasPendingSave = true;
+    }
+    if (isCompiling) {
+        return false;
+    }
+    if (compileThread.joinable()) {
+        compileThread.join();
+    }
+    bool isApplied = false;
+    if (hasCompiledSave) {
+        hasCompiledSave = false;
+        WatchExternalScenes();
+        ApplySave(scene, changes);
+        isApplied = true;
+    }
+    if (hasPendingSave) {
+        hasPendingSave = false;
+        isCompiling = true;
+        compileThread = std::thread(&SceneHotReloader::CompileSave, this);
+    }
+    return isApplied;
+}
+
+void SceneHotReloader::ApplySave(Scene* scene, SceneReloadChanges& changes) {
+    SceneNodeBinaryParser previousParser(entityManager, componentManager);
+    SceneNodeBinaryParser nextParser(entityManager, componentManager);
+    if (!previousParser.Open(compiledScene.data(), compiledScene.size()) || !nextParser.Open(compiledSave.data(), compiledSave.size())) {
+        return;
+    }
+    const uint32_t previousNodeCount = previousParser.GetNodeCount();
+    const uint32_t nextNodeCount = nextParser.GetNodeCount();
+
+    // Previous nodes are found in the running scene before anything changes, a node removed or renamed at runtime
+    // is skipped along with its children
+    std::vector<Entity> previousNodeEntities(previousNodeCount, NULL_ENTITY);
+    std::unordered_map<std::string, uint32_t> previousNodeIndices;
+    previousNodeIndices.reserve(previousNodeCount);
+    for (uint32_t nodeIndex = 0; nodeIndex < previousNodeCount; nodeIndex++) {
+        const uint32_t parentIndex = previousParser.GetNodeParentIndex(nodeIndex);
+        const Entity parent = parentIndex == BinarySceneFormat::NO_PARENT ? NULL_ENTITY : previousNodeEntities[parentIndex];
+        if (parentIndex == BinarySceneFormat::NO_PARENT || parent != NULL_ENTITY) {
+            previousNodeEntities[nodeIndex] = scene->nodeIndex.GetChild(parent, previousParser.GetNodeName(nodeIndex));
+        }
+        previousNodeIndices.emplace(GetNodeKey(previousParser, nodeIndex, parentIndex), nodeIndex);
+    }
+
+    // Number edits leave the strings alone, then unchanged nodes are found with a byte compare
+    const bool hasSameStrings = previousParser.HasSameStrings(nextParser);
+    std::vector<uint32_t> nextToPreviousIndices(nextNodeCount, BinarySceneFormat::NO_PARENT);
+    std::vector<Entity> nextNodeEntities(nextNodeCount, NULL_ENTITY);
+    std::vector<bool> isPreviousNodeKept(previousNodeCount, false);
+    for (uint32_t nodeIndex = 0; nodeIndex < nextNodeCount; nodeIndex++) {
+        const uint32_t parentIndex = nextParser.GetNodeParentIndex(nodeIndex);
+        const bool isRootNode = parentIndex == BinarySceneFormat::NO_PARENT;
+        const Entity parent = isRootNode ? NULL_ENTITY : nextNodeEntities[parentIndex];
+        if (!isRootNode && parent == NULL_ENTITY) {
+            continue;
+        }
+        const uint32_t previousParentIndex = isRootNode ? BinarySceneFormat::NO_PARENT : nextToPreviousIndices[parentIndex];
+        auto previousIt = isRootNode || previousParentIndex != BinarySceneFormat::NO_PARENT
+                          ? previousNodeIndices.find(GetNodeKey(nextParser, nodeIndex, previousParentIndex)) : previousNodeIndices.end();
+        if (previousIt == previousNodeIndices.end()) {
+            const Entity entity = nextParser.AddSceneNode(scene, nodeIndex, parent);
+            scene->worldTransforms.MarkDirty(entity, scene->hierarchy);
+            nextNodeEntities[nodeIndex] = entity;
+            changes.createdEntities.emplace_back(entity);
+            continue;
+        }
+        const uint32_t previousIndex = previousIt->second;
+        isPreviousNodeKept[previousIndex] = true;
+        const Entity entity = previousNodeEntities[previousIndex];
+        if (entity == NULL_ENTITY) {
+            continue;
+        }
+        nextToPreviousIndices[nodeIndex] = previousIndex;
+        nextNodeEntities[nodeIndex] = entity;
+        if (hasSameStrings && nextParser.IsNodeDataSame(nodeIndex, previousParser, previousIndex)) {
+            continue;
+        }
+
+        bool isUpdated = false;
+        SceneComponent& sceneComponent = componentManager->GetComponent<SceneComponent>(entity);
+        const std::vector<std::string> previousTags = sceneComponent.tags;
+        const std::vector<std::string> nextTags = nextParser.GetNodeTags(nodeIndex);
+        if (previousParser.GetNodeTags(previousIndex) != nextTags) {
+            sceneComponent.tags = nextTags;
+            isUpdated = true;
+        }
+        const std::unordered_map<uint16_t, std::string> previousComponentKeys = previousParser.GetNodeComponentKeys(previousIndex);
+        const std::unordered_map<uint16_t, std::string> nextComponentKeys = nextParser.GetNodeComponentKeys(nodeIndex);
+        for (const auto& pair : previousComponentKeys) {
+            auto nextIt = nextComponentKeys.find(pair.first);
+            if (nextIt == nextComponentKeys.end() || nextIt->second != pair.second) {
+                nextParser.ReplaceComponent(entity, nodeIndex, static_cast<BinarySceneFormat::ComponentRecordType>(pair.first));
+                isUpdated = true;
+            }
+        }
+        for (const auto& pair : nextComponentKeys) {
+            if (previousComponentKeys.count(pair.first) == 0) {
+                nextParser.ReplaceComponent(entity, nodeIndex, static_cast<BinarySceneFormat::ComponentRecordType>(pair.first));
+                isUpdated = true;
+            }
+        }
+        if (isUpdated) {
+            // Replaced components are written in place, the transform may be among them
+            scene->worldTransforms.MarkDirty(entity, scene->hierarchy);
+            changes.updatedNodes.emplace_back(UpdatedSceneNode{ entity, previousTags });
+        }
+    }
+
+    for (uint32_t previousIndex = previousNodeCount; previousIndex-- > 0;) {
+        if (!isPreviousNodeKept[previousIndex] && previousNodeEntities[previousIndex] != NULL_ENTITY) {
+            changes.deletedEntities.emplace_back(previousNodeEntities[previousIndex]);
+        }
+    }
+    compiledScene.swap(compiledSave);
+    compiledSave.clear();
+}
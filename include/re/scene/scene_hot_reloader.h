@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "scene.h"
+#include "../ecs/entity/entity_manager.h"
+#include "../ecs/component/component_manager.h"
+#include "../utils/file_watcher.h"
+
+struct UpdatedSceneNode {
+    Entity entity;
+    std::vector<std::string> previousTags;
+};
+
+// Entities touched by a reload, systems still have to be told about them
+struct SceneReloadChanges {
+    std::vector<Entity> createdEntities; // Parents before children
+    std::vector<UpdatedSceneNode> updatedNodes;
+    std::vector<Entity> deletedEntities; // Children before parents, still alive so they can be destroyed like any entity
+};
+
+// Applies saves of a running scene's json file, and of the external scenes it inlines, in place.  Each save is compiled
+// on a background thread like a scene load, then compared with the previous compile node by node, matching nodes by
+// parent and name.  A save that doesn't compile is logged and skipped.  Only nodes whose file
+// contents changed are touched so runtime changes to the rest of the scene are kept, a changed component is replaced
+// as a whole.
+class SceneHotReloader {
+  public:
+    SceneHotReloader(EntityManager* entityManager, ComponentManager* componentManager);
+    ~SceneHotReloader();
+    // Compiles the file as the base later saves are compared against, the scene should have been loaded from it
+    bool Watch(const std::string& sceneFilePath);
+    const std::string& GetSceneFilePath() const;
+    // Returns true if a save was applied to 'scene', compiling a save takes a few frames for large scenes
+    bool Update(Scene* scene, SceneReloadChanges& changes);
+
+  private:
+    EntityManager *entityManager = nullptr;
+    ComponentManager *componentManager = nullptr;
+    FileWatcher fileWatcher;
+    std::string sceneFilePath;
+    std::vector<char> compiledScene;
+    std::thread compileThread;
+    std::atomic<bool> isCompiling;
+    bool hasCompiledSave = false; // Set by the compile thread, read once 'isCompiling' is cleared
+    bool hasPendingSave = false; // Saved again while compiling
+    std::vector<char> compiledSave;
+    std::vector<std::string> externalSceneFilePaths; // Of the last compile, written by the compile thread too
+
+    void CompileSave();
+    bool CompileSceneFile(std::vector<char>& compiledSceneFile, std::vector<std::string>& compiledExternalSceneFilePaths) const;
+    void WatchExternalScenes();
+    void ApplySave(Scene* scene, SceneReloadChanges& changes);
+};
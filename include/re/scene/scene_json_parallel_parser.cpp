@@ -0,0 +1,317 @@
+#include "scene_json_parallel_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <thread>
+
+#include <json/json.hpp>
+
+#include "binary_scene_compiler.h"
+
+static size_t SkipWhitespace(const char* data, size_t position, size_t end) {
+    while (position < end && (data[position] == ' ' || data[position] == '\n' || data[position] == '\r' || data[position] == '\t')) {
+        position++;
+    }
+    return position;
+}
+
+// Returns the position after the string starting at 'position', 'end' if it isn't closed
+static size_t SkipString(const char* data, size_t position, size_t end) {
+    for (position++; position < end; position++) {
+        if (data[position] == '\\') {
+            position++;
+        } else if (data[position] == '"') {
+            return position + 1;
+        }
+    }
+    return end;
+}
+
+// Returns the position after the value starting at 'position', only brackets and strings are looked at
+static size_t SkipValue(const char* data, size_t position, size_t end) {
+    if (data[position] == '"') {
+        return SkipString(data, position, end);
+    }
+    if (data[position] != '{' && data[position] != '[') {
+        while (position < end && data[position] != ',' && data[position] != '}' && data[position] != ']'
+                && data[position] != ' ' && data[position] != '\n' && data[position] != '\r' && data[position] != '\t') {
+            position++;
+        }
+        return position;
+    }
+    int depth = 0;
+    while (position < end) {
+        if (data[position] == '"') {
+            position = SkipString(data, position, end);
+            continue;
+        }
+        if (data[position] == '{' || data[position] == '[') {
+            depth++;
+        } else if (data[position] == '}' || data[position] == ']') {
+            depth--;
+            if (depth == 0) {
+                return position + 1;
+            }
+        }
+        position++;
+    }
+    return end;
+}
+
+static bool IsKey(const char* data, size_t keyBegin, size_t keyEnd, const char* key) {
+    const size_t keyLength = std::strlen(key);
+    return keyEnd - keyBegin == keyLength + 2 && std::memcmp(data + keyBegin + 1, key, keyLength) == 0;
+}
+
+// Finds the end of the array starting at 'arrayBegin' and the range of each element
+static bool ScanArrayElements(const char* data, size_t arrayBegin, size_t end, size_t& arrayEnd, std::vector<std::pair<size_t, size_t>>& elements) {
+    if (data[arrayBegin] != '[') {
+        return false;
+    }
+    size_t position = arrayBegin + 1;
+    while (true) {
+        position = SkipWhitespace(data, position, end);
+        if (position >= end) {
+            return false;
+        }
+        if (data[position] == ']') {
+            arrayEnd = position + 1;
+            return true;
+        }
+        const size_t elementBegin = position;
+        position = SkipValue(data, position, end);
+        elements.emplace_back(elementBegin, position);
+        position = SkipWhitespace(data, position, end);
+        if (position < end && data[position] == ',') {
+            position++;
+        }
+    }
+}
+
+// Finds the children of the node object starting at 'nodeBegin' and whether it has an external scene, in one pass
+static bool ScanNode(const char* data, size_t nodeBegin, size_t nodeEnd, size_t& childrenBegin, size_t& childrenEnd,
+                     std::vector<std::pair<size_t, size_t>>& children, bool& hasExternalScene) {
+    size_t position = SkipWhitespace(data, nodeBegin, nodeEnd);
+    if (position >= nodeEnd || data[position] != '{') {
+        return false;
+    }
+    position++;
+    while (true) {
+        position = SkipWhitespace(data, position, nodeEnd);
+        if (position >= nodeEnd) {
+            return false;
+        }
+        if (data[position] == '}') {
+            return true;
+        }
+        if (data[position] != '"') {
+            return false;
+        }
+        const size_t keyBegin = position;
+        const size_t keyEnd = SkipString(data, position, nodeEnd);
+        position = SkipWhitespace(data, keyEnd, nodeEnd);
+        if (position >= nodeEnd || data[position] != ':') {
+            return false;
+        }
+        position = SkipWhitespace(data, position + 1, nodeEnd);
+        if (position >= nodeEnd) {
+            return false;
+        }
+        const size_t valueBegin = position;
+        if (IsKey(data, keyBegin, keyEnd, "children")) {
+            if (!ScanArrayElements(data, valueBegin, nodeEnd, position, children)) {
+                return false;
+            }
+            childrenBegin = valueBegin;
+            childrenEnd = position;
+        } else {
+            position = SkipValue(data, position, nodeEnd);
+            if (IsKey(data, keyBegin, keyEnd, "external_scene_source")) {
+                hasExternalScene = position - valueBegin > 2;
+            }
+        }
+        position = SkipWhitespace(data, position, nodeEnd);
+        if (position < nodeEnd && data[position] == ',') {
+            position++;
+        }
+    }
+}
+
+const size_t SceneNodeJsonParallelParser::NO_PARENT;
+const size_t SceneNodeJsonParallelParser::MIN_PARALLEL_SCENE_SIZE;
+const unsigned int SceneNodeJsonParallelParser::MIN_PARALLEL_WORKER_COUNT;
+
+SceneNodeJsonParallelParser::SceneNodeJsonParallelParser(EntityManager* entityManager, ComponentManager* componentManager) :
+    sceneNodeBinaryParser(entityManager, componentManager) {}
+
+bool SceneNodeJsonParallelParser::ShouldParseInParallel(size_t size) {
+    return size >= MIN_PARALLEL_SCENE_SIZE && std::thread::hardware_concurrency() >= MIN_PARALLEL_WORKER_COUNT;
+}
+
+bool SceneNodeJsonParallelParser::Compile(const char* data, size_t size, const std::string& sceneFilePath) {
+    Clear();
+    const size_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+    // A few subtrees per worker so one large subtree doesn't leave the others idle
+    const size_t targetSubtreeSize = size / (workerCount * 4) + 1;
+    const size_t rootBegin = SkipWhitespace(data, 0, size);
+    if (rootBegin >= size || !SplitNode(data, rootBegin, size, NO_PARENT, targetSubtreeSize)) {
+        Clear();
+        return false;
+    }
+
+    std::atomic<size_t> nextSubtreeIndex(0);
+    std::atomic<bool> hasFailed(false);
+    auto compileSubtrees = [this, data, &sceneFilePath, &nextSubtreeIndex, &hasFailed]() {
+        for (size_t subtreeIndex = nextSubtreeIndex++; subtreeIndex < subtrees.size(); subtreeIndex = nextSubtreeIndex++) {
+            if (!CompileSubtree(subtrees[subtreeIndex], data, sceneFilePath)) {
+                hasFailed = true;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t workerIndex = 1; workerIndex < std::min(workerCount, subtrees.size()); workerIndex++) {
+        workers.emplace_back(compileSubtrees);
+    }
+    compileSubtrees();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    if (hasFailed) {
+        Clear();
+        return false;
+    }
+    for (const SceneSubtree& subtree : subtrees) {
+        nodeCount += subtree.nodeCount;
+    }
+    return true;
+}
+
+// Nodes larger than the target are split into the node itself and runs of its children, recursively
+bool SceneNodeJsonParallelParser::SplitNode(const char* data, size_t nodeBegin, size_t nodeEnd, size_t parentSubtreeIndex, size_t targetSubtreeSize) {
+    size_t childrenBegin = 0;
+    size_t childrenEnd = 0;
+    bool hasExternalScene = false;
+    std::vector<std::pair<size_t, size_t>> children;
+    if (!ScanNode(data, nodeBegin, nodeEnd, childrenBegin, childrenEnd, children, hasExternalScene)) {
+        return false;
+    }
+    SceneSubtree nodeSubtree;
+    nodeSubtree.parentSubtreeIndex = parentSubtreeIndex;
+    nodeSubtree.textBegin = nodeBegin;
+    nodeSubtree.textEnd = nodeEnd;
+    // External scenes are instanced after the node's children, the node is kept whole so that order is kept too
+    if (nodeEnd - nodeBegin <= targetSubtreeSize || hasExternalScene || children.empty()) {
+        subtrees.emplace_back(nodeSubtree);
+        return true;
+    }
+    nodeSubtree.childrenBegin = childrenBegin;
+    nodeSubtree.childrenEnd = childrenEnd;
+    const size_t nodeSubtreeIndex = subtrees.size();
+    subtrees.emplace_back(nodeSubtree);
+
+    size_t runFirstChild = 0;
+    size_t runChildCount = 0;
+    auto addSiblingRun = [this, &children, &runFirstChild, &runChildCount, nodeSubtreeIndex]() {
+        if (runChildCount == 0) {
+            return;
+        }
+        SceneSubtree runSubtree;
+        runSubtree.parentSubtreeIndex = nodeSubtreeIndex;
+        runSubtree.isSiblingRun = true;
+        runSubtree.textBegin = children[runFirstChild].first;
+        runSubtree.textEnd = children[runFirstChild + runChildCount - 1].second;
+        subtrees.emplace_back(runSubtree);
+        runChildCount = 0;
+    };
+    for (size_t childIndex = 0; childIndex < children.size(); childIndex++) {
+        const size_t childBegin = children[childIndex].first;
+        const size_t childEnd = children[childIndex].second;
+        if (childEnd - childBegin > targetSubtreeSize) {
+            addSiblingRun();
+            if (!SplitNode(data, childBegin, childEnd, nodeSubtreeIndex, targetSubtreeSize)) {
+                return false;
+            }
+            continue;
+        }
+        if (runChildCount == 0) {
+            runFirstChild = childIndex;
+        }
+        runChildCount++;
+        if (childEnd - children[runFirstChild].first >= targetSubtreeSize) {
+            addSiblingRun();
+        }
+    }
+    addSiblingRun();
+    return true;
+}
+
+// Runs on worker threads, only reads the scene text and writes 'subtree'
+bool SceneNodeJsonParallelParser::CompileSubtree(SceneSubtree& subtree, const char* data, const std::string& sceneFilePath) const {
+    std::string subtreeText;
+    if (subtree.isSiblingRun) {
+        subtreeText = R"({"name": "", "tags": [], "external_scene_source": "", "components": [], "children": [)";
+        subtreeText.append(data + subtree.textBegin, subtree.textEnd - subtree.textBegin);
+        subtreeText.append("]}");
+    } else if (subtree.childrenEnd != 0) {
+        subtreeText.append(data + subtree.textBegin, subtree.childrenBegin - subtree.textBegin);
+        subtreeText.append("[]");
+        subtreeText.append(data + subtree.childrenEnd, subtree.textEnd - subtree.childrenEnd);
+    } else {
+        subtreeText.assign(data + subtree.textBegin, subtree.textEnd - subtree.textBegin);
+    }
+    const nlohmann::json subtreeJson = nlohmann::json::parse(subtreeText, nullptr, false);
+    if (subtreeJson.is_discarded() || !subtreeJson.is_object()) {
+        return false;
+    }
+    subtree.compiledScene = BinarySceneCompiler::CompileSceneJson(subtreeJson, sceneFilePath);
+    if (subtree.compiledScene.size() < sizeof(BinarySceneFormat::Header)) {
+        return false;
+    }
+    const BinarySceneFormat::Header* header = reinterpret_cast<const BinarySceneFormat::Header*>(subtree.compiledScene.data());
+    subtree.nodeCount = subtree.isSiblingRun ? header->nodeCount - 1 : header->nodeCount;
+    return true;
+}
+
+uint32_t SceneNodeJsonParallelParser::GetNodeCount() const {
+    return nodeCount;
+}
+
+Entity SceneNodeJsonParallelParser::ParseNextNode(Scene* scene) {
+    assert(parseSubtreeIndex < subtrees.size() && "Every node has already been parsed!");
+    SceneSubtree& subtree = subtrees[parseSubtreeIndex];
+    const Entity parent = subtree.parentSubtreeIndex == NO_PARENT ? NULL_ENTITY : subtrees[subtree.parentSubtreeIndex].entity;
+    if (parseNodeIndex == 0) {
+        const bool isOpen = sceneNodeBinaryParser.Open(subtree.compiledScene.data(), subtree.compiledScene.size());
+        assert(isOpen && "Compiled subtree is invalid!");
+        if (subtree.isSiblingRun) {
+            sceneNodeBinaryParser.AttachRootNode(parent);
+            parseNodeIndex = 1;
+        }
+    }
+    const Entity entity = sceneNodeBinaryParser.ParseSceneNode(scene, parseNodeIndex, parent);
+    if (parseNodeIndex == 0) {
+        subtree.entity = entity;
+    }
+    parseNodeIndex++;
+    if (parseNodeIndex == sceneNodeBinaryParser.GetNodeCount()) {
+        std::vector<char>().swap(subtree.compiledScene);
+        parseSubtreeIndex++;
+        parseNodeIndex = 0;
+    }
+    return entity;
+}
+
+void SceneNodeJsonParallelParser::ParseScene(Scene* scene) {
+    for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++) {
+        ParseNextNode(scene);
+    }
+}
+
+void SceneNodeJsonParallelParser::Clear() {
+    subtrees.clear();
+    nodeCount = 0;
+    parseSubtreeIndex = 0;
+    parseNodeIndex = 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "scene.h"
+#include "scene_node_binary_parser.h"
+
+#include "../ecs/entity/entity_manager.h"
+#include "../ecs/component/component_manager.h"
+
+// Loads large json scenes on every core.  The text is scanned once for node boundaries and split into runs of sibling
+// subtrees, each run is parsed and compiled on a worker thread into its own compiled scene.  Workers never touch the
+// ECS, entities are created afterwards from the compiled runs in document order so each subtree gets a contiguous
+// range of entity ids and the scene matches a sequential load.
+class SceneNodeJsonParallelParser {
+  public:
+    SceneNodeJsonParallelParser(EntityManager* entityManager, ComponentManager* componentManager);
+    // Small scenes and machines with few cores are faster with the single threaded parsers
+    static bool ShouldParseInParallel(size_t size);
+    // Compiles every subtree of the json in 'data', which only has to stay valid during the call.  Returns false for
+    // malformed json, no entities are created either way.
+    bool Compile(const char* data, size_t size, const std::string& sceneFilePath);
+    uint32_t GetNodeCount() const;
+    // Creates the next node in document order, parents are always created before their children
+    Entity ParseNextNode(Scene* scene);
+    void ParseScene(Scene* scene);
+    // Frees the compiled subtrees
+    void Clear();
+
+  private:
+    static const size_t NO_PARENT = static_cast<size_t>(-1);
+    static const size_t MIN_PARALLEL_SCENE_SIZE = 1024 * 1024;
+    // Building and compiling a document costs a few times streaming the same json, so fewer cores don't win it back
+    static const unsigned int MIN_PARALLEL_WORKER_COUNT = 4;
+
+    // Either a single node compiled without its children, which are split into later subtrees, or a run of siblings
+    // compiled under a placeholder root that's mapped to their parent's entity
+    struct SceneSubtree {
+        size_t parentSubtreeIndex = NO_PARENT;
+        bool isSiblingRun = false;
+        size_t textBegin = 0;
+        size_t textEnd = 0;
+        size_t childrenBegin = 0; // Children array left out of a single node
+        size_t childrenEnd = 0;
+        std::vector<char> compiledScene;
+        uint32_t nodeCount = 0; // Nodes created from the subtree, the placeholder root isn't one
+        Entity entity = NULL_ENTITY; // Single node's entity once created
+    };
+
+    SceneNodeBinaryParser sceneNodeBinaryParser;
+    std::vector<SceneSubtree> subtrees;
+    uint32_t nodeCount = 0;
+    size_t parseSubtreeIndex = 0;
+    uint32_t parseNodeIndex = 0;
+
+    bool SplitNode(const char* data, size_t nodeBegin, size_t nodeEnd, size_t parentSubtreeIndex, size_t targetSubtreeSize);
+    bool CompileSubtree(SceneSubtree& subtree, const char* data, const std::string& sceneFilePath) const;
+};
@@ -0,0 +1,447 @@
+#include "scene_json_stream_parser.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "../ecs/component/components/scene_component.h"
+#include "../ecs/component/components/text_label_component.h"
+#include "../ecs/component/components/sprite_component.h"
+#include "../ecs/component/components/animated_sprite_component.h"
+#include "../ecs/component/components/collider_component.h"
+
+static void SetRectangleField(Rect2& rectangle, const char* key, float value) {
+    if (std::strcmp(key, "x") == 0) {
+        rectangle.x = value;
+    } else if (std::strcmp(key, "y") == 0) {
+        rectangle.y = value;
+    } else if (std::strcmp(key, "width") == 0) {
+        rectangle.w = value;
+    } else if (std::strcmp(key, "height") == 0) {
+        rectangle.h = value;
+    }
+}
+
+static void SetColorField(int* color, const char* key, int value) {
+    if (std::strcmp(key, "red") == 0) {
+        color[0] = value;
+    } else if (std::strcmp(key, "green") == 0) {
+        color[1] = value;
+    } else if (std::strcmp(key, "blue") == 0) {
+        color[2] = value;
+    } else if (std::strcmp(key, "alpha") == 0) {
+        color[3] = value;
+    }
+}
+
+static Color GetNormalizedColor(const int* color) {
+    return Color::NormalizedColor(color[0], color[1], color[2], color[3]);
+}
+
+SceneNodeJsonStreamParser::SceneNodeJsonStreamParser(EntityManager* entityManager, ComponentManager* componentManager) :
+    entityManager(entityManager),
+    componentManager(componentManager),
+    assetManager(AssetManager::GetInstance()),
+    sceneNodeBinaryParser(entityManager, componentManager) {}
+
+bool SceneNodeJsonStreamParser::ParseScene(Scene* scene, const char* data, size_t size) {
+    this->scene = scene;
+    containers.clear();
+    nodes.clear();
+    path.clear();
+    isReadingComponent = false;
+    return nlohmann::json::sax_parse(data, data + size, this);
+}
+
+size_t SceneNodeJsonStreamParser::GetScopePathLength() const {
+    return isReadingComponent ? component.pathLength : nodes.back().pathLength;
+}
+
+// Paths are relative to the current node or component, e.g. 'draw_source.x' while reading a sprite
+bool SceneNodeJsonStreamParser::IsPath(const char* relativePath) const {
+    const size_t scopePathLength = GetScopePathLength();
+    return path.size() > scopePathLength && path.compare(scopePathLength + 1, std::string::npos, relativePath) == 0;
+}
+
+// Returns the key of the current value if it's a direct member of 'relativeObjectPath', nullptr otherwise
+const char* SceneNodeJsonStreamParser::GetKeyIn(const char* relativeObjectPath) const {
+    const size_t objectPathStart = GetScopePathLength() + 1;
+    const size_t objectPathLength = std::strlen(relativeObjectPath);
+    const size_t keyStart = objectPathStart + objectPathLength + 1;
+    if (path.size() <= keyStart || path[keyStart - 1] != '.'
+            || path.compare(objectPathStart, objectPathLength, relativeObjectPath) != 0) {
+        return nullptr;
+    }
+    const char* key = path.c_str() + keyStart;
+    return std::strchr(key, '.') ? nullptr : key;
+}
+
+SceneNodeJsonStreamParser::ContainerType SceneNodeJsonStreamParser::GetObjectType() const {
+    if (nodes.empty()) {
+        return containers.empty() ? ContainerType::NODE : ContainerType::VALUE;
+    }
+    const Container& parentContainer = containers.back();
+    if (isReadingComponent) {
+        if (parentContainer.isArray && component.type == NodeComponentType::ANIMATED_SPRITE) {
+            if (IsPath("animations")) {
+                return ContainerType::ANIMATION;
+            } else if (IsPath("animations.frames")) {
+                return ContainerType::ANIMATION_FRAME;
+            }
+        }
+        return ContainerType::VALUE;
+    }
+    if (parentContainer.type == ContainerType::COMPONENT_ENTRY) {
+        return ContainerType::COMPONENT;
+    } else if (parentContainer.isArray && IsPath("components")) {
+        return ContainerType::COMPONENT_ENTRY;
+    } else if (parentContainer.isArray && IsPath("children")) {
+        return ContainerType::NODE;
+    }
+    return ContainerType::VALUE;
+}
+
+bool SceneNodeJsonStreamParser::start_object(std::size_t /*elementCount*/) {
+    const ContainerType containerType = GetObjectType();
+    switch (containerType) {
+    case ContainerType::NODE:
+        StartNode();
+        break;
+    case ContainerType::COMPONENT:
+        StartComponent();
+        break;
+    case ContainerType::ANIMATION:
+        component.animation = Animation{};
+        break;
+    case ContainerType::ANIMATION_FRAME:
+        component.animationFrame = AnimationFrame{};
+        break;
+    default:
+        break;
+    }
+    containers.emplace_back(Container{ containerType, false, path.size() });
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::key(nlohmann::json::string_t& value) {
+    path.resize(containers.back().pathLength);
+    path += '.';
+    path += value;
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::end_object() {
+    const Container container = containers.back();
+    containers.pop_back();
+    path.resize(container.pathLength);
+    switch (container.type) {
+    case ContainerType::NODE:
+        FinishNode();
+        break;
+    case ContainerType::COMPONENT:
+        FinishComponent();
+        break;
+    case ContainerType::ANIMATION:
+        component.animation.frames = static_cast<unsigned int>(component.animation.animationFrames.size());
+        component.animations.emplace(component.animation.name, component.animation);
+        break;
+    case ContainerType::ANIMATION_FRAME:
+        component.animation.animationFrames.emplace(component.animationFrame.frame, component.animationFrame);
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::start_array(std::size_t /*elementCount*/) {
+    containers.emplace_back(Container{ ContainerType::VALUE, true, path.size() });
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::end_array() {
+    path.resize(containers.back().pathLength);
+    containers.pop_back();
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::null() {
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::boolean(bool value) {
+    SetBoolean(value);
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::number_integer(nlohmann::json::number_integer_t value) {
+    SetNumber(static_cast<double>(value));
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::number_unsigned(nlohmann::json::number_unsigned_t value) {
+    SetNumber(static_cast<double>(value));
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t& /*text*/) {
+    SetNumber(value);
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::string(nlohmann::json::string_t& value) {
+    SetString(value);
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::binary(nlohmann::json::binary_t& /*value*/) {
+    return true;
+}
+
+bool SceneNodeJsonStreamParser::parse_error(std::size_t position, const std::string& /*lastToken*/, const nlohmann::detail::exception& exception) {
+    Logger::GetInstance()->Error("Failed to parse scene json at byte %zu: %s", position, exception.what());
+    return false;
+}
+
+// Entities join the hierarchy when their object opens so children can be attached before the node is complete
+void SceneNodeJsonStreamParser::StartNode() {
+    const Entity parent = nodes.empty() ? NULL_ENTITY : nodes.back().entity;
+    const Entity entity = entityManager->CreateEntity();
+    scene->hierarchy.AddNode(entity, parent);
+    if (parent == NULL_ENTITY) {
+        scene->rootEntity = entity;
+    }
+    NodeState node;
+    node.entity = entity;
+    node.parent = parent;
+    node.pathLength = path.size();
+    nodes.emplace_back(node);
+}
+
+// Scene component is added last as the name may come after the node's children, earlier siblings are complete by now
+void SceneNodeJsonStreamParser::FinishNode() {
+    NodeState& node = nodes.back();
+    if (!node.externalSceneSource.empty()) {
+        sceneNodeBinaryParser.InstantiateScene(scene, node.entity, node.externalSceneSource);
+    }
+    componentManager->AddComponent(node.entity, SceneComponent{
+        scene->nodeIndex.AddNode(node.entity, node.parent, node.name),
+        node.tags
+    });
+    const ComponentType sceneComponentType = componentManager->GetComponentType<SceneComponent>();
+    auto signature = entityManager->GetSignature(node.entity);
+    signature.set(sceneComponentType, true);
+    entityManager->SetSignature(node.entity, signature);
+    auto enabledSignature = entityManager->GetEnabledSignature(node.entity);
+    enabledSignature.set(sceneComponentType, true);
+    entityManager->SetEnabledSignature(node.entity, enabledSignature);
+    nodes.pop_back();
+}
+
+void SceneNodeJsonStreamParser::StartComponent() {
+    const char* componentTypeName = GetKeyIn("components");
+    component = ComponentState{};
+    if (std::strcmp(componentTypeName, "transform2D") == 0) {
+        component.type = NodeComponentType::TRANSFORM_2D;
+    } else if (std::strcmp(componentTypeName, "sprite") == 0) {
+        component.type = NodeComponentType::SPRITE;
+    } else if (std::strcmp(componentTypeName, "text_label") == 0) {
+        component.type = NodeComponentType::TEXT_LABEL;
+    } else if (std::strcmp(componentTypeName, "animated_sprite") == 0) {
+        component.type = NodeComponentType::ANIMATED_SPRITE;
+    } else if (std::strcmp(componentTypeName, "collider") == 0) {
+        component.type = NodeComponentType::COLLIDER;
+    }
+    component.pathLength = path.size();
+    isReadingComponent = true;
+}
+
+template<typename T>
+void SceneNodeJsonStreamParser::AddComponentSignature(Entity entity, bool isEnabled) {
+    auto signature = entityManager->GetEnabledSignature(entity);
+    signature.set(componentManager->GetComponentType<T>(), true);
+    entityManager->SetSignature(entity, signature);
+    if (isEnabled) {
+        entityManager->SetEnabledSignature(entity, signature);
+    }
+}
+
+void SceneNodeJsonStreamParser::FinishComponent() {
+    isReadingComponent = false;
+    const Entity entity = nodes.back().entity;
+    switch (component.type) {
+    case NodeComponentType::TRANSFORM_2D:
+        componentManager->AddComponent(entity, component.transform2D);
+        AddComponentSignature<Transform2DComponent>(entity, component.isEnabled);
+        break;
+    case NodeComponentType::SPRITE:
+        componentManager->AddComponent(entity, SpriteComponent{
+            .texture = component.text.empty() ? nullptr : assetManager->GetTexture(component.text),
+            .drawSource = component.rectangle,
+            .flipX = component.flipX,
+            .flipY = component.flipY,
+            .modulate = GetNormalizedColor(component.color)
+        });
+        AddComponentSignature<SpriteComponent>(entity, component.isEnabled && !component.text.empty());
+        break;
+    case NodeComponentType::TEXT_LABEL:
+        componentManager->AddComponent(entity, TextLabelComponent{
+            .text = component.text,
+            .font = component.fontUID.empty() ? nullptr : assetManager->GetFont(component.fontUID),
+            .color = GetNormalizedColor(component.color)
+        });
+        AddComponentSignature<TextLabelComponent>(entity, component.isEnabled && !component.fontUID.empty());
+        break;
+    case NodeComponentType::ANIMATED_SPRITE:
+        assert(component.animations.count(component.text) > 0 && "Trying to set current animation to an animation that doesn't exist!");
+        componentManager->AddComponent(entity, AnimatedSpriteComponent{
+            component.animations,
+            component.animations[component.text],
+            component.isPlaying,
+            component.flipX,
+            component.flipY,
+            GetNormalizedColor(component.color)
+        });
+        AddComponentSignature<AnimatedSpriteComponent>(entity, component.isEnabled);
+        break;
+    case NodeComponentType::COLLIDER:
+        componentManager->AddComponent(entity, ColliderComponent{
+            component.rectangle,
+            GetNormalizedColor(component.color)
+        });
+        AddComponentSignature<ColliderComponent>(entity, component.isEnabled);
+        break;
+    default:
+        break;
+    }
+}
+
+// Reads the same keys as SceneNodeJsonParser, values outside known keys are skipped
+void SceneNodeJsonStreamParser::SetNumber(double value) {
+    if (!isReadingComponent) {
+        return;
+    }
+    const char* key = nullptr;
+    switch (component.type) {
+    case NodeComponentType::TRANSFORM_2D:
+        if ((key = GetKeyIn("position"))) {
+            (std::strcmp(key, "x") == 0 ? component.transform2D.position.x : component.transform2D.position.y) = static_cast<float>(value);
+        } else if ((key = GetKeyIn("scale"))) {
+            (std::strcmp(key, "x") == 0 ? component.transform2D.scale.x : component.transform2D.scale.y) = static_cast<float>(value);
+        } else if (IsPath("rotation")) {
+            component.transform2D.rotation = static_cast<float>(value);
+        } else if (IsPath("z_index")) {
+            component.transform2D.zIndex = static_cast<int>(value);
+        }
+        break;
+    case NodeComponentType::SPRITE:
+        if ((key = GetKeyIn("draw_source"))) {
+            SetRectangleField(component.rectangle, key, static_cast<float>(value));
+        } else if ((key = GetKeyIn("modulate"))) {
+            SetColorField(component.color, key, static_cast<int>(value));
+        }
+        break;
+    case NodeComponentType::TEXT_LABEL:
+        if ((key = GetKeyIn("color"))) {
+            SetColorField(component.color, key, static_cast<int>(value));
+        }
+        break;
+    case NodeComponentType::ANIMATED_SPRITE:
+        if ((key = GetKeyIn("modulate"))) {
+            SetColorField(component.color, key, static_cast<int>(value));
+        } else if (IsPath("animations.speed")) {
+            component.animation.speed = static_cast<int>(value);
+        } else if (IsPath("animations.frames.frame")) {
+            component.animationFrame.frame = static_cast<int>(value);
+        } else if ((key = GetKeyIn("animations.frames.draw_source"))) {
+            SetRectangleField(component.animationFrame.drawSource, key, static_cast<float>(value));
+        }
+        break;
+    case NodeComponentType::COLLIDER:
+        if ((key = GetKeyIn("rectangle"))) {
+            SetRectangleField(component.rectangle, key, static_cast<float>(value));
+        } else if ((key = GetKeyIn("color"))) {
+            SetColorField(component.color, key, static_cast<int>(value));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void SceneNodeJsonStreamParser::SetBoolean(bool value) {
+    if (!isReadingComponent) {
+        return;
+    }
+    if (IsPath("enabled")) {
+        component.isEnabled = value;
+        return;
+    }
+    switch (component.type) {
+    case NodeComponentType::TRANSFORM_2D:
+        if (IsPath("z_index_relative_to_parent")) {
+            component.transform2D.isZIndexRelativeToParent = value;
+        } else if (IsPath("ignore_camera")) {
+            component.transform2D.ignoreCamera = value;
+        }
+        break;
+    case NodeComponentType::SPRITE:
+        if (IsPath("flip_x")) {
+            component.flipX = value;
+        } else if (IsPath("flip_y")) {
+            component.flipY = value;
+        }
+        break;
+    case NodeComponentType::ANIMATED_SPRITE:
+        if (IsPath("is_playing")) {
+            component.isPlaying = value;
+        } else if (IsPath("flip_x")) {
+            component.flipX = value;
+        } else if (IsPath("flip_y")) {
+            component.flipY = value;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void SceneNodeJsonStreamParser::SetString(const std::string& value) {
+    if (nodes.empty()) {
+        return;
+    }
+    if (!isReadingComponent) {
+        if (IsPath("name")) {
+            nodes.back().name = value;
+        } else if (IsPath("tags") && containers.back().isArray) {
+            nodes.back().tags.emplace_back(value);
+        } else if (IsPath("external_scene_source")) {
+            nodes.back().externalSceneSource = value;
+        }
+        return;
+    }
+    switch (component.type) {
+    case NodeComponentType::SPRITE:
+        if (IsPath("texture_path")) {
+            component.text = value;
+        }
+        break;
+    case NodeComponentType::TEXT_LABEL:
+        if (IsPath("text")) {
+            component.text = value;
+        } else if (IsPath("font_uid")) {
+            component.fontUID = value;
+        }
+        break;
+    case NodeComponentType::ANIMATED_SPRITE:
+        if (IsPath("current_animation")) {
+            component.text = value;
+        } else if (IsPath("animations.name")) {
+            component.animation.name = value;
+        } else if (IsPath("animations.frames.texture_path")) {
+            component.animationFrame.texture = assetManager->GetTexture(value);
+        }
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <json/json.hpp>
+
+#include "scene.h"
+#include "scene_node_binary_parser.h"
+
+#include "../ecs/entity/entity_manager.h"
+#include "../ecs/component/component_manager.h"
+#include "../ecs/component/components/transform2d_component.h"
+#include "../animation/animation.h"
+#include "../data/asset_manager.h"
+
+// Creates scene nodes while a json scene is read, each component is added as soon as its object closes instead of
+// building a json document first.  Produces the same nodes as SceneNodeJsonParser, keys may come in any order.
+class SceneNodeJsonStreamParser {
+  public:
+    SceneNodeJsonStreamParser(EntityManager* entityManager, ComponentManager* componentManager);
+    // Returns false for malformed json, nodes read before the error stay in 'scene'
+    bool ParseScene(Scene* scene, const char* data, size_t size);
+
+    // nlohmann::json SAX interface
+    bool null();
+    bool boolean(bool value);
+    bool number_integer(nlohmann::json::number_integer_t value);
+    bool number_unsigned(nlohmann::json::number_unsigned_t value);
+    bool number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t& text);
+    bool string(nlohmann::json::string_t& value);
+    bool binary(nlohmann::json::binary_t& value);
+    bool start_object(std::size_t elementCount);
+    bool key(nlohmann::json::string_t& value);
+    bool end_object();
+    bool start_array(std::size_t elementCount);
+    bool end_array();
+    bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& exception);
+
+  private:
+    enum class ContainerType : int {
+        VALUE = 0,
+        NODE = 1,
+        COMPONENT_ENTRY = 2, // '{ "sprite": {...} }' inside a node's component array
+        COMPONENT = 3,
+        ANIMATION = 4,
+        ANIMATION_FRAME = 5,
+    };
+
+    enum class NodeComponentType : int {
+        UNKNOWN = 0,
+        TRANSFORM_2D = 1,
+        SPRITE = 2,
+        TEXT_LABEL = 3,
+        ANIMATED_SPRITE = 4,
+        COLLIDER = 5,
+    };
+
+    struct Container {
+        ContainerType type = ContainerType::VALUE;
+        bool isArray = false;
+        size_t pathLength = 0; // Length of 'path' when the container started
+    };
+
+    struct NodeState {
+        Entity entity = NULL_ENTITY;
+        Entity parent = NULL_ENTITY;
+        std::string name;
+        std::vector<std::string> tags;
+        std::string externalSceneSource;
+        size_t pathLength = 0;
+    };
+
+    // Fields of the component being read, only the ones used by 'type' are set
+    struct ComponentState {
+        NodeComponentType type = NodeComponentType::UNKNOWN;
+        bool isEnabled = true;
+        Transform2DComponent transform2D;
+        Rect2 rectangle; // Draw source for sprites, rectangle for colliders
+        int color[4] = { 255, 255, 255, 255 }; // Modulate for sprites, color for text labels and colliders
+        bool flipX = false;
+        bool flipY = false;
+        bool isPlaying = false;
+        std::string text; // Texture path for sprites, current animation for animated sprites
+        std::string fontUID;
+        std::unordered_map<std::string, Animation> animations;
+        Animation animation;
+        AnimationFrame animationFrame;
+        size_t pathLength = 0;
+    };
+
+    EntityManager *entityManager = nullptr;
+    ComponentManager *componentManager = nullptr;
+    AssetManager *assetManager = nullptr;
+    SceneNodeBinaryParser sceneNodeBinaryParser; // Instances external scenes
+    Scene* scene = nullptr;
+    std::vector<Container> containers;
+    std::vector<NodeState> nodes;
+    ComponentState component;
+    bool isReadingComponent = false;
+    // Keys from the document root joined by '.', compared relative to the current node or component
+    std::string path;
+
+    size_t GetScopePathLength() const;
+    bool IsPath(const char* relativePath) const;
+    const char* GetKeyIn(const char* relativeObjectPath) const;
+    ContainerType GetObjectType() const;
+    void StartNode();
+    void FinishNode();
+    void StartComponent();
+    void FinishComponent();
+    void SetNumber(double value);
+    void SetBoolean(bool value);
+    void SetString(const std::string& value);
+    template<typename T>
+    void AddComponentSignature(Entity entity, bool isEnabled);
+};
@@ -1,75 +1,44 @@
 #include "scene_loader.h"
 
 #include <cassert>
+#include <chrono>
 
-unsigned int SceneNodeJsonParser::GetEntityNameCount(const std::string& name, const SceneNode& parentSceneNode) {
-    unsigned int enitityNameCount = 0;
-    for (const SceneNode& childrenSceneNode : parentSceneNode.children) {
-        SceneComponent sceneComponent = componentManager->GetComponent<SceneComponent>(childrenSceneNode.entity);
-        std::string childName = sceneComponent.name;
-        const std::string& childNumberAtTheEndString = Helper::GetNumberFromEndOfString(childName);
-        if (childNumberAtTheEndString.empty()) {
-            continue;
-        }
-        childName.resize(childName.size() - childNumberAtTheEndString.size());
-        unsigned int childNumberAtEnd = Helper::ConvertStringToUnsignedInt(childNumberAtTheEndString);
-        enitityNameCount = std::max(enitityNameCount, childNumberAtEnd);
-    }
-    return enitityNameCount;
-}
+#include "scene_template_cache.h"
 
-std::string SceneNodeJsonParser::GetUniqueSceneNodeName(const std::string& name, const SceneNode& parentSceneNode) {
-    if (!parentSceneNode.children.empty()) {
-        unsigned int entitiesWithSameNameCount = GetEntityNameCount(name, parentSceneNode);
-        if (entitiesWithSameNameCount > 0) {
-            unsigned int uniqueId = entitiesWithSameNameCount + 1;
-            const std::string& numberAtEndString = Helper::GetNumberFromEndOfString(name);
-            std::string nameWithoutNumber = Helper::RemoveNumberFromEndOfString(name);
-            // Make sure provided number isn't higher than unique id
-            if (!numberAtEndString.empty()) {
-                unsigned int numberAtTheEnd = Helper::ConvertStringToUnsignedInt(numberAtEndString);
-                uniqueId = std::max(uniqueId, numberAtTheEnd);
-            }
-            return nameWithoutNumber + std::to_string(uniqueId);
-        }
-    }
-    return name;
-}
-
-SceneComponent SceneNodeJsonParser::GenerateSceneComponent(const std::string& nodeName, const SceneNode& parentSceneNode, const nlohmann::json& nodeTagsJsonArray) {
+SceneComponent SceneNodeJsonParser::GenerateSceneComponent(Entity entity, const std::string& nodeName, Scene* scene, Entity parent, const nlohmann::json& nodeTagsJsonArray) {
     std::vector<std::string> nodeTags = {};
     for (auto& nodeTag : nodeTagsJsonArray) {
         nodeTags.emplace_back(nodeTag);
     }
     return SceneComponent{
-        GetUniqueSceneNodeName(nodeName, parentSceneNode),
+        scene->nodeIndex.AddNode(entity, parent, nodeName),
         nodeTags
     };
 }
 
-void SceneNodeJsonParser::ParseComponentArray(SceneNode &sceneNode, const nlohmann::json& nodeComponentJsonArray) {
-    for (nlohmann::json nodeComponentJson : nodeComponentJsonArray) {
-        nlohmann::json::iterator it = nodeComponentJson.begin();
+void SceneNodeJsonParser::ParseComponentArray(Entity entity, const nlohmann::json& nodeComponentJsonArray) {
+    for (const nlohmann::json& nodeComponentJson : nodeComponentJsonArray) {
+        nlohmann::json::const_iterator it = nodeComponentJson.begin();
         const std::string &nodeComponentType = it.key();
-        nlohmann::json nodeComponentObjectJson = it.value();
+        const nlohmann::json& nodeComponentObjectJson = it.value();
         // TODO: Map to functions with keys
         if (nodeComponentType == "transform2D") {
-            ParseTransform2DComponent(sceneNode, nodeComponentObjectJson);
+            ParseTransform2DComponent(entity, nodeComponentObjectJson);
         } else if (nodeComponentType == "sprite") {
-            ParseSpriteComponent(sceneNode, nodeComponentObjectJson);
+            ParseSpriteComponent(entity, nodeComponentObjectJson);
         } else if (nodeComponentType == "text_label") {
-            ParseTextLabelComponent(sceneNode, nodeComponentObjectJson);
+            ParseTextLabelComponent(entity, nodeComponentObjectJson);
         } else if (nodeComponentType == "animated_sprite") {
-            ParseAnimatedSpriteComponent(sceneNode, nodeComponentObjectJson);
+            ParseAnimatedSpriteComponent(entity, nodeComponentObjectJson);
         } else if (nodeComponentType == "collider") {
-            ParseColliderComponent(sceneNode, nodeComponentObjectJson);
+            ParseColliderComponent(entity, nodeComponentObjectJson);
         }
     }
 }
 
-void SceneNodeJsonParser::ParseTransform2DComponent(SceneNode &sceneNode, const nlohmann::json& nodeComponentObjectJson) {
-    nlohmann::json nodeTransform2DPosition = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "position");
-    nlohmann::json nodeTransform2DScale = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "scale");
+void SceneNodeJsonParser::ParseTransform2DComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson) {
+    const nlohmann::json& nodeTransform2DPosition = JsonHelper::GetJson(nodeComponentObjectJson, "position");
+    const nlohmann::json& nodeTransform2DScale = JsonHelper::GetJson(nodeComponentObjectJson, "scale");
     const Vector2 nodePosition = Vector2(
                                      JsonHelper::Get<float>(nodeTransform2DPosition, "x"),
                                      JsonHelper::Get<float>(nodeTransform2DPosition, "y"));
@@ -81,7 +50,7 @@ void SceneNodeJsonParser::ParseTransform2DComponent(SceneNode &sceneNode, const
     const bool nodeZIndexIsRelativeToParent = JsonHelper::Get<bool>(nodeComponentObjectJson, "z_index_relative_to_parent");
     const bool nodeIgnoreCamera = JsonHelper::Get<bool>(nodeComponentObjectJson, "ignore_camera");
 
-    componentManager->AddComponent(sceneNode.entity, Transform2DComponent{
+    componentManager->AddComponent(entity, Transform2DComponent{
         .position = nodePosition,
         .scale = nodeScale,
         .rotation = nodeRotation,
@@ -89,25 +58,25 @@ void SceneNodeJsonParser::ParseTransform2DComponent(SceneNode &sceneNode, const
         .isZIndexRelativeToParent = nodeZIndexIsRelativeToParent,
         .ignoreCamera = nodeIgnoreCamera
     });
-    auto signature = entityManager->GetEnabledSignature(sceneNode.entity);
+    auto signature = entityManager->GetEnabledSignature(entity);
     bool isTransformComponentEnabled = JsonHelper::GetDefault<bool>(nodeComponentObjectJson, "enabled", true);
     signature.set(componentManager->GetComponentType<Transform2DComponent>(), true);
-    entityManager->SetSignature(sceneNode.entity, signature);
+    entityManager->SetSignature(entity, signature);
     if (isTransformComponentEnabled) {
-        entityManager->SetEnabledSignature(sceneNode.entity, signature);
+        entityManager->SetEnabledSignature(entity, signature);
     }
 }
 
-void SceneNodeJsonParser::ParseSpriteComponent(SceneNode &sceneNode, const nlohmann::json& nodeComponentObjectJson) {
+void SceneNodeJsonParser::ParseSpriteComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson) {
     const std::string &nodeTexturePath = JsonHelper::Get<std::string>(nodeComponentObjectJson, "texture_path");
-    nlohmann::json nodeDrawSourceJson = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "draw_source");
+    const nlohmann::json& nodeDrawSourceJson = JsonHelper::GetJson(nodeComponentObjectJson, "draw_source");
     const float nodeDrawSourceX = JsonHelper::Get<float>(nodeDrawSourceJson, "x");
     const float nodeDrawSourceY = JsonHelper::Get<float>(nodeDrawSourceJson, "y");
     const float nodeDrawSourceWidth = JsonHelper::Get<float>(nodeDrawSourceJson, "width");
     const float nodeDrawSourceHeight = JsonHelper::Get<float>(nodeDrawSourceJson, "height");
     const bool nodeFlipX = JsonHelper::Get<bool>(nodeComponentObjectJson, "flip_x");
-    const bool nodeFlipY = JsonHelper::Get<bool>(nodeComponentObjectJson, "flip_x");
-    nlohmann::json nodeModulateJson = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "modulate");
+    const bool nodeFlipY = JsonHelper::GetDefault<bool>(nodeComponentObjectJson, "flip_y", false);
+    const nlohmann::json& nodeModulateJson = JsonHelper::GetJson(nodeComponentObjectJson, "modulate");
     const Color nodeModulate = Color::NormalizedColor(
                                    JsonHelper::Get<int>(nodeModulateJson, "red"),
                                    JsonHelper::Get<int>(nodeModulateJson, "green"),
@@ -115,27 +84,27 @@ void SceneNodeJsonParser::ParseSpriteComponent(SceneNode &sceneNode, const nlohm
                                    JsonHelper::Get<int>(nodeModulateJson, "alpha")
                                );
 
-    componentManager->AddComponent(sceneNode.entity, SpriteComponent{
+    componentManager->AddComponent(entity, SpriteComponent{
         .texture = nodeTexturePath.empty() ? nullptr : assetManager->GetTexture(nodeTexturePath),
         .drawSource = Rect2(nodeDrawSourceX, nodeDrawSourceY, nodeDrawSourceWidth, nodeDrawSourceHeight),
         .flipX = nodeFlipX,
         .flipY = nodeFlipY,
         .modulate = nodeModulate
     });
-    auto signature = entityManager->GetEnabledSignature(sceneNode.entity);
+    auto signature = entityManager->GetEnabledSignature(entity);
     signature.set(componentManager->GetComponentType<SpriteComponent>(), true);
-    entityManager->SetSignature(sceneNode.entity, signature);
+    entityManager->SetSignature(entity, signature);
     const bool isSpriteEnabled = !nodeTexturePath.empty();
     bool isSpriteComponentEnabled = JsonHelper::GetDefault<bool>(nodeComponentObjectJson, "enabled", true);
     if (isSpriteEnabled && isSpriteComponentEnabled) {
-        entityManager->SetEnabledSignature(sceneNode.entity, signature);
+        entityManager->SetEnabledSignature(entity, signature);
     }
 }
 
-void SceneNodeJsonParser::ParseTextLabelComponent(SceneNode& sceneNode, const nlohmann::json& nodeComponentObjectJson) {
+void SceneNodeJsonParser::ParseTextLabelComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson) {
     const std::string &nodeText = JsonHelper::Get<std::string>(nodeComponentObjectJson, "text");
     const std::string &nodeFontUID = JsonHelper::Get<std::string>(nodeComponentObjectJson, "font_uid");
-    nlohmann::json nodeColorJson = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "color");
+    const nlohmann::json& nodeColorJson = JsonHelper::GetJson(nodeComponentObjectJson, "color");
     const Color nodeColor = Color::NormalizedColor(
                                 JsonHelper::Get<int>(nodeColorJson, "red"),
                                 JsonHelper::Get<int>(nodeColorJson, "green"),
@@ -143,34 +112,34 @@ void SceneNodeJsonParser::ParseTextLabelComponent(SceneNode& sceneNode, const nl
                                 JsonHelper::Get<int>(nodeColorJson, "alpha")
                             );
 
-    componentManager->AddComponent(sceneNode.entity, TextLabelComponent{
+    componentManager->AddComponent(entity, TextLabelComponent{
         .text = nodeText,
         .font = nodeFontUID.empty() ? nullptr : assetManager->GetFont(nodeFontUID),
         .color = nodeColor
     });
-    auto signature = entityManager->GetEnabledSignature(sceneNode.entity);
+    auto signature = entityManager->GetEnabledSignature(entity);
     signature.set(componentManager->GetComponentType<TextLabelComponent>(), true);
-    entityManager->SetSignature(sceneNode.entity, signature);
+    entityManager->SetSignature(entity, signature);
     const bool isTextLabelEnabled = !nodeFontUID.empty();
     bool isTextLabelComponentEnabled = JsonHelper::GetDefault<bool>(nodeComponentObjectJson, "enabled", true);
     if (isTextLabelEnabled && isTextLabelComponentEnabled) {
-        entityManager->SetEnabledSignature(sceneNode.entity, signature);
+        entityManager->SetEnabledSignature(entity, signature);
     }
 }
 
-void SceneNodeJsonParser::ParseAnimatedSpriteComponent(SceneNode& sceneNode, const nlohmann::json& nodeComponentObjectJson) {
+void SceneNodeJsonParser::ParseAnimatedSpriteComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson) {
     const std::string& currentAnimationName = JsonHelper::Get<std::string>(nodeComponentObjectJson, "current_animation");
     const bool isPlaying = JsonHelper::Get<bool>(nodeComponentObjectJson, "is_playing");
     const bool flipX = JsonHelper::Get<bool>(nodeComponentObjectJson, "flip_x");
     const bool flipY = JsonHelper::Get<bool>(nodeComponentObjectJson, "flip_y");
-    const nlohmann::json& modulateJson = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "modulate");
+    const nlohmann::json& modulateJson = JsonHelper::GetJson(nodeComponentObjectJson, "modulate");
     const Color modulateColor = Color::NormalizedColor(
                                     JsonHelper::Get<int>(modulateJson, "red"),
                                     JsonHelper::Get<int>(modulateJson, "green"),
                                     JsonHelper::Get<int>(modulateJson, "blue"),
                                     JsonHelper::Get<int>(modulateJson, "alpha")
                                 );
-    const nlohmann::json& animationsJson = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "animations");
+    const nlohmann::json& animationsJson = JsonHelper::GetJson(nodeComponentObjectJson, "animations");
 
     // Setup Animations
     static AssetManager* assetManager = AssetManager::GetInstance();
@@ -178,12 +147,12 @@ void SceneNodeJsonParser::ParseAnimatedSpriteComponent(SceneNode& sceneNode, con
     for (const nlohmann::json& animationJson : animationsJson) {
         const std::string& nodeAnimationName = JsonHelper::Get<std::string>(animationJson, "name");
         const int nodeAnimationSpeed = JsonHelper::Get<int>(animationJson, "speed");
-        nlohmann::json nodeAnimationFramesJsonArray = JsonHelper::Get<nlohmann::json>(animationJson, "frames");
+        const nlohmann::json& nodeAnimationFramesJsonArray = JsonHelper::GetJson(animationJson, "frames");
         std::unordered_map<unsigned int, AnimationFrame> animationFrames;
-        for (nlohmann::json nodeAnimationFrameJson : nodeAnimationFramesJsonArray) {
+        for (const nlohmann::json& nodeAnimationFrameJson : nodeAnimationFramesJsonArray) {
             const int nodeAnimationFrameNumber = JsonHelper::Get<int>(nodeAnimationFrameJson, "frame");
             const std::string &nodeAnimationTexturePath = JsonHelper::Get<std::string>(nodeAnimationFrameJson, "texture_path");
-            nlohmann::json nodeAnimationFrameDrawSourceJson = JsonHelper::Get<nlohmann::json>(nodeAnimationFrameJson, "draw_source");
+            const nlohmann::json& nodeAnimationFrameDrawSourceJson = JsonHelper::GetJson(nodeAnimationFrameJson, "draw_source");
             const float nodeAnimationFrameDrawSourceX = JsonHelper::Get<float>(nodeAnimationFrameDrawSourceJson, "x");
             const float nodeAnimationFrameDrawSourceY = JsonHelper::Get<float>(nodeAnimationFrameDrawSourceJson, "y");
             const float nodeAnimationFrameDrawSourceWidth = JsonHelper::Get<float>(nodeAnimationFrameDrawSourceJson, "width");
@@ -206,7 +175,7 @@ void SceneNodeJsonParser::ParseAnimatedSpriteComponent(SceneNode& sceneNode, con
     }
 
     assert(nodeAnimations.count(currentAnimationName) > 0 && "Trying to set current animation to an animation that doesn't exist!");
-    componentManager->AddComponent(sceneNode.entity, AnimatedSpriteComponent{
+    componentManager->AddComponent(entity, AnimatedSpriteComponent{
         nodeAnimations,
         nodeAnimations[currentAnimationName],
         isPlaying,
@@ -215,23 +184,23 @@ void SceneNodeJsonParser::ParseAnimatedSpriteComponent(SceneNode& sceneNode, con
         modulateColor
     });
 
-    auto signature = entityManager->GetEnabledSignature(sceneNode.entity);
+    auto signature = entityManager->GetEnabledSignature(entity);
     signature.set(componentManager->GetComponentType<AnimatedSpriteComponent>(), true);
-    entityManager->SetSignature(sceneNode.entity, signature);
+    entityManager->SetSignature(entity, signature);
     bool isAnimatedSpriteComponentEnabled = JsonHelper::GetDefault<bool>(nodeComponentObjectJson, "enabled", true);
     if (isAnimatedSpriteComponentEnabled) {
-        entityManager->SetEnabledSignature(sceneNode.entity, signature);
+        entityManager->SetEnabledSignature(entity, signature);
     }
 }
 
-void SceneNodeJsonParser::ParseColliderComponent(SceneNode& sceneNode, const nlohmann::json& nodeComponentObjectJson) {
-    const nlohmann::json& rectangleJson = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "rectangle");
+void SceneNodeJsonParser::ParseColliderComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson) {
+    const nlohmann::json& rectangleJson = JsonHelper::GetJson(nodeComponentObjectJson, "rectangle");
     const float rectX = JsonHelper::Get<float>(rectangleJson, "x");
     const float rectY = JsonHelper::Get<float>(rectangleJson, "y");
     const float rectWidth = JsonHelper::Get<float>(rectangleJson, "width");
     const float rectHeight = JsonHelper::Get<float>(rectangleJson, "height");
     Rect2 colliderRect = Rect2(rectX, rectY, rectWidth, rectHeight);
-    const nlohmann::json& colorJson = JsonHelper::Get<nlohmann::json>(nodeComponentObjectJson, "color");
+    const nlohmann::json& colorJson = JsonHelper::GetJson(nodeComponentObjectJson, "color");
     const Color colliderColor = Color::NormalizedColor(
                                     JsonHelper::Get<int>(colorJson, "red"),
                                     JsonHelper::Get<int>(colorJson, "green"),
@@ -239,66 +208,296 @@ void SceneNodeJsonParser::ParseColliderComponent(SceneNode& sceneNode, const nlo
                                     JsonHelper::Get<int>(colorJson, "alpha")
                                 );
 
-    componentManager->AddComponent(sceneNode.entity, ColliderComponent{
+    componentManager->AddComponent(entity, ColliderComponent{
         colliderRect,
         colliderColor
     });
 
-    auto signature = entityManager->GetEnabledSignature(sceneNode.entity);
+    auto signature = entityManager->GetEnabledSignature(entity);
     signature.set(componentManager->GetComponentType<ColliderComponent>(), true);
-    entityManager->SetSignature(sceneNode.entity, signature);
+    entityManager->SetSignature(entity, signature);
     bool isColliderComponentEnabled = JsonHelper::GetDefault<bool>(nodeComponentObjectJson, "enabled", true);
     if (isColliderComponentEnabled) {
-        entityManager->SetEnabledSignature(sceneNode.entity, signature);
+        entityManager->SetEnabledSignature(entity, signature);
     }
 }
 
-SceneNode SceneNodeJsonParser::ParseSceneJson(Scene* scene, const nlohmann::json& nodeJson, bool isRoot, const SceneNode& parentSceneNode) {
-    SceneNode sceneNode;
-    if (parentSceneNode.entity != NULL_ENTITY) {
-        sceneNode = { entityManager->CreateEntity(), parentSceneNode.entity };
-    } else {
-        sceneNode = { entityManager->CreateEntity() };
+Entity SceneNodeJsonParser::ParseSceneJson(Scene* scene, const nlohmann::json& nodeJson, Entity parent) {
+    const Entity entity = ParseSceneNode(scene, nodeJson, parent);
+    const nlohmann::json& nodeChildrenJsonArray = JsonHelper::GetJson(nodeJson, "children");
+    for (const nlohmann::json& nodeChildJson : nodeChildrenJsonArray) {
+        ParseSceneJson(scene, nodeChildJson, entity);
     }
+    ParseExternalScene(scene, nodeJson, entity);
+    return entity;
+}
 
-    // Configure scene component
+void SceneNodeJsonParser::ParseExternalScene(Scene* scene, const nlohmann::json& nodeJson, Entity entity) {
+    const std::string& nodeExternalSceneSource = JsonHelper::Get<std::string>(nodeJson, "external_scene_source");
+    if (!nodeExternalSceneSource.empty()) {
+        sceneNodeBinaryParser.InstantiateScene(scene, entity, nodeExternalSceneSource);
+    }
+}
+
+Entity SceneNodeJsonParser::ParseSceneNode(Scene* scene, const nlohmann::json& nodeJson, Entity parent) {
+    const Entity entity = entityManager->CreateEntity();
+
+    // Configure scene component, unique name is resolved against siblings before the node joins the hierarchy
     const std::string &nodeName = JsonHelper::Get<std::string>(nodeJson, "name");
     const std::string &nodeType = JsonHelper::Get<std::string>(nodeJson, "type");
-    nlohmann::json nodeTagsJsonArray = JsonHelper::Get<nlohmann::json>(nodeJson, "tags");
-    const std::string &nodeExternalSceneSource = JsonHelper::Get<std::string>(nodeJson, "external_scene_source");
-    componentManager->AddComponent(sceneNode.entity, GenerateSceneComponent(nodeName, parentSceneNode, nodeTagsJsonArray));
-    auto signature = entityManager->GetEnabledSignature(sceneNode.entity);
+    const nlohmann::json& nodeTagsJsonArray = JsonHelper::GetJson(nodeJson, "tags");
+    componentManager->AddComponent(entity, GenerateSceneComponent(entity, nodeName, scene, parent, nodeTagsJsonArray));
+    auto signature = entityManager->GetEnabledSignature(entity);
     signature.set(componentManager->GetComponentType<SceneComponent>(), true);
-    entityManager->SetSignature(sceneNode.entity, signature);
-    entityManager->SetEnabledSignature(sceneNode.entity, signature);
-
-    // Rest of components
-    nlohmann::json nodeComponentJsonArray = JsonHelper::Get<nlohmann::json>(nodeJson, "components");
-    ParseComponentArray(sceneNode, nodeComponentJsonArray);
+    entityManager->SetSignature(entity, signature);
+    entityManager->SetEnabledSignature(entity, signature);
 
-    nlohmann::json nodeChildrenJsonArray = JsonHelper::Get<nlohmann::json>(nodeJson, "children");
-    for (nlohmann::json nodeChildJson : nodeChildrenJsonArray) {
-        SceneNode childNode = ParseSceneJson(scene, nodeChildJson, false, sceneNode);
-        sceneNode.children.emplace_back(childNode);
+    scene->hierarchy.AddNode(entity, parent);
+    if (parent == NULL_ENTITY) {
+        scene->rootEntity = entity;
     }
 
-    scene->sceneNodes.emplace(sceneNode.entity, sceneNode);
-    if (isRoot) {
-        scene->rootNode = sceneNode;
-    }
+    // Rest of components
+    const nlohmann::json& nodeComponentJsonArray = JsonHelper::GetJson(nodeJson, "components");
+    ParseComponentArray(entity, nodeComponentJsonArray);
 
-    return sceneNode;
+    return entity;
 }
 
 
-Scene* SceneLoader::LoadSceneFile(const std::string& filePath) {
-    Scene* loadedScene = new Scene();
+void SceneLoader::LoadSceneFile(Scene* scene, const std::string& filePath, EntityManager* entityManager, ComponentManager* componentManager) {
+    const std::string compiledFilePath = GetCompiledSceneFilePath(filePath);
+    if (!compiledFilePath.empty()) {
+        MappedFile compiledSceneFile(compiledFilePath);
+        SceneNodeBinaryParser sceneNodeBinaryParser(entityManager, componentManager);
+        if (compiledSceneFile.IsValid() && sceneNodeBinaryParser.Open(compiledSceneFile.GetData(), compiledSceneFile.GetSize())) {
+            sceneNodeBinaryParser.ParseScene(scene);
+            return;
+        }
+        if (BinarySceneFormat::IsCompiledFilePath(filePath)) {
+            Logger::GetInstance()->Error("Compiled scene '%s' is invalid!", compiledFilePath.c_str());
+            return;
+        }
+        Logger::GetInstance()->Warn("Compiled scene '%s' is invalid, loading json instead!", compiledFilePath.c_str());
+    }
     if (FileHelper::DoesFileExist(filePath)) {
-        nlohmann::json sceneJson = JsonFileHelper::LoadJsonFile(filePath);
-        static SceneNodeJsonParser sceneNodeJsonParser;
-        sceneNodeJsonParser.ParseSceneJson(loadedScene, sceneJson, true);
+        MappedFile sceneFile(filePath);
+        if (sceneFile.IsValid() && SceneNodeJsonParallelParser::ShouldParseInParallel(sceneFile.GetSize())) {
+            SceneNodeJsonParallelParser sceneNodeJsonParallelParser(entityManager, componentManager);
+            if (sceneNodeJsonParallelParser.Compile(sceneFile.GetData(), sceneFile.GetSize(), filePath)) {
+                sceneNodeJsonParallelParser.ParseScene(scene);
+                return;
+            }
+        }
+        // Streamed straight into components, never holds a document of the whole scene
+        SceneNodeJsonStreamParser sceneNodeJsonStreamParser(entityManager, componentManager);
+        if (!sceneFile.IsValid() || !sceneNodeJsonStreamParser.ParseScene(scene, sceneFile.GetData(), sceneFile.GetSize())) {
+            Logger::GetInstance()->Error("Failed to load scene file '%s'!", filePath.c_str());
+        }
     } else {
         Logger::GetInstance()->Error("Scene file '%s' not found!", filePath.c_str());
     }
+}
+
+std::string SceneLoader::GetCompiledSceneFilePath(const std::string& filePath) {
+    if (BinarySceneFormat::IsCompiledFilePath(filePath)) {
+        return FileHelper::DoesFileExist(filePath) ? filePath : std::string();
+    }
+    const std::string compiledFilePath = BinarySceneFormat::GetCompiledFilePath(filePath);
+    // A compiled scene older than its json is stale
+    if (!FileHelper::DoesFileExist(compiledFilePath)) {
+        return std::string();
+    }
+    const time_t compiledTime = FileHelper::GetLastModifiedTime(compiledFilePath);
+    if (compiledTime < FileHelper::GetLastModifiedTime(filePath)) {
+        return std::string();
+    }
+    // So is one older than any external scene it inlined, including ones that were missing when it was compiled
+    const MappedFile compiledFile(compiledFilePath);
+    std::vector<std::string> dependencyFilePaths;
+    if (!compiledFile.IsValid()
+            || !SceneNodeBinaryParser::GetDependencyFilePaths(compiledFile.GetData(), compiledFile.GetSize(), dependencyFilePaths)) {
+        return std::string();
+    }
+    for (const std::string& dependencyFilePath : dependencyFilePaths) {
+        if (FileHelper::DoesFileExist(dependencyFilePath) && compiledTime < FileHelper::GetLastModifiedTime(dependencyFilePath)) {
+            return std::string();
+        }
+    }
+    return compiledFilePath;
+}
+
+const size_t AsyncSceneLoader::NO_PARENT;
+
+AsyncSceneLoader::AsyncSceneLoader(EntityManager* entityManager, ComponentManager* componentManager) :
+    sceneNodeJsonParser(entityManager, componentManager),
+    sceneNodeBinaryParser(entityManager, componentManager),
+    sceneNodeJsonParallelParser(entityManager, componentManager),
+    hasFinishedParsing(false) {}
+
+AsyncSceneLoader::~AsyncSceneLoader() {
+    if (parseThread.joinable()) {
+        parseThread.join();
+    }
+    if (scene) {
+        delete scene;
+    }
+}
+
+void AsyncSceneLoader::Start(const std::string& filePath, Scene* scene) {
+    assert(state == SceneLoadState::IDLE && "Scene load already in progress!");
+    this->scene = scene;
+    if (parseThread.joinable()) {
+        parseThread.join();
+    }
+    state = SceneLoadState::PARSING;
+    hasFinishedParsing = false;
+    isParsedInParallel = false;
+    compiledFilePath = SceneLoader::GetCompiledSceneFilePath(filePath);
+    if (compiledFilePath.empty() && (!FileHelper::DoesFileExist(filePath) || BinarySceneFormat::IsCompiledFilePath(filePath))) {
+        Logger::GetInstance()->Error("Scene file '%s' not found!", filePath.c_str());
+        hasFinishedParsing = true;
+        return;
+    }
+    parseThread = std::thread(&AsyncSceneLoader::ParseAndStage, this, filePath);
+}
+
+// Runs on the parse thread, only touches the json document and staged nodes until 'hasFinishedParsing' is set
+void AsyncSceneLoader::ParseAndStage(const std::string& filePath) {
+    if (!compiledFilePath.empty()) {
+        if (OpenCompiledScene()) {
+            hasFinishedParsing = true;
+            return;
+        }
+        if (BinarySceneFormat::IsCompiledFilePath(filePath)) {
+            Logger::GetInstance()->Error("Compiled scene '%s' is invalid!", compiledFilePath.c_str());
+            hasFinishedParsing = true;
+            return;
+        }
+        Logger::GetInstance()->Warn("Compiled scene '%s' is invalid, loading json instead!", compiledFilePath.c_str());
+    }
+    {
+        MappedFile sceneFile(filePath);
+        if (sceneFile.IsValid() && SceneNodeJsonParallelParser::ShouldParseInParallel(sceneFile.GetSize())
+                && sceneNodeJsonParallelParser.Compile(sceneFile.GetData(), sceneFile.GetSize(), filePath)) {
+            isParsedInParallel = true;
+            hasFinishedParsing = true;
+            return;
+        }
+    }
+    sceneJson = JsonFileHelper::LoadJsonFile(filePath);
+    // Pre-order so parents and earlier siblings are committed first, same order as the recursive parser
+    std::vector<StagedSceneNode> nodeStack = { StagedSceneNode{ &sceneJson, NO_PARENT, false } };
+    while (!nodeStack.empty()) {
+        const StagedSceneNode stagedNode = nodeStack.back();
+        nodeStack.pop_back();
+        const size_t stagedIndex = stagedNodes.size();
+        stagedNodes.emplace_back(stagedNode);
+        if (stagedNode.isExternalScene) {
+            continue;
+        }
+        // External scene is instanced after the node's children, its template is compiled here so commits don't have to
+        const std::string& nodeExternalSceneSource = JsonHelper::Get<std::string>(*stagedNode.nodeJson, "external_scene_source");
+        if (!nodeExternalSceneSource.empty()) {
+            SceneTemplateCache::GetInstance()->GetTemplate(nodeExternalSceneSource);
+            nodeStack.emplace_back(StagedSceneNode{ stagedNode.nodeJson, stagedIndex, true });
+        }
+        assert(stagedNode.nodeJson->contains("children") && "Key doesn't exist in json!");
+        const nlohmann::json& nodeChildrenJsonArray = stagedNode.nodeJson->at("children");
+        for (auto it = nodeChildrenJsonArray.rbegin(); it != nodeChildrenJsonArray.rend(); ++it) {
+            nodeStack.emplace_back(StagedSceneNode{ &(*it), stagedIndex, false });
+        }
+    }
+    hasFinishedParsing = true;
+}
+
+// Compiled scenes are read in place, so staging is just mapping and validating the file
+bool AsyncSceneLoader::OpenCompiledScene() {
+    compiledSceneFile.reset(new MappedFile(compiledFilePath));
+    if (compiledSceneFile->IsValid() && sceneNodeBinaryParser.Open(compiledSceneFile->GetData(), compiledSceneFile->GetSize())) {
+        return true;
+    }
+    compiledSceneFile.reset();
+    return false;
+}
+
+size_t AsyncSceneLoader::GetNodeCount() const {
+    if (compiledSceneFile) {
+        return sceneNodeBinaryParser.GetNodeCount();
+    }
+    return isParsedInParallel ? sceneNodeJsonParallelParser.GetNodeCount() : stagedNodes.size();
+}
+
+void AsyncSceneLoader::ReleaseSceneData() {
+    sceneJson = nlohmann::json();
+    compiledSceneFile.reset();
+    sceneNodeJsonParallelParser.Clear();
+}
+
+bool AsyncSceneLoader::Commit(float timeBudgetMilliseconds) {
+    if (state == SceneLoadState::PARSING) {
+        if (!hasFinishedParsing) {
+            return false;
+        }
+        if (parseThread.joinable()) {
+            parseThread.join();
+        }
+        committedEntities.reserve(GetNodeCount());
+        state = SceneLoadState::COMMITTING;
+    }
+    if (state == SceneLoadState::COMMITTING) {
+        const auto startTime = std::chrono::steady_clock::now();
+        const size_t nodeCount = GetNodeCount();
+        while (committedEntities.size() < nodeCount) {
+            if (compiledSceneFile) {
+                committedEntities.emplace_back(sceneNodeBinaryParser.ParseSceneNode(scene, static_cast<uint32_t>(committedEntities.size())));
+            } else if (isParsedInParallel) {
+                committedEntities.emplace_back(sceneNodeJsonParallelParser.ParseNextNode(scene));
+            } else {
+                const StagedSceneNode& stagedNode = stagedNodes[committedEntities.size()];
+                const Entity parent = stagedNode.parentIndex == NO_PARENT ? NULL_ENTITY : committedEntities[stagedNode.parentIndex];
+                if (stagedNode.isExternalScene) {
+                    sceneNodeJsonParser.ParseExternalScene(scene, *stagedNode.nodeJson, parent);
+                    committedEntities.emplace_back(NULL_ENTITY);
+                } else {
+                    committedEntities.emplace_back(sceneNodeJsonParser.ParseSceneNode(scene, *stagedNode.nodeJson, parent));
+                }
+            }
+            const std::chrono::duration<float, std::milli> elapsedTime = std::chrono::steady_clock::now() - startTime;
+            if (timeBudgetMilliseconds > 0.0f && elapsedTime.count() >= timeBudgetMilliseconds) {
+                break;
+            }
+        }
+        if (committedEntities.size() < nodeCount) {
+            return false;
+        }
+        stagedNodes.clear();
+        committedEntities.clear();
+        // Freeing a large document takes as long as a few frames, so it's released on the parse thread too
+        parseThread = std::thread(&AsyncSceneLoader::ReleaseSceneData, this);
+        state = SceneLoadState::COMPLETE;
+    }
+    return state == SceneLoadState::COMPLETE;
+}
+
+Scene* AsyncSceneLoader::TakeScene() {
+    assert(state == SceneLoadState::COMPLETE && "Scene hasn't finished loading!");
+    Scene* loadedScene = scene;
+    scene = nullptr;
+    state = SceneLoadState::IDLE;
     return loadedScene;
 }
+
+SceneLoadState AsyncSceneLoader::GetState() const {
+    return state;
+}
+
+float AsyncSceneLoader::GetProgress() const {
+    if (state == SceneLoadState::COMPLETE) {
+        return 1.0f;
+    }
+    if (state != SceneLoadState::COMMITTING || GetNodeCount() == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(committedEntities.size()) / static_cast<float>(GetNodeCount());
+}
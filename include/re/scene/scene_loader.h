@@ -1,6 +1,13 @@
 #pragma once
 
+#include <thread>
+#include <atomic>
+#include <memory>
+
 #include "scene.h"
+#include "scene_node_binary_parser.h"
+#include "scene_json_stream_parser.h"
+#include "scene_json_parallel_parser.h"
 
 #include "../ecs/entity/entity_manager.h"
 #include "../ecs/component/component_manager.h"
@@ -13,33 +20,91 @@
 #include "../data/asset_manager.h"
 #include "../utils/file_helper.h"
 #include "../utils/json_helper.h"
+#include "../utils/mapped_file.h"
 
 class SceneNodeJsonParser {
   private:
     EntityManager *entityManager = nullptr;
     ComponentManager *componentManager = nullptr;
     AssetManager *assetManager = nullptr;
+    SceneNodeBinaryParser sceneNodeBinaryParser;
 
-    unsigned int GetEntityNameCount(const std::string& name, const SceneNode& parentSceneNode);
-    std::string GetUniqueSceneNodeName(const std::string& name, const SceneNode& parentSceneNode);
-    SceneComponent GenerateSceneComponent(const std::string& nodeName, const SceneNode& parentSceneNode, const nlohmann::json& nodeTagsJsonArray);
-    void ParseComponentArray(SceneNode &sceneNode, const nlohmann::json& nodeComponentJsonArray);
-    void ParseTransform2DComponent(SceneNode &sceneNode, const nlohmann::json& nodeComponentObjectJson);
-    void ParseSpriteComponent(SceneNode &sceneNode, const nlohmann::json& nodeComponentObjectJson);
-    void ParseTextLabelComponent(SceneNode& sceneNode, const nlohmann::json& nodeComponentObjectJson);
-    void ParseAnimatedSpriteComponent(SceneNode& sceneNode, const nlohmann::json& nodeComponentObjectJson);
-    void ParseColliderComponent(SceneNode& sceneNode, const nlohmann::json& nodeComponentObjectJson);
+    SceneComponent GenerateSceneComponent(Entity entity, const std::string& nodeName, Scene* scene, Entity parent, const nlohmann::json& nodeTagsJsonArray);
+    void ParseComponentArray(Entity entity, const nlohmann::json& nodeComponentJsonArray);
+    void ParseTransform2DComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson);
+    void ParseSpriteComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson);
+    void ParseTextLabelComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson);
+    void ParseAnimatedSpriteComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson);
+    void ParseColliderComponent(Entity entity, const nlohmann::json& nodeComponentObjectJson);
 
   public:
-    SceneNodeJsonParser() :
-        entityManager(EntityManager::GetInstance()),
-        componentManager(ComponentManager::GetInstance()),
-        assetManager(AssetManager::GetInstance()) {}
+    SceneNodeJsonParser(EntityManager* entityManager, ComponentManager* componentManager) :
+        entityManager(entityManager),
+        componentManager(componentManager),
+        assetManager(AssetManager::GetInstance()),
+        sceneNodeBinaryParser(entityManager, componentManager) {}
 
-    SceneNode ParseSceneJson(Scene* scene, const nlohmann::json& nodeJson, bool isRoot, const SceneNode& parentSceneNode = {});
+    // Parses 'nodeJson' and its children into 'scene', a NULL_ENTITY parent makes the node the scene root
+    Entity ParseSceneJson(Scene* scene, const nlohmann::json& nodeJson, Entity parent = NULL_ENTITY);
+    // Parses a single node without its children or external scene
+    Entity ParseSceneNode(Scene* scene, const nlohmann::json& nodeJson, Entity parent = NULL_ENTITY);
+    // Instances the node's 'external_scene_source' into 'entity', called once the node's own children are parsed
+    void ParseExternalScene(Scene* scene, const nlohmann::json& nodeJson, Entity entity);
 };
 
 class SceneLoader {
   public:
-    static Scene* LoadSceneFile(const std::string& filePath);
+    // Loads the compiled version of a json scene when it's up to date, the json otherwise.  'scene' has to be empty.
+    static void LoadSceneFile(Scene* scene, const std::string& filePath, EntityManager* entityManager, ComponentManager* componentManager);
+    // Returns the compiled file to load for 'filePath', empty if the json has to be parsed
+    static std::string GetCompiledSceneFilePath(const std::string& filePath);
+};
+
+enum class SceneLoadState : int {
+    IDLE = 0,
+    PARSING = 1, // Reading and parsing the file on the parse thread
+    COMMITTING = 2, // Creating entities on the calling thread
+    COMPLETE = 3,
+};
+
+// Parses a scene file on a background thread, then creates its entities through 'Commit' in time budgeted slices so
+// the caller can keep rendering while a scene loads.  Entities aren't registered with systems until the scene is taken.
+class AsyncSceneLoader {
+  public:
+    AsyncSceneLoader(EntityManager* entityManager, ComponentManager* componentManager);
+    ~AsyncSceneLoader();
+    // Nodes are created in 'scene', which has to be empty and is handed back by 'TakeScene'
+    void Start(const std::string& filePath, Scene* scene);
+    // Returns true once every node has been created, a budget of 0 commits everything staged
+    bool Commit(float timeBudgetMilliseconds);
+    Scene* TakeScene();
+    SceneLoadState GetState() const;
+    float GetProgress() const;
+
+  private:
+    struct StagedSceneNode {
+        const nlohmann::json* nodeJson = nullptr;
+        size_t parentIndex = 0;
+        bool isExternalScene = false; // Instances the external scene of the node at 'parentIndex'
+    };
+    static const size_t NO_PARENT = static_cast<size_t>(-1);
+
+    SceneNodeJsonParser sceneNodeJsonParser;
+    SceneNodeBinaryParser sceneNodeBinaryParser;
+    SceneNodeJsonParallelParser sceneNodeJsonParallelParser;
+    bool isParsedInParallel = false; // Large json scenes are compiled on worker threads instead of staged
+    SceneLoadState state = SceneLoadState::IDLE;
+    std::thread parseThread;
+    std::atomic<bool> hasFinishedParsing;
+    nlohmann::json sceneJson;
+    std::string compiledFilePath;
+    std::unique_ptr<MappedFile> compiledSceneFile; // Set when the compiled scene is used
+    std::vector<StagedSceneNode> stagedNodes;
+    std::vector<Entity> committedEntities;
+    Scene* scene = nullptr; // Owned until taken
+
+    void ParseAndStage(const std::string& filePath);
+    bool OpenCompiledScene();
+    size_t GetNodeCount() const;
+    void ReleaseSceneData();
 };
@@ -3,20 +3,85 @@
 #include <cassert>
 
 #include "scene_loader.h"
+#include "scene_template_cache.h"
 #include "../utils/file_helper.h"
 
-SceneManager::SceneManager(singleton) : logger(Logger::GetInstance()) {}
+SceneManager::SceneManager(EntityManager* entityManager, ComponentManager* componentManager) :
+    entityManager(entityManager),
+    componentManager(componentManager),
+    logger(Logger::GetInstance()),
+    asyncSceneLoader(entityManager, componentManager) {}
 
-void SceneManager::ChangeToEmptyScene() {
-    if (currentScene) {
-        delete currentScene;
+SceneManager::SceneManager(singleton) : SceneManager(EntityManager::GetInstance(), ComponentManager::GetInstance()) {}
+
+SceneManager::~SceneManager() {
+    delete currentScene;
+    for (Scene* freeScene : freeScenes) {
+        delete freeScene;
     }
-    currentScene = new Scene{};
+}
+
+void SceneManager::ChangeToEmptyScene() {
+    DestroyCurrentScene();
+    currentScene = AcquireScene();
 }
 
 void SceneManager::ChangeToScene(const std::string& filePath) {
-    currentScene = SceneLoader::LoadSceneFile(filePath);
-    assert(currentScene->rootNode.entity != NULL_ENTITY && "Scene root node is NULL!");
+    DestroyCurrentScene();
+    currentScene = AcquireScene();
+    SceneLoader::LoadSceneFile(currentScene, filePath, entityManager, componentManager);
+    assert(currentScene->rootEntity != NULL_ENTITY && "Scene root node is NULL!");
+}
+
+void SceneManager::StartSceneLoad(const std::string& filePath) {
+    if (IsLoadingScene()) {
+        logger->Warn("Attempting to load scene '%s' while another scene is loading!", filePath.c_str());
+        return;
+    }
+    // The loaded scene gets templates compiled from the external scenes as they are now
+    SceneTemplateCache::GetInstance()->Clear();
+    asyncSceneLoader.Start(filePath, AcquireScene());
+}
+
+bool SceneManager::CommitSceneLoad(float timeBudgetMilliseconds) {
+    return asyncSceneLoader.Commit(timeBudgetMilliseconds);
+}
+
+void SceneManager::ChangeToLoadedScene() {
+    DestroyCurrentScene();
+    currentScene = asyncSceneLoader.TakeScene();
+    assert(currentScene->rootEntity != NULL_ENTITY && "Scene root node is NULL!");
+}
+
+void SceneManager::DestroyCurrentScene() {
+    if (!currentScene) {
+        return;
+    }
+    // Templates compiled by a finished background load belong to the next scene
+    if (!IsLoadingScene()) {
+        SceneTemplateCache::GetInstance()->Clear();
+    }
+    currentScene->Clear();
+    freeScenes.emplace_back(currentScene);
+    currentScene = nullptr;
+}
+
+// At most the current scene and one being loaded exist at once, so after the first scene change no scene is allocated
+Scene* SceneManager::AcquireScene() {
+    if (freeScenes.empty()) {
+        return new Scene{};
+    }
+    Scene* scene = freeScenes.back();
+    freeScenes.pop_back();
+    return scene;
+}
+
+bool SceneManager::IsLoadingScene() const {
+    return asyncSceneLoader.GetState() != SceneLoadState::IDLE;
+}
+
+float SceneManager::GetSceneLoadProgress() const {
+    return asyncSceneLoader.GetProgress();
 }
 
 void SceneManager::AddRootNode(Entity rootEntity) {
@@ -25,7 +90,9 @@ void SceneManager::AddRootNode(Entity rootEntity) {
         logger->Warn("Attempting to add as root node Entity '%d' which is already in the scene!", rootEntity);
         return;
     }
-    currentScene->sceneNodes.emplace(rootEntity, SceneNode{ rootEntity });
+    currentScene->hierarchy.AddNode(rootEntity);
+    currentScene->worldTransforms.MarkDirty(rootEntity, currentScene->hierarchy);
+    IndexNodeName(rootEntity, NULL_ENTITY);
 }
 
 void SceneManager::AddChildNode(Entity child, Entity parent) {
@@ -35,10 +102,9 @@ void SceneManager::AddChildNode(Entity child, Entity parent) {
         logger->Warn("Attempting to add child entity '%d' which is already in the scene!  Passing in parent = %d", child, parent);
         return;
     }
-    SceneNode parentSceneNode = currentScene->sceneNodes[parent];
-    SceneNode childSceneNode = SceneNode{ child, currentScene->sceneNodes[parent].entity };
-    currentScene->sceneNodes[parent].children.emplace_back(childSceneNode);
-    currentScene->sceneNodes.emplace(child, childSceneNode);
+    currentScene->hierarchy.AddNode(child, parent);
+    currentScene->worldTransforms.MarkDirty(child, currentScene->hierarchy);
+    IndexNodeName(child, parent);
 }
 
 void SceneManager::DeleteNode(Entity entity) {
@@ -47,12 +113,56 @@ void SceneManager::DeleteNode(Entity entity) {
         logger->Warn("Attempted to delete entity '%d' which is not in the scene!", entity);
         return;
     }
-    currentScene->sceneNodes.erase(entity);
+    // Children are promoted to root level so their world transforms change too, and their names may clash there
+    currentScene->hierarchy.ForEachChild(entity, [this](Entity child) {
+        currentScene->worldTransforms.MarkDirty(child, currentScene->hierarchy);
+        if (currentScene->nodeIndex.HasNode(child)) {
+            const std::string name = currentScene->nodeIndex.MoveNode(child, NULL_ENTITY);
+            if (componentManager->HasComponent<SceneComponent>(child)) {
+                componentManager->GetComponent<SceneComponent>(child).name = name;
+            }
+        }
+    });
+    currentScene->hierarchy.RemoveNode(entity);
+    currentScene->nodeIndex.RemoveNode(entity);
+    currentScene->worldTransforms.MarkDirty(entity, currentScene->hierarchy);
+}
+
+void SceneManager::DeleteSubtree(Entity entity, std::vector<Entity>& deletedEntities) {
+    assert(currentScene != nullptr && "Current scene is NULL!");
+    if (!IsNodeInScene(entity)) {
+        logger->Warn("Attempted to delete subtree of entity '%d' which is not in the scene!", entity);
+        deletedEntities.emplace_back(entity);
+        return;
+    }
+    const size_t firstDeletedIndex = deletedEntities.size();
+    currentScene->hierarchy.RemoveSubtree(entity, deletedEntities);
+    currentScene->nodeIndex.RemoveSubtree(deletedEntities, firstDeletedIndex);
+    for (size_t i = firstDeletedIndex; i < deletedEntities.size(); i++) {
+        currentScene->worldTransforms.MarkDirty(deletedEntities[i], currentScene->hierarchy);
+    }
 }
 
 bool SceneManager::IsNodeInScene(Entity entity) const {
     assert(currentScene != nullptr && "Current scene is NULL!");
-    return currentScene->sceneNodes.count(entity) > 0;
+    return currentScene->hierarchy.HasNode(entity);
+}
+
+Entity SceneManager::GetNode(const std::string& nodePath) const {
+    assert(currentScene != nullptr && "Current scene is NULL!");
+    return currentScene->nodeIndex.GetNode(nodePath);
+}
+
+bool SceneManager::HasCurrentScene() const {
+    return currentScene != nullptr;
+}
+
+void SceneManager::IndexNodeName(Entity entity, Entity parent) {
+    if (!componentManager->HasComponent<SceneComponent>(entity)) {
+        return;
+    }
+    SceneComponent& sceneComponent = componentManager->GetComponent<SceneComponent>(entity);
+    sceneComponent.name = currentScene->nodeIndex.AddNode(entity, parent, sceneComponent.name);
 }
 
 Scene* SceneManager::GetCurrentScene() {
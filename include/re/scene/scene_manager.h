@@ -7,20 +7,44 @@
 
 #include "scene_loader.h"
 #include "../ecs/entity/entity.h"
+#include "../ecs/entity/entity_manager.h"
+#include "../ecs/component/component_manager.h"
 #include "../utils/logger.h"
 
 class SceneManager : public Singleton<SceneManager>{
   public:
+    SceneManager(EntityManager* entityManager, ComponentManager* componentManager);
     SceneManager(singleton);
+    ~SceneManager();
     void ChangeToEmptyScene();
     void ChangeToScene(const std::string& filePath);
+    // Background loading, entities are committed through 'CommitSceneLoad' and the scene becomes current once complete
+    void StartSceneLoad(const std::string& filePath);
+    bool CommitSceneLoad(float timeBudgetMilliseconds);
+    void ChangeToLoadedScene();
+    // Clears the current scene's hierarchy and caches for reuse, its entities are released by the caller
+    void DestroyCurrentScene();
+    bool IsLoadingScene() const;
+    float GetSceneLoadProgress() const;
     void AddRootNode(Entity rootEntity);
     void AddChildNode(Entity child, Entity parent);
     void DeleteNode(Entity entity);
+    // Deletes 'entity' with all of its descendants, appending them to 'deletedEntities' in pre-order
+    void DeleteSubtree(Entity entity, std::vector<Entity>& deletedEntities);
     bool IsNodeInScene(Entity entity) const;
+    // Path of node names separated by '/' starting from the root node, returns NULL_ENTITY if there's no such node
+    Entity GetNode(const std::string& nodePath) const;
+    bool HasCurrentScene() const;
 
     Scene* GetCurrentScene();
 private:
     Scene *currentScene = nullptr;
+    EntityManager *entityManager = nullptr;
+    ComponentManager *componentManager = nullptr;
     Logger *logger = nullptr;
+    AsyncSceneLoader asyncSceneLoader;
+    std::vector<Scene*> freeScenes; // Cleared scenes kept for reuse
+
+    Scene* AcquireScene();
+    void IndexNodeName(Entity entity, Entity parent);
 };
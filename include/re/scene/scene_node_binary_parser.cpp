@@ -0,0 +1,555 @@
+#include "scene_node_binary_parser.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "scene_template_cache.h"
+#include "../ecs/component/components/scene_component.h"
+#include "../ecs/component/components/transform2d_component.h"
+#include "../ecs/component/components/text_label_component.h"
+#include "../ecs/component/components/sprite_component.h"
+#include "../ecs/component/components/animated_sprite_component.h"
+#include "../ecs/component/components/collider_component.h"
+
+template<typename T>
+static T ReadRecord(const char* data) {
+    T record;
+    std::memcpy(&record, data, sizeof(T));
+    return record;
+}
+
+static bool IsSectionValid(uint32_t offset, size_t sectionSize, size_t fileSize) {
+    return offset <= fileSize && sectionSize <= fileSize - offset && offset % 4 == 0;
+}
+
+// Checks the header and that every section lies within the file, returns nullptr if it isn't a compiled scene
+static const BinarySceneFormat::Header* GetValidHeader(const char* data, size_t size) {
+    using namespace BinarySceneFormat;
+    if (size < sizeof(Header) || reinterpret_cast<uintptr_t>(data) % 4 != 0) {
+        return nullptr;
+    }
+    const Header* fileHeader = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(fileHeader->magic, MAGIC, sizeof(MAGIC)) != 0 || fileHeader->version != VERSION || fileHeader->fileSize != size) {
+        return nullptr;
+    }
+    if (fileHeader->nodeCount == 0
+            || !IsSectionValid(fileHeader->stringOffsetsOffset, (static_cast<size_t>(fileHeader->stringCount) + 1) * sizeof(uint32_t), size)
+            || !IsSectionValid(fileHeader->nodesOffset, static_cast<size_t>(fileHeader->nodeCount) * sizeof(Node), size)
+            || !IsSectionValid(fileHeader->dependenciesOffset, static_cast<size_t>(fileHeader->dependencyCount) * sizeof(uint32_t), size)
+            || !IsSectionValid(fileHeader->tagsOffset, 0, size)
+            || !IsSectionValid(fileHeader->componentsOffset, 0, size)
+            || fileHeader->stringDataOffset > fileHeader->nodesOffset
+            || fileHeader->tagsOffset > fileHeader->componentsOffset) {
+        return nullptr;
+    }
+    return fileHeader;
+}
+
+static bool IsStringValid(const BinarySceneFormat::Header* fileHeader, const char* data, uint32_t stringIndex) {
+    if (stringIndex >= fileHeader->stringCount) {
+        return false;
+    }
+    const uint32_t* stringOffsets = reinterpret_cast<const uint32_t*>(data + fileHeader->stringOffsetsOffset);
+    const char* stringData = data + fileHeader->stringDataOffset;
+    const uint32_t stringEnd = stringOffsets[stringIndex + 1];
+    return stringOffsets[stringIndex] < stringEnd && stringEnd <= fileHeader->nodesOffset - fileHeader->stringDataOffset
+           && stringData[stringEnd - 1] == '\0';
+}
+
+bool SceneNodeBinaryParser::GetDependencyFilePaths(const char* data, size_t size, std::vector<std::string>& dependencyFilePaths) {
+    const BinarySceneFormat::Header* fileHeader = GetValidHeader(data, size);
+    if (!fileHeader) {
+        return false;
+    }
+    const uint32_t* stringOffsets = reinterpret_cast<const uint32_t*>(data + fileHeader->stringOffsetsOffset);
+    const uint32_t* dependencies = reinterpret_cast<const uint32_t*>(data + fileHeader->dependenciesOffset);
+    for (uint32_t dependencyIndex = 0; dependencyIndex < fileHeader->dependencyCount; dependencyIndex++) {
+        const uint32_t stringIndex = dependencies[dependencyIndex];
+        if (!IsStringValid(fileHeader, data, stringIndex)) {
+            return false;
+        }
+        dependencyFilePaths.emplace_back(data + fileHeader->stringDataOffset + stringOffsets[stringIndex]);
+    }
+    return true;
+}
+
+bool SceneNodeBinaryParser::Open(const char* data, size_t size) {
+    using namespace BinarySceneFormat;
+    header = nullptr;
+    nodeEntities.clear();
+    textures.clear();
+    fonts.clear();
+    const Header* fileHeader = GetValidHeader(data, size);
+    if (!fileHeader) {
+        return false;
+    }
+    stringOffsets = reinterpret_cast<const uint32_t*>(data + fileHeader->stringOffsetsOffset);
+    stringData = data + fileHeader->stringDataOffset;
+    nodes = reinterpret_cast<const Node*>(data + fileHeader->nodesOffset);
+    tags = reinterpret_cast<const uint32_t*>(data + fileHeader->tagsOffset);
+    componentData = data + fileHeader->componentsOffset;
+
+    // Validate everything up front so parsing nodes never has to check bounds
+    for (uint32_t stringIndex = 0; stringIndex < fileHeader->stringCount; stringIndex++) {
+        if (!IsStringValid(fileHeader, data, stringIndex)) {
+            return false;
+        }
+    }
+    const size_t tagCount = (fileHeader->componentsOffset - fileHeader->tagsOffset) / sizeof(uint32_t);
+    const size_t componentDataSize = size - fileHeader->componentsOffset;
+    for (uint32_t nodeIndex = 0; nodeIndex < fileHeader->nodeCount; nodeIndex++) {
+        const Node& node = nodes[nodeIndex];
+        const bool isParentValid = nodeIndex == 0 ? node.parentIndex == NO_PARENT : node.parentIndex < nodeIndex;
+        if (!isParentValid || node.firstTag > tagCount || node.tagCount > tagCount - node.firstTag
+                || !AreComponentRecordsValid(node, componentDataSize)) {
+            return false;
+        }
+    }
+    header = fileHeader;
+    nodeEntities.reserve(header->nodeCount);
+    return true;
+}
+
+bool SceneNodeBinaryParser::AreComponentRecordsValid(const BinarySceneFormat::Node& node, size_t componentDataSize) const {
+    using namespace BinarySceneFormat;
+    size_t recordOffset = node.componentsOffset;
+    for (uint32_t componentIndex = 0; componentIndex < node.componentCount; componentIndex++) {
+        if (recordOffset > componentDataSize || componentDataSize - recordOffset < sizeof(ComponentRecordHeader)) {
+            return false;
+        }
+        const ComponentRecordHeader recordHeader = ReadRecord<ComponentRecordHeader>(componentData + recordOffset);
+        recordOffset += sizeof(ComponentRecordHeader);
+        if (recordHeader.size > componentDataSize - recordOffset) {
+            return false;
+        }
+        size_t expectedSize = 0;
+        switch (static_cast<ComponentRecordType>(recordHeader.type)) {
+        case ComponentRecordType::TRANSFORM_2D:
+            expectedSize = sizeof(Transform2DRecord);
+            break;
+        case ComponentRecordType::SPRITE:
+            expectedSize = sizeof(SpriteRecord);
+            break;
+        case ComponentRecordType::TEXT_LABEL:
+            expectedSize = sizeof(TextLabelRecord);
+            break;
+        case ComponentRecordType::ANIMATED_SPRITE: {
+            if (recordHeader.size < sizeof(AnimatedSpriteRecord)) {
+                return false;
+            }
+            const char* payload = componentData + recordOffset;
+            const AnimatedSpriteRecord animatedSpriteRecord = ReadRecord<AnimatedSpriteRecord>(payload);
+            expectedSize = sizeof(AnimatedSpriteRecord);
+            for (uint32_t animationIndex = 0; animationIndex < animatedSpriteRecord.animationCount; animationIndex++) {
+                if (recordHeader.size - expectedSize < sizeof(AnimationRecord)) {
+                    return false;
+                }
+                const AnimationRecord animationRecord = ReadRecord<AnimationRecord>(payload + expectedSize);
+                expectedSize += sizeof(AnimationRecord);
+                if ((recordHeader.size - expectedSize) / sizeof(AnimationFrameRecord) < animationRecord.frameCount) {
+                    return false;
+                }
+                expectedSize += animationRecord.frameCount * sizeof(AnimationFrameRecord);
+            }
+            break;
+        }
+        case ComponentRecordType::COLLIDER:
+            expectedSize = sizeof(ColliderRecord);
+            break;
+        default:
+            return false;
+        }
+        if (recordHeader.size != expectedSize) {
+            return false;
+        }
+        recordOffset = (recordOffset + recordHeader.size + 3) & ~static_cast<size_t>(3);
+    }
+    return true;
+}
+
+uint32_t SceneNodeBinaryParser::GetNodeCount() const {
+    return header ? header->nodeCount : 0;
+}
+
+std::string SceneNodeBinaryParser::GetString(uint32_t stringIndex) const {
+    if (stringIndex >= header->stringCount) {
+        return std::string();
+    }
+    return std::string(stringData + stringOffsets[stringIndex], stringOffsets[stringIndex + 1] - stringOffsets[stringIndex] - 1);
+}
+
+Texture* SceneNodeBinaryParser::GetTexture(uint32_t stringIndex) {
+    if (stringIndex == BinarySceneFormat::NO_STRING) {
+        return nullptr;
+    }
+    auto it = textures.find(stringIndex);
+    if (it == textures.end()) {
+        it = textures.emplace(stringIndex, assetManager->GetTexture(GetString(stringIndex))).first;
+    }
+    return it->second;
+}
+
+Font* SceneNodeBinaryParser::GetFont(uint32_t stringIndex) {
+    if (stringIndex == BinarySceneFormat::NO_STRING) {
+        return nullptr;
+    }
+    auto it = fonts.find(stringIndex);
+    if (it == fonts.end()) {
+        it = fonts.emplace(stringIndex, assetManager->GetFont(GetString(stringIndex))).first;
+    }
+    return it->second;
+}
+
+template<typename T>
+void SceneNodeBinaryParser::AddComponentSignature(Entity entity, bool isEnabled) {
+    auto signature = entityManager->GetEnabledSignature(entity);
+    signature.set(componentManager->GetComponentType<T>(), true);
+    entityManager->SetSignature(entity, signature);
+    if (isEnabled) {
+        entityManager->SetEnabledSignature(entity, signature);
+    }
+}
+
+void SceneNodeBinaryParser::ParseComponentRecord(Entity entity, const BinarySceneFormat::ComponentRecordHeader& recordHeader, const char* payload) {
+    using namespace BinarySceneFormat;
+    const bool isEnabled = recordHeader.isEnabled != 0;
+    switch (static_cast<ComponentRecordType>(recordHeader.type)) {
+    case ComponentRecordType::TRANSFORM_2D: {
+        const Transform2DRecord record = ReadRecord<Transform2DRecord>(payload);
+        componentManager->AddComponent(entity, Transform2DComponent{
+            .position = Vector2(record.position[0], record.position[1]),
+            .scale = Vector2(record.scale[0], record.scale[1]),
+            .rotation = record.rotation,
+            .zIndex = record.zIndex,
+            .isZIndexRelativeToParent = record.isZIndexRelativeToParent != 0,
+            .ignoreCamera = record.ignoreCamera != 0
+        });
+        AddComponentSignature<Transform2DComponent>(entity, isEnabled);
+        break;
+    }
+    case ComponentRecordType::SPRITE: {
+        const SpriteRecord record = ReadRecord<SpriteRecord>(payload);
+        componentManager->AddComponent(entity, SpriteComponent{
+            .texture = GetTexture(record.texturePath),
+            .drawSource = Rect2(record.drawSource[0], record.drawSource[1], record.drawSource[2], record.drawSource[3]),
+            .flipX = record.flipX != 0,
+            .flipY = record.flipY != 0,
+            .modulate = Color(record.modulate[0], record.modulate[1], record.modulate[2], record.modulate[3])
+        });
+        AddComponentSignature<SpriteComponent>(entity, isEnabled);
+        break;
+    }
+    case ComponentRecordType::TEXT_LABEL: {
+        const TextLabelRecord record = ReadRecord<TextLabelRecord>(payload);
+        componentManager->AddComponent(entity, TextLabelComponent{
+            .text = GetString(record.text),
+            .font = GetFont(record.fontUID),
+            .color = Color(record.color[0], record.color[1], record.color[2], record.color[3])
+        });
+        AddComponentSignature<TextLabelComponent>(entity, isEnabled);
+        break;
+    }
+    case ComponentRecordType::ANIMATED_SPRITE:
+        ParseAnimatedSpriteRecord(entity, payload);
+        AddComponentSignature<AnimatedSpriteComponent>(entity, isEnabled);
+        break;
+    case ComponentRecordType::COLLIDER: {
+        const ColliderRecord record = ReadRecord<ColliderRecord>(payload);
+        componentManager->AddComponent(entity, ColliderComponent{
+            Rect2(record.rectangle[0], record.rectangle[1], record.rectangle[2], record.rectangle[3]),
+            Color(record.color[0], record.color[1], record.color[2], record.color[3])
+        });
+        AddComponentSignature<ColliderComponent>(entity, isEnabled);
+        break;
+    }
+    }
+}
+
+void SceneNodeBinaryParser::ParseAnimatedSpriteRecord(Entity entity, const char* payload) {
+    using namespace BinarySceneFormat;
+    const AnimatedSpriteRecord record = ReadRecord<AnimatedSpriteRecord>(payload);
+    payload += sizeof(AnimatedSpriteRecord);
+    std::unordered_map<std::string, Animation> nodeAnimations = {};
+    for (uint32_t animationIndex = 0; animationIndex < record.animationCount; animationIndex++) {
+        const AnimationRecord animationRecord = ReadRecord<AnimationRecord>(payload);
+        payload += sizeof(AnimationRecord);
+        std::unordered_map<unsigned int, AnimationFrame> animationFrames;
+        for (uint32_t frameIndex = 0; frameIndex < animationRecord.frameCount; frameIndex++) {
+            const AnimationFrameRecord frameRecord = ReadRecord<AnimationFrameRecord>(payload);
+            payload += sizeof(AnimationFrameRecord);
+            AnimationFrame animationFrame = {
+                .texture = GetTexture(frameRecord.texturePath),
+                .drawSource = Rect2(frameRecord.drawSource[0], frameRecord.drawSource[1], frameRecord.drawSource[2], frameRecord.drawSource[3]),
+                .frame = frameRecord.frame
+            };
+            animationFrames.emplace(animationFrame.frame, animationFrame);
+        }
+        Animation animation = {
+            .name = GetString(animationRecord.name),
+            .speed = animationRecord.speed,
+            .animationFrames = animationFrames,
+            .frames = static_cast<unsigned int>(animationFrames.size())
+        };
+        nodeAnimations.emplace(animation.name, animation);
+    }
+
+    const std::string currentAnimationName = GetString(record.currentAnimation);
+    assert(nodeAnimations.count(currentAnimationName) > 0 && "Trying to set current animation to an animation that doesn't exist!");
+    componentManager->AddComponent(entity, AnimatedSpriteComponent{
+        nodeAnimations,
+        nodeAnimations[currentAnimationName],
+        record.isPlaying != 0,
+        record.flipX != 0,
+        record.flipY != 0,
+        Color(record.modulate[0], record.modulate[1], record.modulate[2], record.modulate[3])
+    });
+}
+
+Entity SceneNodeBinaryParser::ParseSceneNode(Scene* scene, uint32_t nodeIndex, Entity rootParent) {
+    assert(header && "Compiled scene hasn't been opened!");
+    assert(nodeIndex == nodeEntities.size() && "Compiled scene nodes have to be parsed in order!");
+    const BinarySceneFormat::Node& node = nodes[nodeIndex];
+    const Entity parent = node.parentIndex == BinarySceneFormat::NO_PARENT ? rootParent : nodeEntities[node.parentIndex];
+    const Entity entity = AddSceneNode(scene, nodeIndex, parent);
+    nodeEntities.emplace_back(entity);
+    return entity;
+}
+
+void SceneNodeBinaryParser::AttachRootNode(Entity entity) {
+    assert(header && nodeEntities.empty() && "Root node has to be attached before any node is parsed!");
+    nodeEntities.emplace_back(entity);
+}
+
+Entity SceneNodeBinaryParser::AddSceneNode(Scene* scene, uint32_t nodeIndex, Entity parent) {
+    assert(header && nodeIndex < header->nodeCount && "Invalid compiled scene node!");
+    const BinarySceneFormat::Node& node = nodes[nodeIndex];
+    const Entity entity = entityManager->CreateEntity();
+
+    // Compiled names are already unique and keep their name in the index, instanced children may get a number
+    const std::string nodeName = scene->nodeIndex.AddNode(entity, parent, GetString(node.name));
+    componentManager->AddComponent(entity, SceneComponent{ nodeName, GetNodeTags(nodeIndex) });
+    auto signature = entityManager->GetEnabledSignature(entity);
+    signature.set(componentManager->GetComponentType<SceneComponent>(), true);
+    entityManager->SetSignature(entity, signature);
+    entityManager->SetEnabledSignature(entity, signature);
+
+    scene->hierarchy.AddNode(entity, parent);
+    if (parent == NULL_ENTITY) {
+        scene->rootEntity = entity;
+    }
+
+    ParseComponentRecords(entity, node, false);
+    return entity;
+}
+
+void SceneNodeBinaryParser::ParseComponentRecords(Entity entity, const BinarySceneFormat::Node& node, bool skipExistingComponents) {
+    size_t recordOffset = node.componentsOffset;
+    for (uint32_t componentIndex = 0; componentIndex < node.componentCount; componentIndex++) {
+        const BinarySceneFormat::ComponentRecordHeader recordHeader = ReadRecord<BinarySceneFormat::ComponentRecordHeader>(componentData + recordOffset);
+        recordOffset += sizeof(BinarySceneFormat::ComponentRecordHeader);
+        if (!skipExistingComponents || !HasComponentForRecord(entity, recordHeader)) {
+            ParseComponentRecord(entity, recordHeader, componentData + recordOffset);
+        }
+        recordOffset = (recordOffset + recordHeader.size + 3) & ~static_cast<size_t>(3);
+    }
+}
+
+bool SceneNodeBinaryParser::HasComponentForRecord(Entity entity, const BinarySceneFormat::ComponentRecordHeader& recordHeader) {
+    using namespace BinarySceneFormat;
+    switch (static_cast<ComponentRecordType>(recordHeader.type)) {
+    case ComponentRecordType::TRANSFORM_2D:
+        return componentManager->HasComponent<Transform2DComponent>(entity);
+    case ComponentRecordType::SPRITE:
+        return componentManager->HasComponent<SpriteComponent>(entity);
+    case ComponentRecordType::TEXT_LABEL:
+        return componentManager->HasComponent<TextLabelComponent>(entity);
+    case ComponentRecordType::ANIMATED_SPRITE:
+        return componentManager->HasComponent<AnimatedSpriteComponent>(entity);
+    case ComponentRecordType::COLLIDER:
+        return componentManager->HasComponent<ColliderComponent>(entity);
+    }
+    return false;
+}
+
+template<typename T>
+void SceneNodeBinaryParser::RemoveComponentIfPresent(Entity entity) {
+    if (!componentManager->HasComponent<T>(entity)) {
+        return;
+    }
+    componentManager->RemoveComponent<T>(entity);
+    const ComponentType componentType = componentManager->GetComponentType<T>();
+    auto signature = entityManager->GetSignature(entity);
+    signature.set(componentType, false);
+    entityManager->SetSignature(entity, signature);
+    auto enabledSignature = entityManager->GetEnabledSignature(entity);
+    enabledSignature.set(componentType, false);
+    entityManager->SetEnabledSignature(entity, enabledSignature);
+}
+
+std::string SceneNodeBinaryParser::GetNodeName(uint32_t nodeIndex) const {
+    return GetString(nodes[nodeIndex].name);
+}
+
+uint32_t SceneNodeBinaryParser::GetNodeParentIndex(uint32_t nodeIndex) const {
+    return nodes[nodeIndex].parentIndex;
+}
+
+std::vector<std::string> SceneNodeBinaryParser::GetNodeTags(uint32_t nodeIndex) const {
+    const BinarySceneFormat::Node& node = nodes[nodeIndex];
+    std::vector<std::string> nodeTags;
+    nodeTags.reserve(node.tagCount);
+    for (uint32_t tagIndex = node.firstTag; tagIndex < node.firstTag + node.tagCount; tagIndex++) {
+        nodeTags.emplace_back(GetString(tags[tagIndex]));
+    }
+    return nodeTags;
+}
+
+size_t SceneNodeBinaryParser::GetComponentRecordsSize(const BinarySceneFormat::Node& node) const {
+    size_t recordOffset = node.componentsOffset;
+    for (uint32_t componentIndex = 0; componentIndex < node.componentCount; componentIndex++) {
+        const BinarySceneFormat::ComponentRecordHeader recordHeader = ReadRecord<BinarySceneFormat::ComponentRecordHeader>(componentData + recordOffset);
+        recordOffset = (recordOffset + sizeof(BinarySceneFormat::ComponentRecordHeader) + recordHeader.size + 3) & ~static_cast<size_t>(3);
+    }
+    return recordOffset - node.componentsOffset;
+}
+
+bool SceneNodeBinaryParser::HasSameStrings(const SceneNodeBinaryParser& other) const {
+    const size_t stringDataSize = header->nodesOffset - header->stringDataOffset;
+    return header->stringCount == other.header->stringCount
+           && stringDataSize == other.header->nodesOffset - other.header->stringDataOffset
+           && std::memcmp(stringData, other.stringData, stringDataSize) == 0;
+}
+
+bool SceneNodeBinaryParser::IsNodeDataSame(uint32_t nodeIndex, const SceneNodeBinaryParser& other, uint32_t otherNodeIndex) const {
+    const BinarySceneFormat::Node& node = nodes[nodeIndex];
+    const BinarySceneFormat::Node& otherNode = other.nodes[otherNodeIndex];
+    if (node.tagCount != otherNode.tagCount || node.componentCount != otherNode.componentCount
+            || std::memcmp(tags + node.firstTag, other.tags + otherNode.firstTag, node.tagCount * sizeof(uint32_t)) != 0) {
+        return false;
+    }
+    const size_t componentRecordsSize = GetComponentRecordsSize(node);
+    return componentRecordsSize == other.GetComponentRecordsSize(otherNode)
+           && std::memcmp(componentData + node.componentsOffset, other.componentData + otherNode.componentsOffset, componentRecordsSize) == 0;
+}
+
+// Record bytes with every string index cleared and the strings appended instead
+std::string SceneNodeBinaryParser::GetComponentRecordKey(const BinarySceneFormat::ComponentRecordHeader& recordHeader, const char* payload) const {
+    using namespace BinarySceneFormat;
+    std::string key(reinterpret_cast<const char*>(&recordHeader), sizeof(ComponentRecordHeader));
+    const auto appendString = [this, &key](uint32_t& stringIndex) {
+        key += stringIndex == NO_STRING ? std::string() : GetString(stringIndex);
+        key += '\0';
+        stringIndex = 0;
+    };
+    switch (static_cast<ComponentRecordType>(recordHeader.type)) {
+    case ComponentRecordType::SPRITE: {
+        SpriteRecord record = ReadRecord<SpriteRecord>(payload);
+        appendString(record.texturePath);
+        key.append(reinterpret_cast<const char*>(&record), sizeof(SpriteRecord));
+        break;
+    }
+    case ComponentRecordType::TEXT_LABEL: {
+        TextLabelRecord record = ReadRecord<TextLabelRecord>(payload);
+        appendString(record.text);
+        appendString(record.fontUID);
+        key.append(reinterpret_cast<const char*>(&record), sizeof(TextLabelRecord));
+        break;
+    }
+    case ComponentRecordType::ANIMATED_SPRITE: {
+        AnimatedSpriteRecord record = ReadRecord<AnimatedSpriteRecord>(payload);
+        appendString(record.currentAnimation);
+        key.append(reinterpret_cast<const char*>(&record), sizeof(AnimatedSpriteRecord));
+        payload += sizeof(AnimatedSpriteRecord);
+        for (uint32_t animationIndex = 0; animationIndex < record.animationCount; animationIndex++) {
+            AnimationRecord animationRecord = ReadRecord<AnimationRecord>(payload);
+            payload += sizeof(AnimationRecord);
+            appendString(animationRecord.name);
+            key.append(reinterpret_cast<const char*>(&animationRecord), sizeof(AnimationRecord));
+            for (uint32_t frameIndex = 0; frameIndex < animationRecord.frameCount; frameIndex++) {
+                AnimationFrameRecord frameRecord = ReadRecord<AnimationFrameRecord>(payload);
+                payload += sizeof(AnimationFrameRecord);
+                appendString(frameRecord.texturePath);
+                key.append(reinterpret_cast<const char*>(&frameRecord), sizeof(AnimationFrameRecord));
+            }
+        }
+        break;
+    }
+    default:
+        // Records without strings compare as is
+        key.append(payload, recordHeader.size);
+        break;
+    }
+    return key;
+}
+
+std::unordered_map<uint16_t, std::string> SceneNodeBinaryParser::GetNodeComponentKeys(uint32_t nodeIndex) const {
+    const BinarySceneFormat::Node& node = nodes[nodeIndex];
+    std::unordered_map<uint16_t, std::string> componentKeys;
+    size_t recordOffset = node.componentsOffset;
+    for (uint32_t componentIndex = 0; componentIndex < node.componentCount; componentIndex++) {
+        const BinarySceneFormat::ComponentRecordHeader recordHeader = ReadRecord<BinarySceneFormat::ComponentRecordHeader>(componentData + recordOffset);
+        recordOffset += sizeof(BinarySceneFormat::ComponentRecordHeader);
+        componentKeys.emplace(recordHeader.type, GetComponentRecordKey(recordHeader, componentData + recordOffset));
+        recordOffset = (recordOffset + recordHeader.size + 3) & ~static_cast<size_t>(3);
+    }
+    return componentKeys;
+}
+
+void SceneNodeBinaryParser::ReplaceComponent(Entity entity, uint32_t nodeIndex, BinarySceneFormat::ComponentRecordType componentRecordType) {
+    using namespace BinarySceneFormat;
+    switch (componentRecordType) {
+    case ComponentRecordType::TRANSFORM_2D:
+        RemoveComponentIfPresent<Transform2DComponent>(entity);
+        break;
+    case ComponentRecordType::SPRITE:
+        RemoveComponentIfPresent<SpriteComponent>(entity);
+        break;
+    case ComponentRecordType::TEXT_LABEL:
+        RemoveComponentIfPresent<TextLabelComponent>(entity);
+        break;
+    case ComponentRecordType::ANIMATED_SPRITE:
+        RemoveComponentIfPresent<AnimatedSpriteComponent>(entity);
+        break;
+    case ComponentRecordType::COLLIDER:
+        RemoveComponentIfPresent<ColliderComponent>(entity);
+        break;
+    }
+    const Node& node = nodes[nodeIndex];
+    size_t recordOffset = node.componentsOffset;
+    for (uint32_t componentIndex = 0; componentIndex < node.componentCount; componentIndex++) {
+        const ComponentRecordHeader recordHeader = ReadRecord<ComponentRecordHeader>(componentData + recordOffset);
+        recordOffset += sizeof(ComponentRecordHeader);
+        if (recordHeader.type == static_cast<uint16_t>(componentRecordType)) {
+            // Adding a component rebuilds the signature from the enabled one, disabled components keep their bit
+            const ComponentSignature signature = entityManager->GetSignature(entity);
+            ParseComponentRecord(entity, recordHeader, componentData + recordOffset);
+            entityManager->SetSignature(entity, signature | entityManager->GetSignature(entity));
+            return;
+        }
+        recordOffset = (recordOffset + recordHeader.size + 3) & ~static_cast<size_t>(3);
+    }
+}
+
+void SceneNodeBinaryParser::ParseScene(Scene* scene) {
+    for (uint32_t nodeIndex = 0; nodeIndex < GetNodeCount(); nodeIndex++) {
+        ParseSceneNode(scene, nodeIndex);
+    }
+}
+
+bool SceneNodeBinaryParser::InstantiateScene(Scene* scene, Entity instanceRootEntity, const std::string& externalSceneSource) {
+    sceneTemplate = SceneTemplateCache::GetInstance()->GetTemplate(externalSceneSource);
+    if (!sceneTemplate) {
+        return false;
+    }
+    if (!Open(sceneTemplate->data(), sceneTemplate->size())) {
+        Logger::GetInstance()->Error("External scene '%s' is invalid!", externalSceneSource.c_str());
+        return false;
+    }
+    // Template root merges into the instance, components the instance already has override the template's
+    AttachRootNode(instanceRootEntity);
+    ParseComponentRecords(instanceRootEntity, nodes[0], true);
+    for (uint32_t nodeIndex = 1; nodeIndex < GetNodeCount(); nodeIndex++) {
+        ParseSceneNode(scene, nodeIndex);
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+
+#include "scene.h"
+#include "binary_scene_format.h"
+
+#include "../ecs/entity/entity_manager.h"
+#include "../ecs/component/component_manager.h"
+#include "../data/asset_manager.h"
+
+// Creates nodes from a compiled scene held in memory, the data must outlive the parser
+class SceneNodeBinaryParser {
+  private:
+    EntityManager *entityManager = nullptr;
+    ComponentManager *componentManager = nullptr;
+    AssetManager *assetManager = nullptr;
+    const BinarySceneFormat::Header* header = nullptr;
+    const uint32_t* stringOffsets = nullptr;
+    const char* stringData = nullptr;
+    const BinarySceneFormat::Node* nodes = nullptr;
+    const uint32_t* tags = nullptr;
+    const char* componentData = nullptr;
+    std::shared_ptr<const std::vector<char>> sceneTemplate; // Last instanced template, the pointers above can point into it
+    std::vector<Entity> nodeEntities;
+    // Asset lookups by string index, so each path is resolved once per scene instead of once per component
+    std::unordered_map<uint32_t, Texture*> textures;
+    std::unordered_map<uint32_t, Font*> fonts;
+
+    bool AreComponentRecordsValid(const BinarySceneFormat::Node& node, size_t componentDataSize) const;
+    std::string GetString(uint32_t stringIndex) const;
+    Texture* GetTexture(uint32_t stringIndex);
+    Font* GetFont(uint32_t stringIndex);
+    template<typename T>
+    void AddComponentSignature(Entity entity, bool isEnabled);
+    void ParseComponentRecord(Entity entity, const BinarySceneFormat::ComponentRecordHeader& recordHeader, const char* payload);
+    void ParseAnimatedSpriteRecord(Entity entity, const char* payload);
+    void ParseComponentRecords(Entity entity, const BinarySceneFormat::Node& node, bool skipExistingComponents);
+    bool HasComponentForRecord(Entity entity, const BinarySceneFormat::ComponentRecordHeader& recordHeader);
+    template<typename T>
+    void RemoveComponentIfPresent(Entity entity);
+    std::string GetComponentRecordKey(const BinarySceneFormat::ComponentRecordHeader& recordHeader, const char* payload) const;
+    size_t GetComponentRecordsSize(const BinarySceneFormat::Node& node) const;
+
+  public:
+    SceneNodeBinaryParser(EntityManager* entityManager, ComponentManager* componentManager) :
+        entityManager(entityManager),
+        componentManager(componentManager),
+        assetManager(AssetManager::GetInstance()) {}
+
+    // Validates 'data' as a compiled scene, nodes can only be parsed after this returns true
+    bool Open(const char* data, size_t size);
+    // Appends the external scene files inlined into a compiled scene, returns false if 'data' isn't a compiled scene
+    static bool GetDependencyFilePaths(const char* data, size_t size, std::vector<std::string>& dependencyFilePaths);
+    uint32_t GetNodeCount() const;
+    // Nodes are parsed in index order, a node's parent must already be parsed.  The root node is added under
+    // 'rootParent', NULL_ENTITY makes it the scene root.
+    Entity ParseSceneNode(Scene* scene, uint32_t nodeIndex, Entity rootParent = NULL_ENTITY);
+    void ParseScene(Scene* scene);
+    // Maps the root node to an existing entity instead of creating it, parsing continues from the root's first child
+    void AttachRootNode(Entity entity);
+    // Creates a single node under 'parent', used to add nodes to a running scene
+    Entity AddSceneNode(Scene* scene, uint32_t nodeIndex, Entity parent);
+
+    // Node contents, used to compare two compiles of the same scene
+    std::string GetNodeName(uint32_t nodeIndex) const;
+    uint32_t GetNodeParentIndex(uint32_t nodeIndex) const;
+    std::vector<std::string> GetNodeTags(uint32_t nodeIndex) const;
+    // Compiles of the same scene with equal strings can have their nodes compared byte for byte
+    bool HasSameStrings(const SceneNodeBinaryParser& other) const;
+    bool IsNodeDataSame(uint32_t nodeIndex, const SceneNodeBinaryParser& other, uint32_t otherNodeIndex) const;
+    // Keyed by record type, records with equal keys create identical components even if their string indices differ
+    std::unordered_map<uint16_t, std::string> GetNodeComponentKeys(uint32_t nodeIndex) const;
+    // Swaps the entity's component of 'componentRecordType' for the node's record, removes it if the node has none
+    void ReplaceComponent(Entity entity, uint32_t nodeIndex, BinarySceneFormat::ComponentRecordType componentRecordType);
+    // Adds the scene from 'externalSceneSource' to an existing node.  The template root's components fill in types the
+    // node doesn't have and its children are added after the node's current children.
+    bool InstantiateScene(Scene* scene, Entity instanceRootEntity, const std::string& externalSceneSource);
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <cassert>
+
+#include "scene_node_naming.h"
+#include "../ecs/entity/entity.h"
+
+// Node names of a scene, unique among siblings, hashed per parent so naming a node and finding one by path such as
+// 'Main/Enemies/Enemy12' cost one lookup per path segment no matter how many children a node has.
+class SceneNodeIndex {
+  public:
+    SceneNodeIndex() :
+        parents(MAX_ENTITIES, NULL_ENTITY),
+        names(MAX_ENTITIES),
+        isIndexed(MAX_ENTITIES, false) {}
+
+    // Registers 'entity' under 'parent' (NULL_ENTITY for root level nodes) and returns its unique name
+    std::string AddNode(Entity entity, Entity parent, const std::string& name) {
+        assert(entity != NULL_ENTITY && "Can't index null entity!");
+        assert(!isIndexed[entity] && "Entity already indexed!");
+        ChildNodes& siblings = children[parent];
+        std::string uniqueName = siblings.naming.AddName(name);
+        siblings.entities.emplace(uniqueName, entity);
+        parents[entity] = parent;
+        names[entity] = uniqueName;
+        isIndexed[entity] = true;
+        return uniqueName;
+    }
+
+    // Children of 'entity' stay indexed under it, move them first if they're kept
+    void RemoveNode(Entity entity) {
+        if (!isIndexed[entity]) {
+            return;
+        }
+        auto it = children.find(parents[entity]);
+        if (it != children.end()) {
+            it->second.entities.erase(names[entity]);
+        }
+        children.erase(entity);
+        parents[entity] = NULL_ENTITY;
+        names[entity].clear();
+        isIndexed[entity] = false;
+    }
+
+    // 'entities' ends with a removed subtree in pre-order starting at 'rootIndex', only its root has a surviving parent
+    void RemoveSubtree(const std::vector<Entity>& entities, size_t rootIndex) {
+        if (rootIndex >= entities.size()) {
+            return;
+        }
+        RemoveNode(entities[rootIndex]);
+        for (size_t i = rootIndex + 1; i < entities.size(); i++) {
+            const Entity entity = entities[i];
+            if (!isIndexed[entity]) {
+                continue;
+            }
+            children.erase(entity);
+            parents[entity] = NULL_ENTITY;
+            names[entity].clear();
+            isIndexed[entity] = false;
+        }
+    }
+
+    // Returns the node's name under 'newParent', a number is added if a new sibling already has it
+    std::string MoveNode(Entity entity, Entity newParent) {
+        assert(isIndexed[entity] && "Entity not indexed!");
+        const std::string name = names[entity];
+        auto it = children.find(parents[entity]);
+        if (it != children.end()) {
+            it->second.entities.erase(name);
+        }
+        isIndexed[entity] = false;
+        return AddNode(entity, newParent, name);
+    }
+
+    bool HasNode(Entity entity) const {
+        return isIndexed[entity];
+    }
+
+    const std::string& GetName(Entity entity) const {
+        return names[entity];
+    }
+
+    // Returns NULL_ENTITY if 'parent' has no child called 'name'
+    Entity GetChild(Entity parent, const std::string& name) const {
+        auto parentIt = children.find(parent);
+        if (parentIt == children.end()) {
+            return NULL_ENTITY;
+        }
+        auto it = parentIt->second.entities.find(name);
+        return it != parentIt->second.entities.end() ? it->second : NULL_ENTITY;
+    }
+
+    // Names separated by '/' starting from a root level node, returns NULL_ENTITY if a segment isn't found
+    Entity GetNode(const std::string& nodePath) const {
+        Entity node = NULL_ENTITY;
+        std::string name;
+        size_t segmentStart = 0;
+        while (true) {
+            const size_t segmentEnd = nodePath.find('/', segmentStart);
+            name.assign(nodePath, segmentStart, segmentEnd == std::string::npos ? std::string::npos : segmentEnd - segmentStart);
+            node = GetChild(node, name);
+            if (node == NULL_ENTITY || segmentEnd == std::string::npos) {
+                return node;
+            }
+            segmentStart = segmentEnd + 1;
+        }
+    }
+
+    void Clear() {
+        children.clear();
+        std::fill(parents.begin(), parents.end(), NULL_ENTITY);
+        std::fill(names.begin(), names.end(), std::string());
+        std::fill(isIndexed.begin(), isIndexed.end(), false);
+    }
+
+  private:
+    struct ChildNodes {
+        SceneNodeNaming naming;
+        std::unordered_map<std::string, Entity> entities;
+    };
+
+    std::unordered_map<Entity, ChildNodes> children;
+    std::vector<Entity> parents;
+    std::vector<std::string> names;
+    std::vector<bool> isIndexed;
+};
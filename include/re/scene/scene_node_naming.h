@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+
+// Unique names among one parent's children, shared by the scene loaders and the offline scene compiler so both produce
+// the same names.  Keeps the highest number used per base name so adding a name is a single hash lookup.
+class SceneNodeNaming {
+  public:
+    // Splits 'Enemy12' into 'Enemy' and 12, the number is 0 when the name doesn't end with digits
+    static void SplitName(const std::string& name, std::string& baseName, unsigned int& number) {
+        size_t baseNameLength = name.size();
+        while (baseNameLength > 0 && name[baseNameLength - 1] >= '0' && name[baseNameLength - 1] <= '9') {
+            baseNameLength--;
+        }
+        unsigned long long parsedNumber = 0;
+        for (size_t i = baseNameLength; i < name.size() && parsedNumber <= MAX_NAME_NUMBER; i++) {
+            parsedNumber = parsedNumber * 10 + static_cast<unsigned long long>(name[i] - '0');
+        }
+        baseName.assign(name, 0, baseNameLength);
+        // Compared instead of std::min, binding the constant to a reference would need an out of line definition
+        number = static_cast<unsigned int>(parsedNumber < MAX_NAME_NUMBER ? parsedNumber : MAX_NAME_NUMBER);
+    }
+
+    // Returns 'name' if its number is above every earlier name sharing its base name, otherwise the base name with the
+    // next number.  'Enemy', 'Enemy', 'Enemy' become 'Enemy', 'Enemy2', 'Enemy3'.
+    std::string AddName(const std::string& name) {
+        std::string baseName;
+        unsigned int number;
+        SplitName(name, baseName, number);
+        auto it = highestBaseNameNumbers.find(baseName);
+        if (it == highestBaseNameNumbers.end()) {
+            // A name without a number takes the place of 1
+            highestBaseNameNumbers.emplace(std::move(baseName), std::max(number, 1u));
+            return name;
+        }
+        if (number > it->second) {
+            it->second = number;
+            return name;
+        }
+        it->second++;
+        return it->first + std::to_string(it->second);
+    }
+
+    void Clear() {
+        highestBaseNameNumbers.clear();
+    }
+
+  private:
+    static constexpr unsigned long long MAX_NAME_NUMBER = 1000000000ULL;
+
+    std::unordered_map<std::string, unsigned int> highestBaseNameNumbers;
+};
@@ -2,9 +2,7 @@
 
 #include <functional>
 
-#include "scene_manager.h"
-#include "../camera/camera_manager.h"
-#include "../ecs/component/component_manager.h"
+#include "../ecs/world.h"
 #include "../ecs/component/components/scene_component.h"
 #include "../ecs/component/components/transform2d_component.h"
 #include "re/math/redmath.h"
@@ -13,59 +11,60 @@ using CombineTransform2DFunction = std::function<Transform2DComponent(const Tran
 
 class SceneNodeUtils {
   public:
-    static Transform2DComponent TranslateEntityTransformIntoWorld(Entity entity) {
-        static ComponentManager* componentManager = ComponentManager::GetInstance();
-        Transform2DComponent entityTransform = GetEntityCombinedParentsTransforms(entity);
+    static Transform2DComponent TranslateEntityTransformIntoWorld(Entity entity, World* world) {
+        ComponentManager* componentManager = world->GetComponentManager();
+        Transform2DComponent entityTransform = GetEntityWorldTransform(entity, world);
         SceneComponent sceneComponent = componentManager->GetComponent<SceneComponent>(entity);
         if (!sceneComponent.ignoreCamera) {
-            entityTransform = TranslateCamera2D(entityTransform);
+            entityTransform = TranslateCamera2D(entityTransform, world);
         }
         return entityTransform;
     }
 
-    static Transform2DComponent TranslateWorldTransformIntoLocal(Entity entity, const Transform2DComponent& worldTransform) {
-        static ComponentManager* componentManager = ComponentManager::GetInstance();
-        Transform2DComponent entityTransform = GetEntityDeCombinedParentsTransforms(entity);
+    static Transform2DComponent TranslateWorldTransformIntoLocal(Entity entity, const Transform2DComponent& worldTransform, World* world) {
+        ComponentManager* componentManager = world->GetComponentManager();
+        Transform2DComponent entityTransform = GetEntityDeCombinedParentsTransforms(entity, world);
         SceneComponent sceneComponent = componentManager->GetComponent<SceneComponent>(entity);
         if (!sceneComponent.ignoreCamera) {
-            entityTransform = DeTranslateCamera2D(entityTransform);
+            entityTransform = DeTranslateCamera2D(entityTransform, world);
         }
         return entityTransform;
     }
 
   private:
-    static Transform2DComponent GetEntityCombinedParentsTransforms(Entity entity) {
-        static SceneManager* sceneManager = SceneManager::GetInstance();
-        static ComponentManager* componentManager = ComponentManager::GetInstance();
-        static CombineTransform2DFunction funcAddTransforms = [](const Transform2DComponent& transformA, const Transform2DComponent& transformB) {
-            Transform2DComponent combinedTransform{};
-            return Transform2DComponent{
-                transformA.position + transformB.position,
-                transformA.scale * transformB.scale,
-                transformA.rotation + transformB.rotation,
-                transformA.zIndex + transformB.zIndex,
-            };
-        };
+    // Reads the scene's cached world transform, nodes added, reparented or moved since the last refresh walk their
+    // parent chain
+    static Transform2DComponent GetEntityWorldTransform(Entity entity, World* world) {
+        const SceneTransformCache& worldTransforms = world->GetSceneManager()->GetCurrentScene()->worldTransforms;
+        if (worldTransforms.IsValid(entity)) {
+            return worldTransforms.GetWorldTransform(entity);
+        }
+        return GetEntityCombinedParentsTransforms(entity, world);
+    }
+
+    static Transform2DComponent GetEntityCombinedParentsTransforms(Entity entity, World* world) {
+        SceneManager* sceneManager = world->GetSceneManager();
+        ComponentManager* componentManager = world->GetComponentManager();
         // Impl
-        SceneNode sceneNode = sceneManager->GetCurrentScene()->GetSceneNode(entity);
+        const SceneHierarchy& hierarchy = sceneManager->GetCurrentScene()->hierarchy;
+        assert(hierarchy.HasNode(entity) && "Entity doesn't have a scene node!");
         Transform2DComponent combinedTransform = Transform2DComponent{};
-        Entity currentParent = sceneNode.parent;
+        Entity currentParent = hierarchy.GetParent(entity);
         while (currentParent != NULL_ENTITY) {
-            SceneNode nodeParent = sceneManager->GetCurrentScene()->GetSceneNode(currentParent);
-            if (componentManager->HasComponent<Transform2DComponent>(nodeParent.entity)) {
-                Transform2DComponent parentTransform = componentManager->GetComponent<Transform2DComponent>(nodeParent.entity);
-                combinedTransform = funcAddTransforms(combinedTransform, parentTransform);
+            if (componentManager->HasComponent<Transform2DComponent>(currentParent)) {
+                const Transform2DComponent& parentTransform = componentManager->GetComponent<Transform2DComponent>(currentParent);
+                combinedTransform = SceneTransformCache::CombineTransforms(combinedTransform, parentTransform);
             }
-            currentParent = nodeParent.parent;
+            currentParent = hierarchy.GetParent(currentParent);
         }
         // Combine Entity and parent transforms
         Transform2DComponent entityTransform = componentManager->GetComponent<Transform2DComponent>(entity);
-        return funcAddTransforms(entityTransform, combinedTransform);
+        return SceneTransformCache::CombineTransforms(entityTransform, combinedTransform);
     }
 
-    static Transform2DComponent GetEntityDeCombinedParentsTransforms(Entity entity) {
-        static SceneManager* sceneManager = SceneManager::GetInstance();
-        static ComponentManager* componentManager = ComponentManager::GetInstance();
+    static Transform2DComponent GetEntityDeCombinedParentsTransforms(Entity entity, World* world) {
+        SceneManager* sceneManager = world->GetSceneManager();
+        ComponentManager* componentManager = world->GetComponentManager();
         static CombineTransform2DFunction funcSubTransforms = [](const Transform2DComponent& transformA, const Transform2DComponent& transformB) {
             Transform2DComponent combinedTransform{};
             return Transform2DComponent{
@@ -76,35 +75,33 @@ class SceneNodeUtils {
             };
         };
         // Impl
-        SceneNode sceneNode = sceneManager->GetCurrentScene()->GetSceneNode(entity);
+        const SceneHierarchy& hierarchy = sceneManager->GetCurrentScene()->hierarchy;
+        assert(hierarchy.HasNode(entity) && "Entity doesn't have a scene node!");
         Transform2DComponent combinedTransform = Transform2DComponent{};
-        Entity currentParent = sceneNode.parent;
+        Entity currentParent = hierarchy.GetParent(entity);
         while (currentParent != NULL_ENTITY) {
-            SceneNode nodeParent = sceneManager->GetCurrentScene()->GetSceneNode(currentParent);
-            if (componentManager->HasComponent<Transform2DComponent>(nodeParent.entity)) {
-                Transform2DComponent parentTransform = componentManager->GetComponent<Transform2DComponent>(nodeParent.entity);
+            if (componentManager->HasComponent<Transform2DComponent>(currentParent)) {
+                const Transform2DComponent& parentTransform = componentManager->GetComponent<Transform2DComponent>(currentParent);
                 combinedTransform = funcSubTransforms(combinedTransform, parentTransform);
             }
-            currentParent = nodeParent.parent;
+            currentParent = hierarchy.GetParent(currentParent);
         }
         // Combine Entity and parent transforms
         Transform2DComponent entityTransform = componentManager->GetComponent<Transform2DComponent>(entity);
         return funcSubTransforms(entityTransform, combinedTransform);
     }
 
-    static Transform2DComponent TranslateCamera2D(const Transform2DComponent& transform2DComponent) {
-        static CameraManager* cameraManager = CameraManager::GetInstance();
+    static Transform2DComponent TranslateCamera2D(const Transform2DComponent& transform2DComponent, World* world) {
         Transform2DComponent translatedTransform{};
-        Camera2D camera = cameraManager->GetCurrentCamera();
+        Camera2D camera = world->GetCameraManager()->GetCurrentCamera();
         translatedTransform.position = (transform2DComponent.position - camera.viewport + camera.offset) * camera.zoom;
         translatedTransform.scale = transform2DComponent.scale * camera.zoom;
         return translatedTransform;
     }
 
-    static Transform2DComponent DeTranslateCamera2D(const Transform2DComponent& transform2DComponent) {
-        static CameraManager* cameraManager = CameraManager::GetInstance();
+    static Transform2DComponent DeTranslateCamera2D(const Transform2DComponent& transform2DComponent, World* world) {
         Transform2DComponent translatedTransform{};
-        Camera2D camera = cameraManager->GetCurrentCamera();
+        Camera2D camera = world->GetCameraManager()->GetCurrentCamera();
         translatedTransform.position = (transform2DComponent.position + camera.viewport - camera.offset) / camera.zoom;
         translatedTransform.scale = transform2DComponent.scale / camera.zoom;
         return translatedTransform;
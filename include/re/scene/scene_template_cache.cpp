@@ -0,0 +1,34 @@
+#include "scene_template_cache.h"
+
+#include "scene_loader.h"
+#include "binary_scene_compiler.h"
+
+SceneTemplateCache::SceneTemplateCache(singleton) {}
+
+std::shared_ptr<const std::vector<char>> SceneTemplateCache::GetTemplate(const std::string& filePath) {
+    std::lock_guard<std::mutex> templatesLock(templatesMutex);
+    auto it = templates.find(filePath);
+    if (it != templates.end()) {
+        return it->second;
+    }
+    const std::string compiledFilePath = SceneLoader::GetCompiledSceneFilePath(filePath);
+    if (!compiledFilePath.empty()) {
+        MappedFile compiledSceneFile(compiledFilePath);
+        if (compiledSceneFile.IsValid()) {
+            std::shared_ptr<const std::vector<char>> compiledScene = std::make_shared<const std::vector<char>>(compiledSceneFile.GetData(), compiledSceneFile.GetData() + compiledSceneFile.GetSize());
+            return templates.emplace(filePath, std::move(compiledScene)).first->second;
+        }
+    }
+    if (!FileHelper::DoesFileExist(filePath) || BinarySceneFormat::IsCompiledFilePath(filePath)) {
+        Logger::GetInstance()->Error("External scene '%s' not found!", filePath.c_str());
+        // Cached as missing so every instance doesn't check the file system again
+        templates.emplace(filePath, nullptr);
+        return nullptr;
+    }
+    return templates.emplace(filePath, std::make_shared<const std::vector<char>>(BinarySceneCompiler::CompileSceneJson(JsonFileHelper::LoadJsonFile(filePath), filePath))).first->second;
+}
+
+void SceneTemplateCache::Clear() {
+    std::lock_guard<std::mutex> templatesLock(templatesMutex);
+    templates.clear();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "../utils/singleton.h"
+
+// Scenes referenced through 'external_scene_source', compiled once and instanced from memory afterwards.  Safe to
+// call from any thread.  Cleared when a scene is destroyed and when hot reload sees a change, so edited external scenes
+// are picked up by the next instance.  Templates are shared, one handed out stays valid after 'Clear' until released.
+class SceneTemplateCache : public Singleton<SceneTemplateCache> {
+  public:
+    SceneTemplateCache(singleton);
+    // Returns the compiled scene, nullptr if the file doesn't exist
+    std::shared_ptr<const std::vector<char>> GetTemplate(const std::string& filePath);
+    // Drops the cached templates, ones still held elsewhere are freed when released
+    void Clear();
+
+  private:
+    std::mutex templatesMutex;
+    std::unordered_map<std::string, std::shared_ptr<const std::vector<char>>> templates;
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+
+#include "scene_hierarchy.h"
+#include "transform_propagator.h"
+#include "../ecs/component/component_manager.h"
+#include "../ecs/component/components/transform2d_component.h"
+
+// World space transforms of scene nodes.  Local transforms are written through ECSOrchestrator::UpdateComponent, which
+// marks the node and its subtree dirty, so a cached transform is valid whenever its node isn't dirty and a refresh only
+// recomputes the dirty subtrees, parents before children.  A reused scene is refreshed in full.
+class SceneTransformCache {
+  public:
+    SceneTransformCache() :
+        worldTransforms(MAX_ENTITIES),
+        dirty(MAX_ENTITIES, true) {}
+
+    // Marks 'entity' and its descendants to be recomputed on the next refresh, used when a node moves or is added,
+    // removed or reparented
+    void MarkDirty(Entity entity, const SceneHierarchy& hierarchy) {
+        dirty[entity] = true;
+        if (!hierarchy.HasNode(entity)) {
+            return;
+        }
+        dirtyRoots.emplace_back(entity);
+        // Descendants of a dirty node are already dirty, so those subtrees are skipped
+        markStack.clear();
+        markStack.emplace_back(entity);
+        while (!markStack.empty()) {
+            const Entity node = markStack.back();
+            markStack.pop_back();
+            hierarchy.ForEachChild(node, [this](Entity child) {
+                if (!dirty[child]) {
+                    dirty[child] = true;
+                    markStack.emplace_back(child);
+                }
+            });
+        }
+    }
+
+    // Every node is recomputed on the next refresh, used when the scene is reused for another one
+    void Clear() {
+        std::fill(dirty.begin(), dirty.end(), true);
+        dirtyRoots.clear();
+        isFullRefreshNeeded = true;
+    }
+
+    bool IsValid(Entity entity) const {
+        return !dirty[entity];
+    }
+
+    const Transform2DComponent& GetWorldTransform(Entity entity) const {
+        assert(IsValid(entity) && "World transform hasn't been computed for entity!");
+        return worldTransforms[entity];
+    }
+
+    void Refresh(const SceneHierarchy& hierarchy, ComponentManager* componentManager) {
+        if (isFullRefreshNeeded) {
+            RefreshSubtree(NULL_ENTITY, hierarchy, componentManager);
+            isFullRefreshNeeded = false;
+            dirtyRoots.clear();
+            return;
+        }
+        for (Entity entity : dirtyRoots) {
+            if (!dirty[entity] || !hierarchy.HasNode(entity)) {
+                continue;
+            }
+            // Refreshed from the topmost dirty ancestor, which may have been marked after 'entity'
+            Entity subtreeRoot = entity;
+            for (Entity parent = hierarchy.GetParent(entity); parent != NULL_ENTITY && dirty[parent]; parent = hierarchy.GetParent(parent)) {
+                subtreeRoot = parent;
+            }
+            RefreshSubtree(subtreeRoot, hierarchy, componentManager);
+        }
+        dirtyRoots.clear();
+    }
+
+    // Full refreshes of large hierarchies go through the batched propagator, dirty subtrees are refreshed as usual
+    void RefreshBatched(const SceneHierarchy& hierarchy, ComponentManager* componentManager, TransformPropagator& propagator) {
+        if (!isFullRefreshNeeded) {
+            Refresh(hierarchy, componentManager);
+            return;
+        }
+        static const Transform2DComponent identityTransform = Transform2DComponent{};
+        if (!propagator.IsBuiltFrom(hierarchy)) {
+            propagator.Build(hierarchy);
+        }
+        const size_t slotCount = propagator.GetSlotCount();
+        for (size_t slot = TransformPropagator::ROOT_SLOT + 1; slot < slotCount; slot++) {
+            const Entity entity = propagator.GetSlotEntity(slot);
+            propagator.SetLocalTransform(slot, componentManager->HasComponent<Transform2DComponent>(entity)
+                                         ? componentManager->GetComponent<Transform2DComponent>(entity) : identityTransform);
+        }
+        propagator.Propagate();
+        for (size_t slot = TransformPropagator::ROOT_SLOT + 1; slot < slotCount; slot++) {
+            const Entity entity = propagator.GetSlotEntity(slot);
+            worldTransforms[entity] = propagator.GetWorldTransform(slot);
+            dirty[entity] = false;
+        }
+        isFullRefreshNeeded = false;
+        dirtyRoots.clear();
+    }
+
+    // Same combination used when walking the parent chain, kept here so cached and uncached results match
+    static Transform2DComponent CombineTransforms(const Transform2DComponent& transformA, const Transform2DComponent& transformB) {
+        return Transform2DComponent{
+            transformA.position + transformB.position,
+            transformA.scale * transformB.scale,
+            transformA.rotation + transformB.rotation,
+            transformA.zIndex + transformB.zIndex,
+        };
+    }
+
+  private:
+    std::vector<Transform2DComponent> worldTransforms;
+    std::vector<bool> dirty;
+    std::vector<Entity> dirtyRoots; // Nodes marked since the last refresh, their subtrees are the ones to recompute
+    std::vector<Entity> markStack; // Reused across 'MarkDirty' calls
+    bool isFullRefreshNeeded = true;
+
+    // Recomputes 'root' and its descendants, NULL_ENTITY recomputes the whole hierarchy
+    void RefreshSubtree(Entity root, const SceneHierarchy& hierarchy, ComponentManager* componentManager) {
+        static const Transform2DComponent identityTransform = Transform2DComponent{};
+        hierarchy.TraverseDepthFirst(root, [this, &hierarchy, componentManager](Entity entity) {
+            const Transform2DComponent& localTransform = componentManager->HasComponent<Transform2DComponent>(entity)
+                    ? componentManager->GetComponent<Transform2DComponent>(entity) : identityTransform;
+            const Entity parent = hierarchy.GetParent(entity);
+            worldTransforms[entity] = CombineTransforms(localTransform, parent != NULL_ENTITY ? worldTransforms[parent] : identityTransform);
+            dirty[entity] = false;
+        });
+    }
+};
@@ -0,0 +1,253 @@
+#include "transform_propagator.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+const size_t TransformPropagator::ROOT_SLOT;
+const unsigned int TransformPropagator::BATCHED_NODE_THRESHOLD;
+const size_t TransformPropagator::MIN_NODES_PER_JOB;
+
+void Transform2DArrays::Reserve(size_t size) {
+    positionX.reserve(size);
+    positionY.reserve(size);
+    scaleX.reserve(size);
+    scaleY.reserve(size);
+    rotation.reserve(size);
+    zIndex.reserve(size);
+}
+
+void Transform2DArrays::Resize(size_t size) {
+    positionX.resize(size, 0.0f);
+    positionY.resize(size, 0.0f);
+    scaleX.resize(size, 1.0f);
+    scaleY.resize(size, 1.0f);
+    rotation.resize(size, 0.0f);
+    zIndex.resize(size, 0);
+}
+
+void Transform2DArrays::Set(size_t index, const Transform2DComponent& transform) {
+    positionX[index] = transform.position.x;
+    positionY[index] = transform.position.y;
+    scaleX[index] = transform.scale.x;
+    scaleY[index] = transform.scale.y;
+    rotation[index] = transform.rotation;
+    zIndex[index] = transform.zIndex;
+}
+
+Transform2DComponent Transform2DArrays::Get(size_t index) const {
+    return Transform2DComponent{
+        Vector2(positionX[index], positionY[index]),
+        Vector2(scaleX[index], scaleY[index]),
+        rotation[index],
+        zIndex[index]
+    };
+}
+
+TransformPropagator::TransformPropagator(unsigned int workerCount) : nextChunk(0) {
+    Reset();
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&TransformPropagator::WorkerLoop, this);
+    }
+}
+
+TransformPropagator::~TransformPropagator() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        isShuttingDown = true;
+    }
+    jobCondition.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned int TransformPropagator::DefaultWorkerCount() {
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? std::min(hardwareThreads - 1, 7u) : 0;
+}
+
+void TransformPropagator::Reset() {
+    slotEntities.assign(1, NULL_ENTITY);
+    parentSlots.assign(1, ROOT_SLOT);
+    levelOffsets.clear();
+    builtHierarchy = nullptr;
+    localTransforms.Resize(0);
+    worldTransforms.Resize(0);
+    localTransforms.Resize(1);
+    worldTransforms.Resize(1);
+}
+
+void TransformPropagator::Reserve(size_t nodeCount) {
+    slotEntities.reserve(nodeCount + 1);
+    parentSlots.reserve(nodeCount + 1);
+    localTransforms.Reserve(nodeCount + 1);
+    worldTransforms.Reserve(nodeCount + 1);
+}
+
+void TransformPropagator::BeginLevel() {
+    // Skip empty levels so 'levelOffsets' only holds non empty ranges
+    if (levelOffsets.empty() || levelOffsets.back() != slotEntities.size()) {
+        levelOffsets.emplace_back(slotEntities.size());
+    }
+}
+
+size_t TransformPropagator::AddNode(Entity entity, size_t parentSlot) {
+    assert(!levelOffsets.empty() && "BeginLevel must be called before adding nodes!");
+    assert(parentSlot < levelOffsets.back() && "Parent must belong to a previous level!");
+    const size_t slot = slotEntities.size();
+    slotEntities.emplace_back(entity);
+    parentSlots.emplace_back(static_cast<unsigned int>(parentSlot));
+    localTransforms.Resize(slot + 1);
+    worldTransforms.Resize(slot + 1);
+    return slot;
+}
+
+void TransformPropagator::Build(const SceneHierarchy& hierarchy) {
+    Reset();
+    Reserve(hierarchy.GetNodeCount());
+    BeginLevel();
+    hierarchy.ForEachChild(NULL_ENTITY, [this](Entity entity) {
+        AddNode(entity, ROOT_SLOT);
+    });
+    size_t levelBegin = ROOT_SLOT + 1;
+    while (levelBegin < GetSlotCount()) {
+        const size_t levelEnd = GetSlotCount();
+        BeginLevel();
+        for (size_t slot = levelBegin; slot < levelEnd; slot++) {
+            hierarchy.ForEachChild(slotEntities[slot], [this, slot](Entity child) {
+                AddNode(child, slot);
+            });
+        }
+        levelBegin = levelEnd;
+    }
+    builtHierarchy = &hierarchy;
+    builtStructureVersion = hierarchy.GetStructureVersion();
+}
+
+void TransformPropagator::Propagate() {
+    worldTransforms.Set(ROOT_SLOT, Transform2DComponent{});
+    for (size_t level = 0; level < levelOffsets.size(); level++) {
+        const size_t levelEnd = level + 1 < levelOffsets.size() ? levelOffsets[level + 1] : GetSlotCount();
+        PropagateLevel(levelOffsets[level], levelEnd);
+    }
+}
+
+void TransformPropagator::PropagateLevel(size_t begin, size_t end) {
+    const size_t nodeCount = end - begin;
+    if (workers.empty() || nodeCount < MIN_NODES_PER_JOB * 2) {
+        PropagateRange(begin, end);
+        return;
+    }
+    const size_t chunkCount = std::min(workers.size() + 1, nodeCount / MIN_NODES_PER_JOB);
+    {
+        // Workers still leaving the previous job would otherwise claim chunks of this one
+        std::unique_lock<std::mutex> lock(jobMutex);
+        jobDoneCondition.wait(lock, [this] { return activeWorkers == 0; });
+        jobBegin = begin;
+        jobEnd = end;
+        jobChunkCount = chunkCount;
+        jobChunkSize = (nodeCount + chunkCount - 1) / chunkCount;
+        nextChunk = 0;
+        pendingChunks = chunkCount;
+        jobGeneration++;
+    }
+    jobCondition.notify_all();
+    RunJobChunks();
+    std::unique_lock<std::mutex> lock(jobMutex);
+    jobDoneCondition.wait(lock, [this] { return pendingChunks == 0; });
+}
+
+void TransformPropagator::WorkerLoop() {
+    unsigned int seenJobGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobCondition.wait(lock, [this, &seenJobGeneration] { return isShuttingDown || jobGeneration != seenJobGeneration; });
+            if (isShuttingDown) {
+                return;
+            }
+            seenJobGeneration = jobGeneration;
+            activeWorkers++;
+        }
+        RunJobChunks();
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            activeWorkers--;
+        }
+        jobDoneCondition.notify_all();
+    }
+}
+
+void TransformPropagator::RunJobChunks() {
+    for (size_t chunk = nextChunk++; chunk < jobChunkCount; chunk = nextChunk++) {
+        const size_t chunkBegin = jobBegin + chunk * jobChunkSize;
+        PropagateRange(chunkBegin, std::min(chunkBegin + jobChunkSize, jobEnd));
+        bool isJobDone = false;
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            isJobDone = --pendingChunks == 0;
+        }
+        if (isJobDone) {
+            jobDoneCondition.notify_all();
+        }
+    }
+}
+
+// world = local + parent world (scale multiplies), parents always belong to an earlier level so reads and writes of a
+// range never overlap
+void TransformPropagator::PropagateRange(size_t begin, size_t end) {
+    const unsigned int* parents = parentSlots.data();
+    const float* localPositionX = localTransforms.positionX.data();
+    const float* localPositionY = localTransforms.positionY.data();
+    const float* localScaleX = localTransforms.scaleX.data();
+    const float* localScaleY = localTransforms.scaleY.data();
+    const float* localRotation = localTransforms.rotation.data();
+    const int* localZIndex = localTransforms.zIndex.data();
+    float* worldPositionX = worldTransforms.positionX.data();
+    float* worldPositionY = worldTransforms.positionY.data();
+    float* worldScaleX = worldTransforms.scaleX.data();
+    float* worldScaleY = worldTransforms.scaleY.data();
+    float* worldRotation = worldTransforms.rotation.data();
+    int* worldZIndex = worldTransforms.zIndex.data();
+
+    size_t i = begin;
+#if defined(__AVX2__)
+    for (; i + 8 <= end; i += 8) {
+        const __m256i parentIndices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(parents + i));
+        _mm256_storeu_ps(worldPositionX + i, _mm256_add_ps(_mm256_loadu_ps(localPositionX + i), _mm256_i32gather_ps(worldPositionX, parentIndices, 4)));
+        _mm256_storeu_ps(worldPositionY + i, _mm256_add_ps(_mm256_loadu_ps(localPositionY + i), _mm256_i32gather_ps(worldPositionY, parentIndices, 4)));
+        _mm256_storeu_ps(worldScaleX + i, _mm256_mul_ps(_mm256_loadu_ps(localScaleX + i), _mm256_i32gather_ps(worldScaleX, parentIndices, 4)));
+        _mm256_storeu_ps(worldScaleY + i, _mm256_mul_ps(_mm256_loadu_ps(localScaleY + i), _mm256_i32gather_ps(worldScaleY, parentIndices, 4)));
+        _mm256_storeu_ps(worldRotation + i, _mm256_add_ps(_mm256_loadu_ps(localRotation + i), _mm256_i32gather_ps(worldRotation, parentIndices, 4)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(worldZIndex + i),
+                            _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(localZIndex + i)), _mm256_i32gather_epi32(worldZIndex, parentIndices, 4)));
+    }
+#elif defined(__SSE2__)
+    // No gather before AVX2, siblings are adjacent so the scalar parent loads mostly hit the same cache line
+    for (; i + 4 <= end; i += 4) {
+        const unsigned int p0 = parents[i];
+        const unsigned int p1 = parents[i + 1];
+        const unsigned int p2 = parents[i + 2];
+        const unsigned int p3 = parents[i + 3];
+        _mm_storeu_ps(worldPositionX + i, _mm_add_ps(_mm_loadu_ps(localPositionX + i), _mm_set_ps(worldPositionX[p3], worldPositionX[p2], worldPositionX[p1], worldPositionX[p0])));
+        _mm_storeu_ps(worldPositionY + i, _mm_add_ps(_mm_loadu_ps(localPositionY + i), _mm_set_ps(worldPositionY[p3], worldPositionY[p2], worldPositionY[p1], worldPositionY[p0])));
+        _mm_storeu_ps(worldScaleX + i, _mm_mul_ps(_mm_loadu_ps(localScaleX + i), _mm_set_ps(worldScaleX[p3], worldScaleX[p2], worldScaleX[p1], worldScaleX[p0])));
+        _mm_storeu_ps(worldScaleY + i, _mm_mul_ps(_mm_loadu_ps(localScaleY + i), _mm_set_ps(worldScaleY[p3], worldScaleY[p2], worldScaleY[p1], worldScaleY[p0])));
+        _mm_storeu_ps(worldRotation + i, _mm_add_ps(_mm_loadu_ps(localRotation + i), _mm_set_ps(worldRotation[p3], worldRotation[p2], worldRotation[p1], worldRotation[p0])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(worldZIndex + i),
+                         _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(localZIndex + i)), _mm_set_epi32(worldZIndex[p3], worldZIndex[p2], worldZIndex[p1], worldZIndex[p0])));
+    }
+#endif
+    for (; i < end; i++) {
+        const unsigned int parent = parents[i];
+        worldPositionX[i] = localPositionX[i] + worldPositionX[parent];
+        worldPositionY[i] = localPositionY[i] + worldPositionY[parent];
+        worldScaleX[i] = localScaleX[i] * worldScaleX[parent];
+        worldScaleY[i] = localScaleY[i] * worldScaleY[parent];
+        worldRotation[i] = localRotation[i] + worldRotation[parent];
+        worldZIndex[i] = localZIndex[i] + worldZIndex[parent];
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "scene_hierarchy.h"
+#include "../ecs/component/components/transform2d_component.h"
+
+// Transforms stored as structure of arrays so a level can be combined several nodes at a time
+struct Transform2DArrays {
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> scaleX;
+    std::vector<float> scaleY;
+    std::vector<float> rotation;
+    std::vector<int> zIndex;
+
+    void Reserve(size_t size);
+    void Resize(size_t size);
+    void Set(size_t index, const Transform2DComponent& transform);
+    Transform2DComponent Get(size_t index) const;
+};
+
+// Batched world transform propagation.  Nodes are laid out breadth first so every level of the hierarchy is a
+// contiguous range of slots whose parents live in earlier levels, which lets a level be combined with SIMD and split
+// across worker threads without any ordering between nodes of the same level.  Slot 0 is a virtual root holding the
+// identity transform.
+class TransformPropagator {
+  public:
+    static const size_t ROOT_SLOT = 0;
+    static const unsigned int BATCHED_NODE_THRESHOLD = 4096; // Hierarchies smaller than this are cheaper to walk
+    static const size_t MIN_NODES_PER_JOB = 2048;
+
+    // 'workerCount' threads help with wide levels, the calling thread always takes part
+    explicit TransformPropagator(unsigned int workerCount = DefaultWorkerCount());
+    ~TransformPropagator();
+    TransformPropagator(const TransformPropagator&) = delete;
+    TransformPropagator& operator=(const TransformPropagator&) = delete;
+
+    // Layout
+    void Reset();
+    void Reserve(size_t nodeCount);
+    void BeginLevel();
+    size_t AddNode(Entity entity, size_t parentSlot);
+    void Build(const SceneHierarchy& hierarchy);
+
+    bool IsBuiltFrom(const SceneHierarchy& hierarchy) const {
+        return builtHierarchy == &hierarchy && builtStructureVersion == hierarchy.GetStructureVersion();
+    }
+
+    size_t GetSlotCount() const {
+        return slotEntities.size();
+    }
+
+    Entity GetSlotEntity(size_t slot) const {
+        return slotEntities[slot];
+    }
+
+    // Transforms
+    void SetLocalTransform(size_t slot, const Transform2DComponent& transform) {
+        localTransforms.Set(slot, transform);
+    }
+
+    Transform2DComponent GetWorldTransform(size_t slot) const {
+        return worldTransforms.Get(slot);
+    }
+
+    void Propagate();
+
+    static unsigned int DefaultWorkerCount();
+
+  private:
+    std::vector<Entity> slotEntities;
+    std::vector<unsigned int> parentSlots;
+    std::vector<size_t> levelOffsets;
+    const SceneHierarchy* builtHierarchy = nullptr;
+    unsigned int builtStructureVersion = 0;
+    Transform2DArrays localTransforms;
+    Transform2DArrays worldTransforms;
+
+    // Worker pool, one job is a level range cut into chunks that threads claim from 'nextChunk'
+    std::vector<std::thread> workers;
+    std::mutex jobMutex;
+    std::condition_variable jobCondition;
+    std::condition_variable jobDoneCondition;
+    unsigned int jobGeneration = 0;
+    size_t jobBegin = 0;
+    size_t jobEnd = 0;
+    size_t jobChunkSize = 0;
+    size_t jobChunkCount = 0;
+    std::atomic<size_t> nextChunk;
+    size_t pendingChunks = 0;
+    unsigned int activeWorkers = 0;
+    bool isShuttingDown = false;
+
+    void WorkerLoop();
+    void RunJobChunks();
+    void PropagateLevel(size_t begin, size_t end);
+    void PropagateRange(size_t begin, size_t end);
+};
@@ -0,0 +1,282 @@
+#include "world_streamer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+
+#include "scene_loader.h"
+#include "binary_scene_compiler.h"
+#include "../utils/file_helper.h"
+#include "../utils/json_helper.h"
+#include "../utils/logger.h"
+
+WorldStreamer::WorldStreamer(EntityManager* entityManager, ComponentManager* componentManager) :
+    entityManager(entityManager),
+    componentManager(componentManager),
+    sceneNodeBinaryParser(entityManager, componentManager),
+    hasFinishedLoading(false) {}
+
+WorldStreamer::~WorldStreamer() {
+    if (loadThread.joinable()) {
+        loadThread.join();
+    }
+}
+
+bool WorldStreamer::LoadWorldFile(const std::string& worldFilePath) {
+    if (!FileHelper::DoesFileExist(worldFilePath)) {
+        Logger::GetInstance()->Error("World file '%s' not found!", worldFilePath.c_str());
+        return false;
+    }
+    Reset();
+    cells.clear();
+    cellIndices.clear();
+    const MappedFile worldFile(worldFilePath);
+    if (!worldFile.IsValid()) {
+        Logger::GetInstance()->Error("World file '%s' couldn't be read!", worldFilePath.c_str());
+        return false;
+    }
+    const nlohmann::json worldJson = nlohmann::json::parse(worldFile.GetData(), worldFile.GetData() + worldFile.GetSize(), nullptr, false);
+    if (worldJson.is_discarded()) {
+        Logger::GetInstance()->Error("World file '%s' isn't valid json!", worldFilePath.c_str());
+        return false;
+    }
+    try {
+        JsonMissingKeyThrowScope missingKeyThrowScope;
+        LoadCells(worldFilePath, worldJson);
+    } catch (const nlohmann::json::exception& exception) {
+        Logger::GetInstance()->Error("World file '%s' is invalid: %s", worldFilePath.c_str(), exception.what());
+        cells.clear();
+        cellIndices.clear();
+        return false;
+    }
+    this->worldFilePath = worldFilePath;
+    return true;
+}
+
+void WorldStreamer::LoadCells(const std::string& worldFilePath, const nlohmann::json& worldJson) {
+    const nlohmann::json& cellSizeJson = JsonHelper::GetJson(worldJson, "cell_size");
+    cellSize = Vector2(JsonHelper::Get<float>(cellSizeJson, "x"), JsonHelper::Get<float>(cellSizeJson, "y"));
+    assert(cellSize.x > 0.0f && cellSize.y > 0.0f && "World cell size has to be positive!");
+    loadRadius = JsonHelper::GetDefault<float>(worldJson, "load_radius", std::max(cellSize.x, cellSize.y));
+    unloadRadius = JsonHelper::GetDefault<float>(worldJson, "unload_radius", loadRadius * 1.5f);
+    if (unloadRadius < loadRadius) {
+        Logger::GetInstance()->Warn("World '%s' unload radius is smaller than its load radius, using the load radius!", worldFilePath.c_str());
+        unloadRadius = loadRadius;
+    }
+    for (const nlohmann::json& cellJson : JsonHelper::GetJson(worldJson, "cells")) {
+        WorldCell cell;
+        cell.x = JsonHelper::Get<int>(cellJson, "x");
+        cell.y = JsonHelper::Get<int>(cellJson, "y");
+        cell.sceneFilePath = JsonHelper::Get<std::string>(cellJson, "scene_source");
+        if (!cellIndices.emplace(GetCellKey(cell.x, cell.y), cells.size()).second) {
+            Logger::GetInstance()->Warn("World '%s' has more than one cell at (%d, %d), skipping '%s'!", worldFilePath.c_str(), cell.x, cell.y, cell.sceneFilePath.c_str());
+            continue;
+        }
+        cells.emplace_back(cell);
+    }
+}
+
+const std::string& WorldStreamer::GetWorldFilePath() const {
+    return worldFilePath;
+}
+
+bool WorldStreamer::Update(Scene* scene, Vector2 focusPosition, float commitBudgetMilliseconds, WorldStreamingChanges& changes) {
+    if (cells.empty() || scene->rootEntity == NULL_ENTITY) {
+        return false;
+    }
+    UnloadFarthestCell(scene, focusPosition, changes);
+    if (isLoadingCell) {
+        UpdateCellLoad(scene, focusPosition, commitBudgetMilliseconds, changes);
+    }
+    if (!isLoadingCell) {
+        StartNearestCellLoad(focusPosition);
+    }
+    return !changes.createdEntities.empty() || !changes.unloadedCellRootEntities.empty();
+}
+
+void WorldStreamer::Reset() {
+    if (loadThread.joinable()) {
+        loadThread.join();
+    }
+    if (isLoadingCell) {
+        FinishCellLoad(WorldCellState::UNLOADED);
+    }
+    for (WorldCell& cell : cells) {
+        if (cell.state != WorldCellState::FAILED) {
+            cell.state = WorldCellState::UNLOADED;
+        }
+        cell.rootEntity = NULL_ENTITY;
+    }
+    residentCells.clear();
+}
+
+size_t WorldStreamer::GetLoadedCellCount() const {
+    return residentCells.size();
+}
+
+uint64_t WorldStreamer::GetCellKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+// Distance to the nearest point of the cell, zero when the focus is inside it
+float WorldStreamer::GetDistanceToCell(const WorldCell& cell, Vector2 focusPosition) const {
+    const Vector2 cellMin = Vector2(static_cast<float>(cell.x), static_cast<float>(cell.y)) * cellSize;
+    const Vector2 nearestPoint = glm::clamp(focusPosition, cellMin, cellMin + cellSize);
+    return glm::length(focusPosition - nearestPoint);
+}
+
+void WorldStreamer::UnloadFarthestCell(Scene* scene, Vector2 focusPosition, WorldStreamingChanges& changes) {
+    size_t farthestResidentIndex = residentCells.size();
+    float farthestDistance = unloadRadius;
+    for (size_t residentIndex = 0; residentIndex < residentCells.size(); residentIndex++) {
+        const WorldCell& cell = cells[residentCells[residentIndex]];
+        const float distance = GetDistanceToCell(cell, focusPosition);
+        if (cell.state == WorldCellState::LOADED && distance > farthestDistance) {
+            farthestResidentIndex = residentIndex;
+            farthestDistance = distance;
+        }
+    }
+    if (farthestResidentIndex == residentCells.size()) {
+        return;
+    }
+    WorldCell& cell = cells[residentCells[farthestResidentIndex]];
+    // Nodes parented under the cell at runtime go with it, the root may already have been destroyed by the game
+    if (scene->hierarchy.HasNode(cell.rootEntity)) {
+        changes.unloadedCellRootEntities.emplace_back(cell.rootEntity);
+    }
+    cell.state = WorldCellState::UNLOADED;
+    cell.rootEntity = NULL_ENTITY;
+    residentCells[farthestResidentIndex] = residentCells.back();
+    residentCells.pop_back();
+}
+
+void WorldStreamer::StartNearestCellLoad(Vector2 focusPosition) {
+    // Only cells overlapping the load radius' bounds can be in range
+    const int minCellX = static_cast<int>(std::floor((focusPosition.x - loadRadius) / cellSize.x));
+    const int maxCellX = static_cast<int>(std::floor((focusPosition.x + loadRadius) / cellSize.x));
+    const int minCellY = static_cast<int>(std::floor((focusPosition.y - loadRadius) / cellSize.y));
+    const int maxCellY = static_cast<int>(std::floor((focusPosition.y + loadRadius) / cellSize.y));
+    size_t nearestCellIndex = cells.size();
+    float nearestDistance = loadRadius;
+    for (int cellY = minCellY; cellY <= maxCellY; cellY++) {
+        for (int cellX = minCellX; cellX <= maxCellX; cellX++) {
+            auto it = cellIndices.find(GetCellKey(cellX, cellY));
+            if (it == cellIndices.end() || cells[it->second].state != WorldCellState::UNLOADED) {
+                continue;
+            }
+            const float distance = GetDistanceToCell(cells[it->second], focusPosition);
+            if (distance <= nearestDistance) {
+                nearestCellIndex = it->second;
+                nearestDistance = distance;
+            }
+        }
+    }
+    if (nearestCellIndex != cells.size()) {
+        StartCellLoad(nearestCellIndex);
+    }
+}
+
+void WorldStreamer::StartCellLoad(size_t cellIndex) {
+    WorldCell& cell = cells[cellIndex];
+    const std::string compiledFilePath = SceneLoader::GetCompiledSceneFilePath(cell.sceneFilePath);
+    if (compiledFilePath.empty() && (!FileHelper::DoesFileExist(cell.sceneFilePath) || BinarySceneFormat::IsCompiledFilePath(cell.sceneFilePath))) {
+        Logger::GetInstance()->Error("World cell scene '%s' not found!", cell.sceneFilePath.c_str());
+        cell.state = WorldCellState::FAILED;
+        return;
+    }
+    if (loadThread.joinable()) {
+        loadThread.join();
+    }
+    cell.state = WorldCellState::LOADING;
+    loadingCellIndex = cellIndex;
+    isLoadingCell = true;
+    hasFinishedLoading = false;
+    loadThread = std::thread(&WorldStreamer::LoadCellScene, this, cell.sceneFilePath, compiledFilePath);
+}
+
+// Runs on the load thread, only touches the staged scene and the parser until 'hasFinishedLoading' is set
+void WorldStreamer::LoadCellScene(const std::string& sceneFilePath, const std::string& compiledFilePath) {
+    if (!compiledFilePath.empty()) {
+        cellSceneFile.reset(new MappedFile(compiledFilePath));
+        if (cellSceneFile->IsValid() && sceneNodeBinaryParser.Open(cellSceneFile->GetData(), cellSceneFile->GetSize())) {
+            isCellSceneValid = true;
+            hasFinishedLoading = true;
+            return;
+        }
+        cellSceneFile.reset();
+    }
+    isCellSceneValid = !BinarySceneFormat::IsCompiledFilePath(sceneFilePath) && CompileCellScene(sceneFilePath);
+    hasFinishedLoading = true;
+}
+
+// Nothing may throw past the load thread, a cell that can't be read or compiled is reported as invalid instead
+bool WorldStreamer::CompileCellScene(const std::string& sceneFilePath) {
+    MappedFile sceneFile(sceneFilePath);
+    if (!sceneFile.IsValid()) {
+        return false;
+    }
+    const nlohmann::json sceneJson = nlohmann::json::parse(sceneFile.GetData(), sceneFile.GetData() + sceneFile.GetSize(), nullptr, false);
+    if (sceneJson.is_discarded()) {
+        return false;
+    }
+    try {
+        JsonMissingKeyThrowScope missingKeyThrowScope;
+        compiledCellScene = BinarySceneCompiler::CompileSceneJson(sceneJson, sceneFilePath);
+    } catch (const std::exception& exception) {
+        Logger::GetInstance()->Error("World cell scene '%s' failed to compile: %s", sceneFilePath.c_str(), exception.what());
+        std::vector<char>().swap(compiledCellScene);
+        return false;
+    }
+    return sceneNodeBinaryParser.Open(compiledCellScene.data(), compiledCellScene.size());
+}
+
+void WorldStreamer::UpdateCellLoad(Scene* scene, Vector2 focusPosition, float commitBudgetMilliseconds, WorldStreamingChanges& changes) {
+    WorldCell& cell = cells[loadingCellIndex];
+    if (cell.state == WorldCellState::LOADING) {
+        if (!hasFinishedLoading) {
+            return;
+        }
+        loadThread.join();
+        if (!isCellSceneValid) {
+            Logger::GetInstance()->Error("World cell scene '%s' is invalid!", cell.sceneFilePath.c_str());
+            FinishCellLoad(WorldCellState::FAILED);
+            return;
+        }
+        cell.state = WorldCellState::COMMITTING;
+    }
+    // Focus moved away while the cell was loading, what was committed is unloaded like any other cell
+    if (GetDistanceToCell(cell, focusPosition) > unloadRadius) {
+        FinishCellLoad(committedNodeCount > 0 ? WorldCellState::LOADED : WorldCellState::UNLOADED);
+        return;
+    }
+    const auto startTime = std::chrono::steady_clock::now();
+    const uint32_t nodeCount = sceneNodeBinaryParser.GetNodeCount();
+    while (committedNodeCount < nodeCount) {
+        const Entity entity = sceneNodeBinaryParser.ParseSceneNode(scene, committedNodeCount, scene->rootEntity);
+        if (committedNodeCount == 0) {
+            cell.rootEntity = entity;
+            residentCells.emplace_back(loadingCellIndex);
+        }
+        // Parents may have been refreshed in an earlier frame, so every committed node is marked
+        scene->worldTransforms.MarkDirty(entity, scene->hierarchy);
+        changes.createdEntities.emplace_back(entity);
+        committedNodeCount++;
+        const std::chrono::duration<float, std::milli> elapsedTime = std::chrono::steady_clock::now() - startTime;
+        if (commitBudgetMilliseconds > 0.0f && elapsedTime.count() >= commitBudgetMilliseconds) {
+            break;
+        }
+    }
+    if (committedNodeCount == nodeCount) {
+        FinishCellLoad(WorldCellState::LOADED);
+    }
+}
+
+void WorldStreamer::FinishCellLoad(WorldCellState cellState) {
+    cells[loadingCellIndex].state = cellState;
+    isLoadingCell = false;
+    isCellSceneValid = false;
+    committedNodeCount = 0;
+    cellSceneFile.reset();
+    std::vector<char>().swap(compiledCellScene);
+}
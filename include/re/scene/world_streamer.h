@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+#include <json/json.hpp>
+
+#include "scene.h"
+#include "scene_node_binary_parser.h"
+#include "../ecs/entity/entity_manager.h"
+#include "../ecs/component/component_manager.h"
+#include "../math/redmath.h"
+#include "../utils/mapped_file.h"
+
+// Entities touched by streaming, systems still have to be told about them
+struct WorldStreamingChanges {
+    std::vector<Entity> createdEntities; // Parents before children
+    std::vector<Entity> unloadedCellRootEntities; // Still alive, destroyed along with their subtrees by the caller
+};
+
+enum class WorldCellState : int {
+    UNLOADED = 0,
+    LOADING = 1, // Compiling or mapping the cell's scene on the load thread
+    COMMITTING = 2, // Creating entities on the calling thread
+    LOADED = 3,
+    FAILED = 4, // Scene file is missing or invalid, not attempted again
+};
+
+// Splits a world into a grid of cells, each its own scene file, and keeps the cells around a focus point in the current
+// scene as children of its root node.  One cell at a time is compiled or mapped on a background thread, nearest first,
+// then committed within a time budget.  Cells are unloaded past a larger radius than they're loaded at so moving along
+// the edge of the load radius doesn't reload the same cell every few frames.
+//
+// World file:
+// { "cell_size": { "x": 1024, "y": 1024 }, "load_radius": 1024, "unload_radius": 1536,
+//   "cells": [ { "x": 0, "y": 0, "scene_source": "scenes/world/cell_0_0.json" } ] }
+//
+// Cell scenes are authored in world coordinates, cell (x, y) covers [x * cell_size.x, (x + 1) * cell_size.x) and the
+// same along y.
+class WorldStreamer {
+  public:
+    WorldStreamer(EntityManager* entityManager, ComponentManager* componentManager);
+    ~WorldStreamer();
+    bool LoadWorldFile(const std::string& worldFilePath);
+    const std::string& GetWorldFilePath() const;
+    // Returns true if cell entities were created or have to be destroyed.  At most one cell is unloaded per call.
+    bool Update(Scene* scene, Vector2 focusPosition, float commitBudgetMilliseconds, WorldStreamingChanges& changes);
+    // Forgets loaded cells without touching their entities, called once the scene holding them is destroyed
+    void Reset();
+    size_t GetLoadedCellCount() const;
+
+  private:
+    struct WorldCell {
+        int x = 0;
+        int y = 0;
+        std::string sceneFilePath;
+        WorldCellState state = WorldCellState::UNLOADED;
+        Entity rootEntity = NULL_ENTITY;
+    };
+
+    EntityManager *entityManager = nullptr;
+    ComponentManager *componentManager = nullptr;
+    SceneNodeBinaryParser sceneNodeBinaryParser;
+    std::string worldFilePath;
+    Vector2 cellSize = Vector2(1024.0f, 1024.0f);
+    float loadRadius = 1024.0f;
+    float unloadRadius = 1536.0f;
+    std::vector<WorldCell> cells;
+    std::unordered_map<uint64_t, size_t> cellIndices; // Cell coordinates to 'cells' index
+    std::vector<size_t> residentCells; // Cells with entities in the scene, including the one committing
+    // Cell being loaded, only one at a time so memory used by staged scenes stays bounded
+    size_t loadingCellIndex = 0;
+    bool isLoadingCell = false;
+    std::thread loadThread;
+    std::atomic<bool> hasFinishedLoading;
+    bool isCellSceneValid = false; // Set by the load thread, read once 'hasFinishedLoading' is set
+    std::unique_ptr<MappedFile> cellSceneFile; // Set when the cell's compiled scene is up to date
+    std::vector<char> compiledCellScene; // Set when the cell's json had to be compiled
+    uint32_t committedNodeCount = 0;
+
+    void LoadCells(const std::string& worldFilePath, const nlohmann::json& worldJson);
+    static uint64_t GetCellKey(int x, int y);
+    float GetDistanceToCell(const WorldCell& cell, Vector2 focusPosition) const;
+    void StartCellLoad(size_t cellIndex);
+    void LoadCellScene(const std::string& sceneFilePath, const std::string& compiledFilePath);
+    bool CompileCellScene(const std::string& sceneFilePath);
+    void UpdateCellLoad(Scene* scene, Vector2 focusPosition, float commitBudgetMilliseconds, WorldStreamingChanges& changes);
+    void UnloadFarthestCell(Scene* scene, Vector2 focusPosition, WorldStreamingChanges& changes);
+    void StartNearestCellLoad(Vector2 focusPosition);
+    void FinishCellLoad(WorldCellState cellState);
+};
@@ -10,6 +10,15 @@ class FileHelper {
         return(stat(name.c_str(), &buffer) == 0);
     }
 
+    // Returns 0 if the file doesn't exist
+    static time_t GetLastModifiedTime(const std::string &name) {
+        struct stat buffer;
+        if (stat(name.c_str(), &buffer) != 0) {
+            return 0;
+        }
+        return buffer.st_mtime;
+    }
+
     static void ChangeDirectory(const std::string &newDirectory) {
         std::experimental::filesystem::current_path(newDirectory);
     }
@@ -0,0 +1,92 @@
+#include "file_watcher.h"
+
+#include <algorithm>
+
+#include "file_helper.h"
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static std::string GetDirectory(const std::string& filePath) {
+    const size_t separatorIndex = filePath.find_last_of('/');
+    return separatorIndex == std::string::npos ? "." : filePath.substr(0, separatorIndex);
+}
+
+FileWatcher::FileWatcher() {
+#if defined(__linux__)
+    inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#if defined(__linux__)
+    if (inotifyDescriptor >= 0) {
+        close(inotifyDescriptor);
+    }
+#endif
+}
+
+bool FileWatcher::WatchFile(const std::string& filePath) {
+    if (!FileHelper::DoesFileExist(filePath)) {
+        return false;
+    }
+    watchedFiles[filePath] = FileHelper::GetLastModifiedTime(filePath);
+#if defined(__linux__)
+    // Directory is watched as saving may replace the file instead of writing to it
+    if (inotifyDescriptor >= 0) {
+        const std::string directory = GetDirectory(filePath);
+        const int watchDescriptor = inotify_add_watch(inotifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watchDescriptor >= 0) {
+            watchedDirectories[watchDescriptor] = directory;
+        }
+    }
+#endif
+    return true;
+}
+
+void FileWatcher::Clear() {
+#if defined(__linux__)
+    for (const auto& pair : watchedDirectories) {
+        inotify_rm_watch(inotifyDescriptor, pair.first);
+    }
+    watchedDirectories.clear();
+#endif
+    watchedFiles.clear();
+}
+
+std::vector<std::string> FileWatcher::GetChangedFiles() {
+    std::vector<std::string> changedFiles;
+#if defined(__linux__)
+    if (inotifyDescriptor >= 0) {
+        alignas(inotify_event) char eventBuffer[4096];
+        ssize_t readSize;
+        while ((readSize = read(inotifyDescriptor, eventBuffer, sizeof(eventBuffer))) > 0) {
+            for (ssize_t eventOffset = 0; eventOffset < readSize;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(eventBuffer + eventOffset);
+                eventOffset += sizeof(inotify_event) + event->len;
+                auto directoryIt = watchedDirectories.find(event->wd);
+                if (directoryIt == watchedDirectories.end() || event->len == 0) {
+                    continue;
+                }
+                const std::string filePath = directoryIt->second == "." && watchedFiles.count(event->name) > 0
+                                             ? std::string(event->name) : directoryIt->second + "/" + event->name;
+                if (watchedFiles.count(filePath) > 0 && std::find(changedFiles.begin(), changedFiles.end(), filePath) == changedFiles.end()) {
+                    changedFiles.emplace_back(filePath);
+                }
+            }
+        }
+        return changedFiles;
+    }
+#endif
+    for (auto& pair : watchedFiles) {
+        const time_t lastModifiedTime = FileHelper::GetLastModifiedTime(pair.first);
+        if (lastModifiedTime != pair.second) {
+            pair.second = lastModifiedTime;
+            changedFiles.emplace_back(pair.first);
+        }
+    }
+    return changedFiles;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <ctime>
+
+// Reports files that were written since the last poll.  Uses inotify on Linux, so editors that save by renaming a
+// temporary file over the original are caught too, and compares modification times elsewhere.
+class FileWatcher {
+  public:
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool WatchFile(const std::string& filePath);
+    void Clear();
+    // Doesn't block, each changed file is listed once no matter how many writes happened
+    std::vector<std::string> GetChangedFiles();
+
+  private:
+    std::unordered_map<std::string, time_t> watchedFiles; // Last modified time, only compared without inotify
+#if defined(__linux__)
+    int inotifyDescriptor = -1;
+    std::unordered_map<int, std::string> watchedDirectories; // By watch descriptor
+#endif
+};
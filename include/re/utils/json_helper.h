@@ -10,7 +10,7 @@ class JsonHelper {
   public:
     template<typename T>
     static T Get(const nlohmann::json& json, const std::string& key) {
-        if (json.contains(key)) {
+        if (json.contains(key) || IsThrowingOnMissingKey()) {
             return json.at(key);
         }
         std::cerr << "Key '" << key << "' doesn't exist!" << std::endl;
@@ -18,6 +18,17 @@ class JsonHelper {
         return T(); // Not reached, just added to have returns for all code paths
     }
 
+    // Nested objects and arrays without copying them, Get<nlohmann::json> copies the whole subtree
+    static const nlohmann::json& GetJson(const nlohmann::json& json, const std::string& key) {
+        static const nlohmann::json emptyJson;
+        if (json.contains(key) || IsThrowingOnMissingKey()) {
+            return json.at(key);
+        }
+        std::cerr << "Key '" << key << "' doesn't exist!" << std::endl;
+        assert(false && "Key doesn't exist in json!");
+        return emptyJson; // Not reached, just added to have returns for all code paths
+    }
+
     template<typename T>
     static T GetDefault(const nlohmann::json& json, const std::string& key, T defaultValue) {
         if (json.contains(key)) {
@@ -25,6 +36,28 @@ class JsonHelper {
         }
         return defaultValue;
     }
+
+    // Set on threads that can't stop on a missing key, they catch the nlohmann::json::out_of_range thrown instead
+    static bool& IsThrowingOnMissingKey() {
+        static thread_local bool isThrowingOnMissingKey = false;
+        return isThrowingOnMissingKey;
+    }
+};
+
+// Missing keys throw instead of asserting on the current thread while this is alive, for loaders that run in the
+// background and have to survive a broken file
+class JsonMissingKeyThrowScope {
+  public:
+    JsonMissingKeyThrowScope() : wasThrowingOnMissingKey(JsonHelper::IsThrowingOnMissingKey()) {
+        JsonHelper::IsThrowingOnMissingKey() = true;
+    }
+
+    ~JsonMissingKeyThrowScope() {
+        JsonHelper::IsThrowingOnMissingKey() = wasThrowingOnMissingKey;
+    }
+
+  private:
+    bool wasThrowingOnMissingKey;
 };
 
 class JsonFileHelper {
@@ -0,0 +1,61 @@
+#include "mapped_file.h"
+
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filePath) {
+#if !defined(_WIN32)
+    const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return;
+    }
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) == 0 && fileStat.st_size > 0) {
+        void* mapping = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (mapping != MAP_FAILED) {
+            data = static_cast<const char*>(mapping);
+            size = static_cast<size_t>(fileStat.st_size);
+            isMapped = true;
+        }
+    }
+    // Mapping stays valid after the descriptor is closed
+    close(fileDescriptor);
+#else
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return;
+    }
+    buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!buffer.empty() && file.read(buffer.data(), buffer.size())) {
+        data = buffer.data();
+        size = buffer.size();
+    }
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+    if (isMapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
+bool MappedFile::IsValid() const {
+    return data != nullptr;
+}
+
+const char* MappedFile::GetData() const {
+    return data;
+}
+
+size_t MappedFile::GetSize() const {
+    return size;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Read only view of a whole file.  Memory mapped where supported, read into memory otherwise.
+class MappedFile {
+  public:
+    explicit MappedFile(const std::string& filePath);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool IsValid() const;
+    const char* GetData() const;
+    size_t GetSize() const;
+
+  private:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool isMapped = false;
+    std::vector<char> buffer; // Used when mapping isn't available
+};
@@ -53,26 +53,28 @@ void Renderer2D::SubmitFontBatchItem(Font *font, const std::string &text, float
 void Renderer2D::FlushBatches() {
     assert(spriteRenderer != nullptr && "SpriteRenderer is NULL, initialize the Renderer2D before using!");
 
-    const RenderFlushFunction &renderFlushFunction = [this] (const int zIndex, const ZIndexDrawBatch &zIndexDrawBatch) {
-        // Draw Sprites
-        for (const SpriteBatchItem &spriteBatchItem : zIndexDrawBatch.spriteDrawBatches) {
-            spriteRenderer->Draw(spriteBatchItem.texture2D,
-                                 spriteBatchItem.sourceRectangle,
-                                 spriteBatchItem.destinationRectangle,
-                                 spriteBatchItem.rotation,
-                                 spriteBatchItem.color,
-                                 spriteBatchItem.flipX,
-                                 spriteBatchItem.flipY);
-        }
-        // Draw Font
-        for (const FontBatchItem &fontBatchItem : zIndexDrawBatch.fontDrawBatches) {
-            fontRenderer->Draw(fontBatchItem.font,
-                               fontBatchItem.text,
-                               fontBatchItem.x,
-                               fontBatchItem.y,
-                               fontBatchItem.scale,
-                               fontBatchItem.color);
-        }
+    // Switching between renderers flushes the other one's batch, both return right away when there's nothing pending
+    const SpriteFlushFunction &spriteFlushFunction = [this] (const SpriteBatchItem &spriteBatchItem) {
+        fontRenderer->Flush();
+        spriteRenderer->Draw(spriteBatchItem.texture2D,
+                             spriteBatchItem.sourceRectangle,
+                             spriteBatchItem.destinationRectangle,
+                             spriteBatchItem.rotation,
+                             spriteBatchItem.color,
+                             spriteBatchItem.flipX,
+                             spriteBatchItem.flipY);
     };
-    rendererBatcher.Flush(renderFlushFunction);
+    const FontFlushFunction &fontFlushFunction = [this] (const FontBatchItem &fontBatchItem) {
+        spriteRenderer->Flush();
+        fontRenderer->Draw(fontBatchItem.font,
+                           fontBatchItem.text,
+                           fontBatchItem.x,
+                           fontBatchItem.y,
+                           fontBatchItem.scale,
+                           fontBatchItem.color);
+    };
+    rendererBatcher.Flush(spriteFlushFunction, fontFlushFunction);
+    spriteRenderer->Flush();
+    fontRenderer->Flush();
+    Font::AdvanceFrame();
 }
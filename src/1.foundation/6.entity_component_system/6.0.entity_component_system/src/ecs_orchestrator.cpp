@@ -52,10 +52,10 @@ bool ECSOrchestrator::HasSceneToDestroy() const {
 
 void ECSOrchestrator::RegisterLoadedSceneNodeComponents() {
     Scene* currentScene = sceneManager->GetCurrentScene();
-    RefreshEntitySignatureChanged(currentScene->rootNode.entity);
-    for (SceneNode childSceneNode : currentScene->rootNode.children) {
-        RefreshEntitySignatureChanged(childSceneNode.entity);
-    }
+    RefreshEntitySignatureChanged(currentScene->rootEntity);
+    currentScene->hierarchy.ForEachChild(currentScene->rootEntity, [this](Entity child) {
+        RefreshEntitySignatureChanged(child);
+    });
 }
 
 void ECSOrchestrator::AddRootNode(Entity rootEntity) {
@@ -57,7 +57,10 @@ bool GameEngine::Initialize() {
     engineContext->SetRunning(true);
 
     // Load initial scene
-    ecsOrchestrator->PrepareSceneChange(projectProperties->GetInitialScenePath());
+    ecsOrchestrator->PrepareSceneChangeAsync(projectProperties->GetInitialScenePath());
+    if (!projectProperties->GetInitialWorldPath().empty()) {
+        ecsOrchestrator->StartWorldStreaming(projectProperties->GetInitialWorldPath());
+    }
 
     // Temp play music
     AudioHelper::PlayMusic("assets/audio/music/test_music.wav");
@@ -234,11 +237,15 @@ void GameEngine::Update() {
 
     fpsCounter->Update();
 
-    if (ecsOrchestrator->HasSceneToCreate()) {
+    if (ecsOrchestrator->HasSceneToCreate() && ecsOrchestrator->UpdateSceneLoading(ECS::SCENE_COMMIT_BUDGET_MILLISECONDS)) {
         ecsOrchestrator->ChangeToScene();
         ecsOrchestrator->RegisterLoadedSceneNodeComponents();
         ecsOrchestrator->OnSceneStartSystems();
     }
+    if (projectProperties->isSceneHotReloadEnabled) {
+        ecsOrchestrator->UpdateSceneHotReload();
+    }
+    ecsOrchestrator->UpdateWorldStreaming(ECS::WORLD_STREAMING_COMMIT_BUDGET_MILLISECONDS);
 
     const float variableDeltaTime = (currentTime - lastFrameTime) / static_cast<float>(Timing::Update::MILLISECONDS_PER_TICK);
     ecsOrchestrator->UpdateSystems(variableDeltaTime);
@@ -266,6 +273,8 @@ void GameEngine::Update() {
 
     ecsOrchestrator->DestroyQueuedEntities();
 
+    ecsOrchestrator->ReorderComponents(ECS::COMPONENT_REORDER_ENTITY_BUDGET);
+
     lastFrameTime = SDL_GetTicks();
 }
 
@@ -0,0 +1,19 @@
+#include <iostream>
+#include <string>
+
+#include "re/scene/binary_scene_compiler.h"
+
+// Compiles json scenes ahead of time, SceneLoader picks up the compiled file when it's newer than the json
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cout << "Usage: scene_compiler <scene.json> [output" << BinarySceneFormat::FILE_EXTENSION << "]" << std::endl;
+        return 1;
+    }
+    const std::string sceneFilePath = argv[1];
+    const std::string outputFilePath = argc == 3 ? argv[2] : BinarySceneFormat::GetCompiledFilePath(sceneFilePath);
+    if (!BinarySceneCompiler::CompileSceneFile(sceneFilePath, outputFilePath)) {
+        return 1;
+    }
+    std::cout << "Compiled '" << sceneFilePath << "' to '" << outputFilePath << "'" << std::endl;
+    return 0;
+}
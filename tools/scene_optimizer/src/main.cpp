@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "scene_optimizer.h"
+#include "re/utils/file_helper.h"
+
+static void PrintStatsRow(const char* label, double originalValue, double optimizedValue, const char* format) {
+    std::printf("  %-28s", label);
+    std::printf(format, originalValue);
+    std::printf(format, optimizedValue);
+    std::printf("\n");
+}
+
+static void PrintReport(const SceneOptimizationReport& report) {
+    const SceneStats& originalStats = report.originalStats;
+    const SceneStats& optimizedStats = report.optimizedStats;
+    std::printf("  %-28s%14s%14s\n", "", "original", "optimized");
+    PrintStatsRow("nodes", static_cast<double>(originalStats.nodeCount), static_cast<double>(optimizedStats.nodeCount), "%14.0f");
+    for (const auto& componentCount : originalStats.componentCounts) {
+        auto it = optimizedStats.componentCounts.find(componentCount.first);
+        const size_t optimizedCount = it != optimizedStats.componentCounts.end() ? it->second : 0;
+        const std::string label = "  " + componentCount.first;
+        PrintStatsRow(label.c_str(), static_cast<double>(componentCount.second), static_cast<double>(optimizedCount), "%14.0f");
+    }
+    PrintStatsRow("max depth", static_cast<double>(originalStats.maxDepth), static_cast<double>(optimizedStats.maxDepth), "%14.0f");
+    PrintStatsRow("average depth", originalStats.averageDepth, optimizedStats.averageDepth, "%14.2f");
+    PrintStatsRow("compiled size (bytes)", static_cast<double>(originalStats.compiledSize), static_cast<double>(optimizedStats.compiledSize), "%14.0f");
+    PrintStatsRow("parse and compile (ms)", originalStats.loadMilliseconds, optimizedStats.loadMilliseconds, "%14.2f");
+    std::printf("  Collapsed %zu nodes, stripped %zu components, reordered %zu nodes\n",
+                report.collapsedNodeCount, report.strippedComponentCount, report.sortedNodeCount);
+}
+
+// Rewrites a json scene with its static hierarchy flattened, the original is left untouched
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cout << "Usage: scene_optimizer <scene.json> [output.json]" << std::endl;
+        return 1;
+    }
+    const std::string sceneFilePath = argv[1];
+    const std::string outputFilePath = argc == 3 ? argv[2] : sceneFilePath.substr(0, sceneFilePath.rfind('.')) + ".optimized.json";
+    if (!FileHelper::DoesFileExist(sceneFilePath)) {
+        std::cerr << "Scene file '" << sceneFilePath << "' not found!" << std::endl;
+        return 1;
+    }
+    std::ifstream sceneFile(sceneFilePath);
+    // Ordered so the written scene keeps the key order it was authored with
+    const nlohmann::ordered_json sceneJson = nlohmann::ordered_json::parse(sceneFile, nullptr, false);
+    if (sceneJson.is_discarded() || !sceneJson.is_object()) {
+        std::cerr << "Scene file '" << sceneFilePath << "' isn't a valid json scene!" << std::endl;
+        return 1;
+    }
+
+    SceneOptimizationReport report;
+    const nlohmann::ordered_json optimizedSceneJson = SceneOptimizer::OptimizeScene(sceneJson, report);
+    report.originalStats = SceneOptimizer::GetSceneStats(sceneJson, sceneFilePath);
+    report.optimizedStats = SceneOptimizer::GetSceneStats(optimizedSceneJson, sceneFilePath);
+
+    std::ofstream outputFile(outputFilePath);
+    if (!outputFile) {
+        std::cerr << "Failed to write '" << outputFilePath << "'!" << std::endl;
+        return 1;
+    }
+    outputFile << optimizedSceneJson.dump(2) << std::endl;
+    std::cout << "Optimized '" << sceneFilePath << "' to '" << outputFilePath << "'" << std::endl;
+    PrintReport(report);
+    return 0;
+}
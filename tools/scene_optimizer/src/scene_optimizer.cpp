@@ -0,0 +1,253 @@
+#include "scene_optimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "re/scene/binary_scene_compiler.h"
+#include "re/scene/scene_node_naming.h"
+
+static const char* STATIC_TAG = "static";
+static const int STATS_LOAD_RUN_COUNT = 3;
+
+// Missing arrays read as empty without copying the node's subtree like 'value' would
+static const nlohmann::ordered_json& GetArray(const nlohmann::ordered_json& nodeJson, const std::string& key) {
+    static const nlohmann::ordered_json emptyArrayJson = nlohmann::ordered_json::array();
+    auto it = nodeJson.find(key);
+    return it != nodeJson.end() ? *it : emptyArrayJson;
+}
+
+static bool HasTag(const nlohmann::ordered_json& nodeJson, const std::string& tag) {
+    const nlohmann::ordered_json& tagsJson = GetArray(nodeJson, "tags");
+    return std::find(tagsJson.begin(), tagsJson.end(), tag) != tagsJson.end();
+}
+
+static bool HasExternalScene(const nlohmann::ordered_json& nodeJson) {
+    return !nodeJson.value("external_scene_source", std::string()).empty();
+}
+
+static void AddNodeStats(const nlohmann::ordered_json& nodeJson, size_t depth, SceneStats& stats, size_t& totalDepth) {
+    stats.nodeCount++;
+    stats.maxDepth = std::max(stats.maxDepth, depth);
+    totalDepth += depth;
+    for (const nlohmann::ordered_json& componentJson : GetArray(nodeJson, "components")) {
+        stats.componentCounts[componentJson.begin().key()]++;
+    }
+    for (const nlohmann::ordered_json& childJson : GetArray(nodeJson, "children")) {
+        AddNodeStats(childJson, depth + 1, stats, totalDepth);
+    }
+}
+
+nlohmann::ordered_json SceneOptimizer::OptimizeScene(const nlohmann::ordered_json& sceneJson, SceneOptimizationReport& report) {
+    SceneOptimizer optimizer;
+    optimizer.report = &report;
+    nlohmann::ordered_json optimizedSceneJson = sceneJson;
+    optimizer.OptimizeNode(optimizedSceneJson, false);
+    // Sorted once collapsing is done, lifted nodes would otherwise be sorted again at every level
+    optimizer.SortLeafRuns(optimizedSceneJson, false);
+    ResolveNames(optimizedSceneJson);
+    return optimizedSceneJson;
+}
+
+SceneStats SceneOptimizer::GetSceneStats(const nlohmann::ordered_json& sceneJson, const std::string& sceneFilePath) {
+    SceneStats stats;
+    size_t totalDepth = 0;
+    AddNodeStats(sceneJson, 0, stats, totalDepth);
+    stats.averageDepth = static_cast<double>(totalDepth) / static_cast<double>(stats.nodeCount);
+    // Timed from text so parsing the extra or missing nodes counts too
+    const std::string sceneText = sceneJson.dump();
+    stats.loadMilliseconds = std::numeric_limits<double>::max();
+    for (int run = 0; run < STATS_LOAD_RUN_COUNT; run++) {
+        const auto startTime = std::chrono::steady_clock::now();
+        const std::vector<char> compiledScene = BinarySceneCompiler::CompileSceneJson(nlohmann::json::parse(sceneText), sceneFilePath);
+        const std::chrono::duration<double, std::milli> elapsedTime = std::chrono::steady_clock::now() - startTime;
+        stats.loadMilliseconds = std::min(stats.loadMilliseconds, elapsedTime.count());
+        stats.compiledSize = compiledScene.size();
+    }
+    return stats;
+}
+
+// Children are optimized first so a collapsed node's children are already final when they're lifted into its place
+void SceneOptimizer::OptimizeNode(nlohmann::ordered_json& nodeJson, bool isParentStatic) {
+    const bool isStatic = IsStatic(nodeJson, isParentStatic);
+    StripComponents(nodeJson, isStatic);
+    auto childrenIt = nodeJson.find("children");
+    if (childrenIt == nodeJson.end()) {
+        return;
+    }
+    nlohmann::ordered_json optimizedChildrenJson = nlohmann::ordered_json::array();
+    for (nlohmann::ordered_json& childJson : *childrenIt) {
+        OptimizeNode(childJson, isStatic);
+        const bool isChildStatic = IsStatic(childJson, isStatic);
+        if (!IsCollapsible(childJson, isChildStatic)) {
+            optimizedChildrenJson.emplace_back(std::move(childJson));
+            continue;
+        }
+        const nlohmann::ordered_json* transformJson = GetTransform(childJson);
+        for (nlohmann::ordered_json& grandchildJson : childJson["children"]) {
+            if (transformJson != nullptr) {
+                BakeTransform(grandchildJson, *transformJson);
+            }
+            // Lifted nodes keep the marker they inherited, the new parent may not be static
+            if (!HasTag(grandchildJson, STATIC_TAG)) {
+                grandchildJson["tags"].emplace_back(STATIC_TAG);
+            }
+            optimizedChildrenJson.emplace_back(std::move(grandchildJson));
+        }
+        report->collapsedNodeCount++;
+    }
+    *childrenIt = std::move(optimizedChildrenJson);
+}
+
+void SceneOptimizer::StripComponents(nlohmann::ordered_json& nodeJson, bool isStatic) {
+    static const std::vector<std::string> knownComponentTypes = { "transform2D", "sprite", "text_label", "animated_sprite", "collider" };
+    auto componentsIt = nodeJson.find("components");
+    if (componentsIt == nodeJson.end()) {
+        return;
+    }
+    // A disabled component still hides the external scene's component of the same type
+    const bool canStripDisabled = isStatic && !HasExternalScene(nodeJson);
+    nlohmann::ordered_json keptComponentsJson = nlohmann::ordered_json::array();
+    for (nlohmann::ordered_json& componentJson : *componentsIt) {
+        const std::string& componentType = componentJson.begin().key();
+        const nlohmann::ordered_json& componentValueJson = componentJson.begin().value();
+        bool isStripped = std::find(knownComponentTypes.begin(), knownComponentTypes.end(), componentType) == knownComponentTypes.end();
+        if (!isStripped && canStripDisabled && componentType != "transform2D") {
+            isStripped = !componentValueJson.value("enabled", true)
+                         || (componentType == "sprite" && componentValueJson.value("texture_path", std::string()).empty())
+                         || (componentType == "text_label" && componentValueJson.value("font_uid", std::string()).empty());
+        }
+        if (isStripped) {
+            report->strippedComponentCount++;
+            continue;
+        }
+        keptComponentsJson.emplace_back(std::move(componentJson));
+    }
+    *componentsIt = std::move(keptComponentsJson);
+}
+
+// Only a transform and the static marker, so nothing at runtime can tell the node is gone
+bool SceneOptimizer::IsCollapsible(const nlohmann::ordered_json& nodeJson, bool isStatic) const {
+    if (!isStatic || HasExternalScene(nodeJson)) {
+        return false;
+    }
+    for (const nlohmann::ordered_json& tag : GetArray(nodeJson, "tags")) {
+        if (tag.get_ref<const std::string&>() != STATIC_TAG) {
+            return false;
+        }
+    }
+    const nlohmann::ordered_json& componentsJson = GetArray(nodeJson, "components");
+    if (componentsJson.size() > 1 || (componentsJson.size() == 1 && componentsJson[0].begin().key() != "transform2D")) {
+        return false;
+    }
+    // Nodes without a transform are skipped when world transforms are combined, there's nothing to bake the
+    // transform into
+    const nlohmann::ordered_json* transformJson = GetTransform(nodeJson);
+    if (transformJson != nullptr && !IsIdentityTransform(*transformJson)) {
+        for (const nlohmann::ordered_json& childJson : GetArray(nodeJson, "children")) {
+            if (GetTransform(childJson) == nullptr) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Siblings at different z indices are drawn by layer regardless of their order, siblings sharing one keep theirs.  Nodes
+// with children are left in place so whole subtrees don't move around.
+void SceneOptimizer::SortLeafRuns(nlohmann::ordered_json& nodeJson, bool isParentStatic) {
+    const bool isStatic = IsStatic(nodeJson, isParentStatic);
+    auto childrenIt = nodeJson.find("children");
+    if (childrenIt == nodeJson.end()) {
+        return;
+    }
+    nlohmann::ordered_json& childrenJson = *childrenIt;
+    size_t runBegin = 0;
+    while (runBegin < childrenJson.size()) {
+        size_t runEnd = runBegin;
+        while (runEnd < childrenJson.size() && IsStatic(childrenJson[runEnd], isStatic) && IsLeaf(childrenJson[runEnd])) {
+            runEnd++;
+        }
+        if (runEnd == runBegin) {
+            SortLeafRuns(childrenJson[runBegin], isStatic);
+            runBegin++;
+            continue;
+        }
+        std::vector<size_t> order;
+        for (size_t childIndex = runBegin; childIndex < runEnd; childIndex++) {
+            order.emplace_back(childIndex);
+        }
+        std::stable_sort(order.begin(), order.end(), [&childrenJson](size_t a, size_t b) {
+            return GetZIndex(childrenJson[a]) < GetZIndex(childrenJson[b]);
+        });
+        std::vector<nlohmann::ordered_json> runJson;
+        for (size_t childIndex : order) {
+            if (childIndex != runBegin + runJson.size()) {
+                report->sortedNodeCount++;
+            }
+            runJson.emplace_back(std::move(childrenJson[childIndex]));
+        }
+        for (size_t i = 0; i < runJson.size(); i++) {
+            childrenJson[runBegin + i] = std::move(runJson[i]);
+        }
+        runBegin = runEnd;
+    }
+}
+
+bool SceneOptimizer::IsStatic(const nlohmann::ordered_json& nodeJson, bool isParentStatic) {
+    return isParentStatic || HasTag(nodeJson, STATIC_TAG);
+}
+
+bool SceneOptimizer::IsLeaf(const nlohmann::ordered_json& nodeJson) {
+    return GetArray(nodeJson, "children").empty() && !HasExternalScene(nodeJson);
+}
+
+const nlohmann::ordered_json* SceneOptimizer::GetTransform(const nlohmann::ordered_json& nodeJson) {
+    auto componentsIt = nodeJson.find("components");
+    if (componentsIt == nodeJson.end()) {
+        return nullptr;
+    }
+    for (const nlohmann::ordered_json& componentJson : *componentsIt) {
+        if (componentJson.begin().key() == "transform2D") {
+            return &componentJson.begin().value();
+        }
+    }
+    return nullptr;
+}
+
+bool SceneOptimizer::IsIdentityTransform(const nlohmann::ordered_json& transformJson) {
+    return transformJson.at("position").at("x").get<float>() == 0.0f && transformJson.at("position").at("y").get<float>() == 0.0f
+           && transformJson.at("scale").at("x").get<float>() == 1.0f && transformJson.at("scale").at("y").get<float>() == 1.0f
+           && transformJson.at("rotation").get<float>() == 0.0f && transformJson.at("z_index").get<int>() == 0;
+}
+
+// Same as SceneTransformCache::CombineTransforms, every field is combined on its own
+void SceneOptimizer::BakeTransform(nlohmann::ordered_json& nodeJson, const nlohmann::ordered_json& parentTransformJson) {
+    // The node isn't const, GetTransform only finds the component
+    nlohmann::ordered_json& transformJson = const_cast<nlohmann::ordered_json&>(*GetTransform(nodeJson));
+    transformJson["position"]["x"] = transformJson["position"]["x"].get<float>() + parentTransformJson.at("position").at("x").get<float>();
+    transformJson["position"]["y"] = transformJson["position"]["y"].get<float>() + parentTransformJson.at("position").at("y").get<float>();
+    transformJson["scale"]["x"] = transformJson["scale"]["x"].get<float>() * parentTransformJson.at("scale").at("x").get<float>();
+    transformJson["scale"]["y"] = transformJson["scale"]["y"].get<float>() * parentTransformJson.at("scale").at("y").get<float>();
+    transformJson["rotation"] = transformJson["rotation"].get<float>() + parentTransformJson.at("rotation").get<float>();
+    transformJson["z_index"] = transformJson["z_index"].get<int>() + parentTransformJson.at("z_index").get<int>();
+}
+
+int SceneOptimizer::GetZIndex(const nlohmann::ordered_json& nodeJson) {
+    const nlohmann::ordered_json* transformJson = GetTransform(nodeJson);
+    return transformJson != nullptr ? transformJson->at("z_index").get<int>() : 0;
+}
+
+// Collapsing can bring children of different parents together, names are made unique the way the loaders would so the
+// written scene shows the names nodes actually get
+void SceneOptimizer::ResolveNames(nlohmann::ordered_json& nodeJson) {
+    auto childrenIt = nodeJson.find("children");
+    if (childrenIt == nodeJson.end()) {
+        return;
+    }
+    SceneNodeNaming childNaming;
+    for (nlohmann::ordered_json& childJson : *childrenIt) {
+        childJson["name"] = childNaming.AddName(childJson["name"].get<std::string>());
+        ResolveNames(childJson);
+    }
+}
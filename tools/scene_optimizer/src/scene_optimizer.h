@@ -0,0 +1,50 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <json/json.hpp>
+
+struct SceneStats {
+    size_t nodeCount = 0;
+    std::map<std::string, size_t> componentCounts;
+    size_t maxDepth = 0;
+    double averageDepth = 0.0; // Parents walked for an uncached world transform
+    size_t compiledSize = 0;
+    double loadMilliseconds = 0.0; // Parsing the json and compiling it, best of a few runs
+};
+
+struct SceneOptimizationReport {
+    SceneStats originalStats;
+    SceneStats optimizedStats;
+    size_t collapsedNodeCount = 0;
+    size_t strippedComponentCount = 0;
+    size_t sortedNodeCount = 0;
+};
+
+// Rewrites a json scene so it loads and updates faster.  Only nodes tagged 'static' and their descendants are changed,
+// they're expected to never be moved, renamed or looked up by path at runtime:
+// - Organizational nodes, which only have a transform, are removed and their transform is baked into their children
+// - Disabled components and components that can never be enabled are removed
+// - Runs of leaf siblings are ordered by z index so each layer's nodes are created next to each other
+// Components the engine doesn't know are removed from every node.  World transforms and draw order stay the same.
+class SceneOptimizer {
+  public:
+    static nlohmann::ordered_json OptimizeScene(const nlohmann::ordered_json& sceneJson, SceneOptimizationReport& report);
+    static SceneStats GetSceneStats(const nlohmann::ordered_json& sceneJson, const std::string& sceneFilePath);
+
+  private:
+    SceneOptimizationReport* report = nullptr;
+
+    void OptimizeNode(nlohmann::ordered_json& nodeJson, bool isParentStatic);
+    void StripComponents(nlohmann::ordered_json& nodeJson, bool isStatic);
+    bool IsCollapsible(const nlohmann::ordered_json& nodeJson, bool isStatic) const;
+    void SortLeafRuns(nlohmann::ordered_json& nodeJson, bool isParentStatic);
+    static bool IsStatic(const nlohmann::ordered_json& nodeJson, bool isParentStatic);
+    static bool IsLeaf(const nlohmann::ordered_json& nodeJson);
+    static const nlohmann::ordered_json* GetTransform(const nlohmann::ordered_json& nodeJson);
+    static bool IsIdentityTransform(const nlohmann::ordered_json& transformJson);
+    static void BakeTransform(nlohmann::ordered_json& nodeJson, const nlohmann::ordered_json& parentTransformJson);
+    static int GetZIndex(const nlohmann::ordered_json& nodeJson);
+    static void ResolveNames(nlohmann::ordered_json& nodeJson);
+};